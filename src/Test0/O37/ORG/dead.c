@@ -0,0 +1,44 @@
+/********************************************************************
+ *
+ *	SOURCE:   ./Test0/O37/dead.ic
+ *	OUTPUT:   ./Test0/O37/dead.c
+ *
+ *******************************************************************/
+
+static const char	iC_compiler[] =
+"@(#)     $Id: icc.v 3.8 $ -O37";
+
+#include	<icg.h>
+
+static iC_Gt *	iC_l_[];
+
+/********************************************************************
+ *
+ *	Gate list
+ *
+ *******************************************************************/
+
+iC_Gt IX0_0    = { 1, -iC_INPX, iC_GATE, 0, "IX0.0", {0}, {0}, 0 };
+iC_Gt IX0_1    = { 1, -iC_INPX, iC_GATE, 0, "IX0.1", {0}, {0}, &IX0_0 };
+iC_Gt IX0_2    = { 1, -iC_INPX, iC_GATE, 0, "IX0.2", {0}, {0}, &IX0_1 };
+iC_Gt IX0_3    = { 1, -iC_INPX, iC_GATE, 0, "IX0.3", {0}, {0}, &IX0_2 };
+iC_Gt IX0_4    = { 1, -iC_INPX, iC_GATE, 0, "IX0.4", {0}, {0}, &IX0_3 };
+iC_Gt IX0_5    = { 1, -iC_INPX, iC_GATE, 0, "IX0.5", {0}, {0}, &IX0_4 };
+iC_Gt QX0_0    = { 1, -iC_OR, iC_GATE, 0, "QX0.0", {0}, {&iC_l_[0]}, &IX0_5 };
+iC_Gt QX0_0_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.0_0", {0}, {&iC_l_[4]}, &QX0_0 };
+iC_Gt l1       = { 1, -iC_AND, iC_GATE, 0, "l1", {0}, {&iC_l_[7]}, &QX0_0_0 };
+
+iC_Gt *		iC___Test0_O37_dead_list = &l1;
+iC_Gt **	iC_list[] = { &iC___Test0_O37_dead_list, 0, };
+
+/********************************************************************
+ *
+ *	Connection lists
+ *
+ *******************************************************************/
+
+static iC_Gt *	iC_l_[] = {
+/* QX0.0 */	&l1, &IX0_5, 0, 0,
+/* QX0.0_0 */	&QX0_0, 0, 0,
+/* l1 */	&IX0_1, &IX0_0, 0, 0,
+};
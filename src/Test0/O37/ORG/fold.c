@@ -0,0 +1,59 @@
+/********************************************************************
+ *
+ *	SOURCE:   ./Test0/O37/fold.ic
+ *	OUTPUT:   ./Test0/O37/fold.c
+ *
+ *******************************************************************/
+
+static const char	iC_compiler[] =
+"@(#)     $Id: icc.v 3.8 $ -O37";
+
+#include	<icg.h>
+
+static iC_Gt *	iC_l_[];
+
+/********************************************************************
+ *
+ *	Gate list
+ *
+ *******************************************************************/
+
+iC_Gt IX0_0    = { 1, -iC_INPX, iC_GATE, 0, "IX0.0", {0}, {0}, 0 };
+iC_Gt IX0_1    = { 1, -iC_INPX, iC_GATE, 0, "IX0.1", {0}, {0}, &IX0_0 };
+iC_Gt IX0_2    = { 1, -iC_INPX, iC_GATE, 0, "IX0.2", {0}, {0}, &IX0_1 };
+iC_Gt IX0_3    = { 1, -iC_INPX, iC_GATE, 0, "IX0.3", {0}, {0}, &IX0_2 };
+iC_Gt IX0_4    = { 1, -iC_INPX, iC_GATE, 0, "IX0.4", {0}, {0}, &IX0_3 };
+iC_Gt IX0_5    = { 1, -iC_INPX, iC_GATE, 0, "IX0.5", {0}, {0}, &IX0_4 };
+iC_Gt LO       = { 1, -iC_OR, iC_GATE, 0, "LO", {0}, {&iC_l_[0]}, &IX0_5 };
+iC_Gt QX0_0    = { 1, -iC_OR, iC_GATE, 0, "QX0.0", {0}, {&iC_l_[2]}, &LO };
+iC_Gt QX0_0_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.0_0", {0}, {&iC_l_[5]}, &QX0_0 };
+iC_Gt QX0_1    = { 1, -iC_OR, iC_GATE, 0, "QX0.1", {0}, {&iC_l_[8]}, &QX0_0_0 };
+iC_Gt QX0_1_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.1_0", {0}, {&iC_l_[11]}, &QX0_1 };
+iC_Gt QX0_2_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.2_0", {0}, {&iC_l_[14]}, &QX0_1_0 };
+iC_Gt QX0_3    = { 1, -iC_AND, iC_GATE, 0, "QX0.3", {0}, {&iC_l_[17]}, &QX0_2_0 };
+iC_Gt QX0_3_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.3_0", {0}, {&iC_l_[20]}, &QX0_3 };
+iC_Gt QX0_2    = { 1, -iC_ALIAS, iC_GATE, 0, "QX0.2", {0}, {(iC_Gt**)&LO}, &QX0_3_0, 0 };
+iC_Gt c0       = { 1, -iC_ALIAS, iC_GATE, 0, "c0", {0}, {(iC_Gt**)&LO}, &QX0_2, 0 };
+iC_Gt c1       = { 1, -iC_ALIAS, iC_GATE, 0, "c1", {0}, {(iC_Gt**)&LO}, &c0, 1 };
+iC_Gt f0       = { 1, -iC_ALIAS, iC_GATE, 0, "f0", {0}, {(iC_Gt**)&LO}, &c1, 0 };
+iC_Gt f1       = { 1, -iC_ALIAS, iC_GATE, 0, "f1", {0}, {(iC_Gt**)&LO}, &f0, 0 };
+
+iC_Gt *		iC___Test0_O37_fold_list = &f1;
+iC_Gt **	iC_list[] = { &iC___Test0_O37_fold_list, 0, };
+
+/********************************************************************
+ *
+ *	Connection lists
+ *
+ *******************************************************************/
+
+static iC_Gt *	iC_l_[] = {
+/* LO */	0, 0,
+/* QX0.0 */	&IX0_2, 0, 0,
+/* QX0.0_0 */	&QX0_0, 0, 0,
+/* QX0.1 */	&IX0_3, 0, 0,
+/* QX0.1_0 */	&QX0_1, 0, 0,
+/* QX0.2_0 */	&LO, 0, 0,
+/* QX0.3 */	&IX0_5, 0, 0,
+/* QX0.3_0 */	&QX0_3, 0, 0,
+};
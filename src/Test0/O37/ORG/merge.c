@@ -0,0 +1,54 @@
+/********************************************************************
+ *
+ *	SOURCE:   ./Test0/O37/merge.ic
+ *	OUTPUT:   ./Test0/O37/merge.c
+ *
+ *******************************************************************/
+
+static const char	iC_compiler[] =
+"@(#)     $Id: icc.v 3.8 $ -O37";
+
+#include	<icg.h>
+
+static iC_Gt *	iC_l_[];
+
+/********************************************************************
+ *
+ *	Gate list
+ *
+ *******************************************************************/
+
+iC_Gt IX0_0    = { 1, -iC_INPX, iC_GATE, 0, "IX0.0", {0}, {0}, 0 };
+iC_Gt IX0_1    = { 1, -iC_INPX, iC_GATE, 0, "IX0.1", {0}, {0}, &IX0_0 };
+iC_Gt IX0_2    = { 1, -iC_INPX, iC_GATE, 0, "IX0.2", {0}, {0}, &IX0_1 };
+iC_Gt IX0_3    = { 1, -iC_INPX, iC_GATE, 0, "IX0.3", {0}, {0}, &IX0_2 };
+iC_Gt IX0_4    = { 1, -iC_INPX, iC_GATE, 0, "IX0.4", {0}, {0}, &IX0_3 };
+iC_Gt QX0_0    = { 1, -iC_OR, iC_GATE, 0, "QX0.0", {0}, {&iC_l_[0]}, &IX0_4 };
+iC_Gt QX0_0_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.0_0", {0}, {&iC_l_[4]}, &QX0_0 };
+iC_Gt QX0_1_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.1_0", {0}, {&iC_l_[7]}, &QX0_0_0 };
+iC_Gt QX0_2    = { 1, -iC_AND, iC_GATE, 0, "QX0.2", {0}, {&iC_l_[10]}, &QX0_1_0 };
+iC_Gt QX0_2_0  = { 1, -iC_OR, iC_OUTX, 0, "QX0.2_0", {0}, {&iC_l_[15]}, &QX0_2 };
+iC_Gt t1       = { 1, -iC_AND, iC_GATE, 0, "t1", {0}, {&iC_l_[18]}, &QX0_2_0 };
+iC_Gt t3       = { 1, -iC_OR, iC_GATE, 0, "t3", {0}, {&iC_l_[22]}, &t1 };
+iC_Gt QX0_1    = { 1, -iC_ALIAS, iC_GATE, 0, "QX0.1", {0}, {(iC_Gt**)&QX0_0}, &t3, 0 };
+iC_Gt t2       = { 1, -iC_ALIAS, iC_GATE, 0, "t2", {0}, {(iC_Gt**)&t1}, &QX0_1, 0 };
+iC_Gt t4       = { 1, -iC_ALIAS, iC_GATE, 0, "t4", {0}, {(iC_Gt**)&t3}, &t2, 0 };
+
+iC_Gt *		iC___Test0_O37_merge_list = &t4;
+iC_Gt **	iC_list[] = { &iC___Test0_O37_merge_list, 0, };
+
+/********************************************************************
+ *
+ *	Connection lists
+ *
+ *******************************************************************/
+
+static iC_Gt *	iC_l_[] = {
+/* QX0.0 */	&t3, &t1, 0, 0,
+/* QX0.0_0 */	&QX0_0, 0, 0,
+/* QX0.1_0 */	&QX0_0, 0, 0,
+/* QX0.2 */	&t3, &t1, &IX0_4, 0, 0,
+/* QX0.2_0 */	&QX0_2, 0, 0,
+/* t1 */	&IX0_1, &IX0_0, 0, 0,
+/* t3 */	&IX0_2, 0, &IX0_3, 0,
+};
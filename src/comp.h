@@ -187,6 +187,12 @@ extern int	iC_maxErrCount;
 extern int	iC_iErrCount;
 extern char *	iCstmtp;		/* manipulated in iClex() (reset in clrBuf()) */
 extern jmp_buf	beginMain;
+					/*   prep.c  */
+#ifndef	_WIN32
+extern int	iC_prepTest(char * path);	/* test for %define %include %if etc */
+extern int	iC_prep(char * path, char * defines,
+		    char ** bufp, size_t * lenp);	/* pre-compile in memory */
+#endif	/* _WIN32 */
 					/*   genr.c  */
 extern int	c_number;		/* case number for cexe.c */
 extern int	outFlag;		/* global flag for compiled output */
@@ -333,6 +339,7 @@ extern char *	iC_genName;
 extern int	iC_genLineNums[];
 extern int	iC_genCount;		/* actual number of pre-comp C functions */
 extern unsigned short	iC_gflag;	/* -g independent C code for gdb debugging */
+extern unsigned short	iC_Gflag;	/* -G Gates in one static table in fan-out order */
 
 					/*   symb.c   */
 #define	HASHSIZ 54*16			/* for new sorted list algorithm */
@@ -343,6 +350,12 @@ extern Symbol *	install( char *, unsigned char,
 extern Symbol *	link_sym(Symbol *);	/* link Symbol into symbol table */
 extern Symbol * unlink_sym(Symbol *);	/* unlink Symbol from symbol table */
 extern void	uninstall(Symbol *);	/* uninstall Symbol from symbol table (free space) */
+extern void	sort_symlist(void);	/* sort symlist[] before listing */
+extern Symbol *	new_sym(void);		/* allocate zeroed Symbol */
+extern void	free_sym(Symbol *);	/* recycle Symbol - name is kept */
+extern List_e *	new_le(void);		/* allocate zeroed List_e */
+extern void	free_le(List_e *);	/* recycle List_e */
+extern char *	new_name(const char *);	/* copy of name which is never freed */
 
 					/*   main.c   */
 #define H1name	".iC_list1.h"
@@ -52,7 +52,7 @@ static int	cFn = 0;
 static char *	TaliasList[][2] = {
 	    { "EOI",	"TX0.0"  },	// end of initialisation
 	    { "STDIN",	"TX0.1"  },	// stdin line received
-//	    { "T1ms",	"TX0.2"  },	// 1 ms internal timer (TODO implement)
+	    { "T1ms",	"TX0.2"  },	// 1 ms internal timer
 	    { "T10ms",	"TX0.3"  },	// 10 ms internal timer
 	    { "T100ms",	"TX0.4"  },	// 100 ms internal timer
 	    { "T1sec",	"TX0.5"  },	// 1 second internal timer
@@ -4306,6 +4306,8 @@ iC_compile(
     int		fd;
     int		r  = 1;
     int		r1 = 1;
+    char *	prepBuf = NULL;			/* in-process pre-compiled input */
+    size_t	prepLen = 0;
 
     lineno = 0;
 #if YYDEBUG
@@ -4347,12 +4349,9 @@ iC_compile(
 	    if ((iC_debug & 0402) == 0402) fprintf(iC_outFP, "####### test: perl -e %s %s; $? = %d\n", execBuf, inpPath, r);
 #endif
 #else	/* ! _WIN32 Linux */
-	    snprintf(execBuf, BUFS, "%s %s",
-		"perl -e '$s=1; while (<>) { if (m/^\\s*%\\s*(define|undef|include|ifdef|ifndef|if|elif|else|endif|error)\\b/) { $s=0; last; } } exit $s;'",
-		inpPath);
-	    r = system(execBuf);		/* test with perl script if %define %include %if etc in input */
+	    r = iC_prepTest(inpPath);		/* test if %define %include %if etc in input */
 #if YYDEBUG
-	    if ((iC_debug & 0402) == 0402) fprintf(iC_outFP, "####### test: %s; $? = %d\n", execBuf, r);
+	    if ((iC_debug & 0402) == 0402) fprintf(iC_outFP, "####### test: iC_prepTest(%s); $? = %d\n", inpPath, r);
 #endif
 #endif	/* _WIN32 */
 	}
@@ -4361,6 +4360,20 @@ iC_compile(
 	    if ((iC_debug & 0402) == 0402) fprintf(iC_outFP, "####### iC_defines = %s; $? = %d\n", iC_defines, r);
 	}
 #endif
+#ifndef	_WIN32
+	if (r == 0 && *iC_aflag == '\0' && !(iC_debug & 04000) &&
+	    iC_prep(inpPath, iC_defines, &prepBuf, &prepLen) == 0) {
+	    /* simple %define %include %ifdef etc resolved in memory - no immac, no T0FN */
+#if YYDEBUG
+	    if ((iC_debug & 0402) == 0402) fprintf(iC_outFP, "####### pre-compile: iC_prep(%s)%s; %lu bytes\n", inpPath, iC_defines, (unsigned long)prepLen);
+#endif
+	    if ((T0FP = fmemopen(prepBuf, prepLen, "r")) == NULL) {
+		free(prepBuf);
+		return T0index;			/* error opening intermediate buffer */
+	    }
+	    r = 2;				/* no T0FN to unlink */
+	} else
+#endif	/* _WIN32 */
 	if (r == 0) {
 	    /* iC_defines is not empty and has -Dyyy or -Uyyy or %include etc was found by perl script */
 	    /* pass the input file through the 'immac -M' to resolve %includes and macros */
@@ -4411,6 +4424,7 @@ iC_compile(
     }
     if (inpPath) fclose(T0FP);
     T0FP = 0;
+    free(prepBuf);				/* in-process pre-compiled input or NULL */
     return errRet;
 } /* iC_compile */
 
@@ -5199,7 +5213,7 @@ yylex(void)
 		 *	static char *	TaliasList[][2] = {
 		 *	    { "EOI",	"TX0.0"  },	// end of initialisation
 		 *	    { "STDIN",	"TX0.1"  },	// stdin line received
-		 *  //	    { "T1ms",	"TX0.2"  },	// 1 ms internal timer (TODO implement)
+		 *	    { "T1ms",	"TX0.2"  },	// 1 ms internal timer
 		 *	    { "T10ms",	"TX0.3"  },	// 10 ms internal timer
 		 *	    { "T100ms",	"TX0.4"  },	// 100 ms internal timer
 		 *	    { "T1sec",	"TX0.5"  },	// 1 second internal timer
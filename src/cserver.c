@@ -0,0 +1,2947 @@
+static const char RCS_Id[] =
+"@(#)$Id: cserver.c 1.1 $";
+/********************************************************************
+ *
+ *	Copyright (C) 2021  John E. Wulff
+ *
+ *  You may distribute under the terms of either the GNU General Public
+ *  License or the Artistic License, as specified in the README file.
+ *
+ *  For more information about this program, or for information on how
+ *  to contact the author, see the README file
+ *
+ *	cserver.c; the TCP/IP server for iC clients - both apps and I/O's
+ *
+ *  C version of the Perl iCserver and goserver.go with identical
+ *  registration, equivalence and autovivify semantics. It is a drop in
+ *  replacement for either of them.
+ *
+ *  Messages consist of a 4 byte header containing the BigEndian length
+ *  of the data followed by the data, as implemented in tcpc.c for
+ *  iC clients.
+ *
+ *  All connections are handled in one thread with Linux epoll(7).
+ *  Each connection has its own receive buffer, in which messages are
+ *  reassembled. One recv() reads as many messages as are available.
+ *  Channel:value pairs for each receiver are collected in an output
+ *  buffer for that receiver while one message is processed. At the end
+ *  of the message each receiver gets all its data with one writev().
+ *  The arrays indexed by channel are doubled when they fill up, so
+ *  no allocation is needed for routing data.
+ *
+ *  Clients on the same host may offer shared memory rings with the
+ *  registration item M<name> (see shmc.h). After the last registration
+ *  has been acknowledged with ",M", all messages to and from that
+ *  client use the rings instead of the TCP/IP socket, which is only
+ *  kept to notice when the client disconnects. Routing and equivalences
+ *  are not affected.
+ *
+ *******************************************************************/
+
+#define _GNU_SOURCE			/* strverscmp() */
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<ctype.h>
+#include	<errno.h>
+#include	<limits.h>
+#include	<stdarg.h>
+#include	<assert.h>
+#include	<signal.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<fcntl.h>
+#include	<netdb.h>
+#include	<poll.h>
+#include	<sys/epoll.h>
+#include	<sys/uio.h>
+#include	<sys/time.h>
+#include	<sys/mman.h>
+#include	<sys/stat.h>
+#include	<sys/un.h>
+#include	<netinet/tcp.h>
+#include	"tcpc.h"
+#include	"shmc.h"
+
+static const char *	usage =
+"Usage:\n"
+"  %s[ -qadrkztmh][ -s <host>|unix:<path>][ -p <port>]\n"
+"          [ -e <equivalences>][ -A <cmd>][ -f <file>]\n"
+"          [ -R <aux_app>[ <aux_argument> -R ...]] # must be last arguments\n"
+"    -s host address of server - clients must specify the same address\n"
+"            unless (default '0.0.0.0' which accepts any client host)\n"
+"            or unix:<path> to listen on a Unix domain socket (no port)\n"
+"    -p port service port of server for all clients  (default '%s')\n"
+"    -e equivalences  eg: -e IX0=IX0-1     (can be used more than once)\n"
+"            or a comma separated list eg: -e IX0=IX0-1,QX0=QX0-1,IB1=IB1-1\n"
+"    -q      quiet - do not report clients connecting and disconnecting\n"
+"    -a      autovivify I/O clients 'iCbox' for missing I/O's\n"
+"    -d      autovivify I/O client 'iCbox -d' for missing I/O's\n"
+"    -A cmd  use <cmd> to autovivify I/O clients (eg -A 'iCbox -Q2 -C19')\n"
+"    -f file read options, equivalences and client calls from this INI file\n"
+"    -r      reset registered receivers when sender disconnects - ie reset\n"
+"            outputs of an app when it shuts down (default no change)\n"
+"    -k      kill previous client when a new client with the same name\n"
+"            registers (default: do not accept the new client)\n"
+"    -z      block keyboard input (required when iCserver is executed as a\n"
+"            background process)\n"
+"    -h      help, ouput Usage text only\n"
+"        DEBUG options\n"
+"    -t      trace messages for debugging\n"
+"    -m      display elapsed time in seconds and microseconds\n"
+"        AUXILIARY app   - start a Bernstein chain\n"
+"    -R <app ...> run one app followed by -z and its arguments as a\n"
+"                 separate process; -R ... must be last arguments\n"
+"        KEYBOARD inputs\n"
+"        t   toggle -t option - trace messages for debugging.\n"
+"        m   toggle -m option - display elapsed time.\n"
+"        T   output %s Client Tables.\n"
+"        q   stop %s and all registered iC apps.\n"
+"Copyright (C) 2001  John E. Wulff     <immediateC@gmail.com>\n"
+"%s\n"
+;
+
+#define HSIZ		4		/* length header of each message */
+#define NSIZ		509		/* size of hash table for I/O names */
+#define EVENTS		64		/* epoll events handled per epoll_wait() */
+#define AUTODELAY	1000		/* ms delay for other apps to register before autovivify */
+
+/********************************************************************
+ *  A client connection
+ *******************************************************************/
+
+typedef struct Conn {
+    int			fd;		/* socket of this connection */
+    int			id;		/* S<id> in messages */
+    char *		name;		/* registered client name or NULL */
+    const char *	app;		/* "\t[iC app]" or "" */
+    int			regFlag;	/* client has completed registration */
+    int			binary;		/* client registered B for binary frames */
+    int			dead;		/* disconnected - close after current events */
+    char *		in;		/* receive buffer - initially NULL */
+    int			inSize;
+    int			head;		/* start of next unprocessed message */
+    int			tail;		/* end of received data */
+    char *		out;		/* channel:value pairs for this receiver - initially NULL */
+    int			outSize;
+    int			outLen;
+    int *		ends;		/* end of each frame in out - initially NULL */
+    int			endSize;
+    int			endCnt;
+    unsigned int	seq;		/* message which started the last frame */
+    struct Conn *	nextOut;	/* list of connections with collected output */
+    ShmArea *		shm;		/* shared memory rings offered by client or NULL */
+    int			shmOn;		/* messages use shm after last acknowledgment */
+    int			bellIn;		/* doorbell from client (read end of .up) */
+    int			bellOut;	/* doorbell to client (write end of .dn) */
+} Conn;
+
+/********************************************************************
+ *  Receivers of one channel or one alternate channel
+ *******************************************************************/
+
+typedef struct Recv {
+    int			cnt;
+    int			size;
+    Conn **		cons;		/* receiver connections - initially NULL */
+    char **		names;		/* receiver names */
+} Recv;
+
+typedef struct AltRecv {
+    int			secCh;		/* secondary channel for these alternate receivers */
+    Recv		r;
+} AltRecv;
+
+/********************************************************************
+ *  All information for one channel - indexed by channel
+ *******************************************************************/
+
+typedef struct Channel {
+    Conn *		sender;		/* sender connection */
+    char *		senderName;	/* sender I/O name */
+    char *		value;		/* current sender value - initially NULL */
+    int			valSize;
+    int			cd;		/* SC<name> SD<name> RC<name> RD<name> for iClive */
+    Recv		recv;		/* primary channel receivers */
+    int			altCnt;
+    int			altSize;
+    AltRecv *		alt;		/* alternate channel receivers - initially NULL */
+} Channel;
+
+/********************************************************************
+ *  I/O names hashed by name - channel and equivBase[] entry
+ *******************************************************************/
+
+typedef struct Name {
+    struct Name *	next;
+    char *		name;
+    int			channel;	/* 0 if no channel allocated */
+    char *		base;		/* base name of equivalenced names or NULL */
+    int			primCh;
+    int			secCh;
+} Name;
+
+/********************************************************************
+ *  equivalences[] hashed by base - groups of names with one channel
+ *******************************************************************/
+
+typedef struct Inst {
+    char *		inst;		/* instance "" "-1" "-2" ... */
+    char *		name;
+} Inst;
+
+typedef struct EqGroup {
+    int			channel;
+    int			cnt;
+    int			size;
+    Inst *		insts;
+} EqGroup;
+
+typedef struct Equiv {
+    struct Equiv *	next;
+    char *		base;
+    int			cnt;
+    int			size;
+    EqGroup **		groups;
+} Equiv;
+
+typedef struct AutoEntry {
+    char *		base;		/* IEC name without ,bits */
+    char *		arg;		/* iCbox argument IEC[,bits] */
+} AutoEntry;
+
+static char *		named;		/* name of this executable */
+static const char *	opt_s = "0.0.0.0";
+static const char *	opt_p = iC_PORT;
+static const char *	opt_A = NULL;
+static int		opt_a, opt_d, opt_t, opt_m, opt_q, opt_r, opt_k, opt_z;
+static char *		equivArgs = NULL;	/* all -e arguments comma separated */
+static char **		runArgs = NULL;		/* -R app and its arguments */
+static int		runCnt, runSize, Rflag;
+
+static int		epfd;			/* epoll instance */
+static int		lfd;			/* listening socket */
+static const char *	unixPath = NULL;	/* bound Unix domain socket - removed on exit */
+static Conn **		conns = NULL;		/* indexed by fd - initially NULL */
+static int		connSize = 0;
+static Conn *		outList = NULL;		/* connections with collected output */
+static int		connCount, numberOfConnections;
+static unsigned int	msgSeq;			/* counts received messages */
+
+static Channel *	chans = NULL;		/* indexed by channel - initially NULL */
+static int		chanSize = 0;
+static int		maxChannel = 0;
+static Name *		names[NSIZ];
+static Equiv *		equivalences = NULL;
+
+static char *		boxName = NULL;		/* set while an iCbox is being collected */
+static AutoEntry *	autoMap = NULL;		/* iCbox arguments - initially NULL */
+static int		autoCnt, autoSize;
+static long long	autoDeadline;		/* ms when iCbox is autovivified */
+
+static struct iovec *	iov = NULL;		/* writev() vector - initially NULL */
+static int		iovSize = 0;
+static unsigned char *	hdr = NULL;		/* length headers for iov - initially NULL */
+static char *		binBuf = NULL;		/* binary records for iov - initially NULL */
+static int		binSize = 0;
+static char *		valBuf = NULL;		/* decoded binary frame - initially NULL */
+static int		valSize = 0;
+
+static volatile sig_atomic_t	sigFlag = 0;
+static struct timeval	t0;
+
+static void	shutdownServer(int ret, const char * message);
+static void	warnD(const char * fmt, ...) __attribute__ ((format (printf, 1, 2)));
+static void	disconnect(Conn * c);
+
+/********************************************************************
+ *
+ *	Small utilities
+ *
+ *******************************************************************/
+
+static void *
+emalloc(size_t n)
+{
+    void *	p;
+
+    if ((p = calloc(1, n)) == NULL) {
+	shutdownServer(10, "out of memory");
+    }
+    return p;
+} /* emalloc */
+
+static char *
+estrdup(const char * s)
+{
+    char *	p = emalloc(strlen(s) + 1);
+
+    return strcpy(p, s);
+} /* estrdup */
+
+static long long
+msNow(void)
+{
+    struct timespec	ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+} /* msNow */
+
+/********************************************************************
+ *
+ *	Hash table of I/O names
+ *
+ *******************************************************************/
+
+static Name *
+lookup(const char * name, int create)
+{
+    unsigned int	h = 0;
+    const char *	cp;
+    Name *		np;
+
+    for (cp = name; *cp; cp++) {
+	h = h * 31 + (unsigned char)*cp;
+    }
+    h %= NSIZ;
+    for (np = names[h]; np; np = np->next) {
+	if (strcmp(np->name, name) == 0) {
+	    return np;
+	}
+    }
+    if (create) {
+	np = emalloc(sizeof(Name));
+	np->name = estrdup(name);
+	np->next = names[h];
+	names[h] = np;
+    }
+    return np;
+} /* lookup */
+
+static int
+channelOf(const char * name)
+{
+    Name *	np = lookup(name, 0);
+
+    return np ? np->channel : 0;
+} /* channelOf */
+
+/********************************************************************
+ *
+ *	Sort order for autovivified iCbox arguments and table output
+ *
+ *  sort order is instance then IEC names in the following order
+ *  IX IB IW IL IH QX QB QW QL QH .. finally number
+ *   0  1  2  .. 10 11 12 .. 9999 .. correct for numerical compare
+ *
+ *******************************************************************/
+
+static int
+iecKey(const char * s, int * inst, int * type, long * num)
+{
+    static const char	order[] = "XBWLH";
+    const char *	cp = s;
+    const char *	tp;
+
+    if (!isupper((unsigned char)*cp)) return 0;
+    while (isupper((unsigned char)*cp)) cp++;
+    if (!isdigit((unsigned char)*cp)) return 0;
+    *type = 10;
+    if (cp - s == 2 && (*s == 'I' || *s == 'Q') && (tp = strchr(order, s[1])) != NULL) {
+	*type = (tp - order) + (*s == 'Q' ? 5 : 0);
+    }
+    *num = strtol(cp, (char **)&cp, 10);
+    *inst = *cp == '-' ? atoi(cp + 1) : -1;
+    return 1;
+} /* iecKey */
+
+static int
+iCboxOrder(const void * a, const void * b)
+{
+    const char *	sa = *(const char * const *)a;
+    const char *	sb = *(const char * const *)b;
+    int			ia, ib, ta, tb;
+    long		na, nb;
+
+    if (!iecKey(sa, &ia, &ta, &na) || !iecKey(sb, &ib, &tb, &nb)) {
+	return strcmp(sa, sb);		/* not IEC names */
+    }
+    if (ia != ib) return ia < ib ? -1 : 1;	/* instance "" => -1, "-0" => 0 ... */
+    if (ta != tb) return ta < tb ? -1 : 1;	/* IEC header "IX" => 0, "IB" => 1 ... */
+    if (na != nb) return na < nb ? -1 : 1;	/* IEC number */
+    return strcmp(sa, sb);
+} /* iCboxOrder */
+
+static int
+strOrder(const void * a, const void * b)
+{
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+} /* strOrder */
+
+/********************************************************************
+ *
+ *	Receiver lists
+ *
+ *******************************************************************/
+
+static void
+recvPush(Recv * rp, Conn * c, const char * name)
+{
+    if (rp->cnt >= rp->size) {
+	rp->size = rp->size ? rp->size * 2 : 4;
+	rp->cons = realloc(rp->cons, rp->size * sizeof(Conn *));	/* initially NULL */
+	assert(rp->cons);
+	rp->names = realloc(rp->names, rp->size * sizeof(char *));
+	assert(rp->names);
+    }
+    rp->cons[rp->cnt] = c;
+    rp->names[rp->cnt++] = estrdup(name);
+} /* recvPush */
+
+static void
+recvSplice(Recv * rp, int i)
+{
+    free(rp->names[i]);
+    rp->cnt--;
+    memmove(&rp->cons[i], &rp->cons[i+1], (rp->cnt - i) * sizeof(Conn *));
+    memmove(&rp->names[i], &rp->names[i+1], (rp->cnt - i) * sizeof(char *));
+} /* recvSplice */
+
+static void
+recvClear(Recv * rp)
+{
+    while (rp->cnt > 0) {
+	free(rp->names[--rp->cnt]);
+    }
+} /* recvClear */
+
+static AltRecv *
+altPush(Channel * cp, int secCh, int front)
+{
+    AltRecv *	ap;
+
+    if (cp->altCnt >= cp->altSize) {
+	cp->altSize = cp->altSize ? cp->altSize * 2 : 2;
+	cp->alt = realloc(cp->alt, cp->altSize * sizeof(AltRecv));	/* initially NULL */
+	assert(cp->alt);
+    }
+    if (front) {
+	memmove(&cp->alt[1], &cp->alt[0], cp->altCnt * sizeof(AltRecv));
+	ap = &cp->alt[0];
+    } else {
+	ap = &cp->alt[cp->altCnt];
+    }
+    cp->altCnt++;
+    memset(ap, 0, sizeof(AltRecv));
+    ap->secCh = secCh;
+    return ap;
+} /* altPush */
+
+/********************************************************************
+ *
+ *	Allocate a channel to a name
+ *
+ *	This gives each Sender and Receiver pair an index called 'channel'
+ *	in the array 'chans'. Each data transmission starts with this
+ *	channel number. Some differing names may use the same channel
+ *	(equivalences).
+ *
+ *******************************************************************/
+
+static void
+growChannels(int channel)
+{
+    int		size;
+
+    if (channel >= chanSize) {
+	/********************************************************************
+	 *  Double the size of the array indexed randomly by 'channel'
+	 *******************************************************************/
+	size = chanSize ? chanSize : 16;
+	while (channel >= size) size *= 2;
+	chans = realloc(chans, size * sizeof(Channel));	/* initially NULL */
+	assert(chans);
+	memset(&chans[chanSize], 0, (size - chanSize) * sizeof(Channel));
+	chanSize = size;
+	if (opt_t) printf("/// chanSize = %d\n", chanSize);
+    }
+} /* growChannels */
+
+static int
+allocateChannel(const char * name, int channel)
+{
+    Name *	np = lookup(name, 1);
+
+    if (np->channel) {
+	if (channel > 0) {
+	    warnD("attempting to allocate channel %d for %s:%d twice - ignore", channel, name, np->channel);
+	}
+	channel = np->channel;		/* previously allocated channel for this name */
+    } else {
+	if (channel == 0) {
+	    channel = ++maxChannel;
+	}
+	growChannels(channel);
+	if (channel > maxChannel) {
+	    maxChannel = channel;
+	}
+	np->channel = channel;
+    }
+    if (opt_t) printf("%s: allocateChannel \"%s\", %d\n", named, name, channel);
+    return channel;
+} /* allocateChannel */
+
+/********************************************************************
+ *
+ *	equivalences[] support
+ *
+ *******************************************************************/
+
+static Equiv *
+equivGet(const char * base)
+{
+    Equiv *	ep;
+
+    for (ep = equivalences; ep; ep = ep->next) {
+	if (strcmp(ep->base, base) == 0) {
+	    return ep;
+	}
+    }
+    return NULL;
+} /* equivGet */
+
+static Equiv *
+equivNew(const char * base)
+{
+    Equiv *	ep = emalloc(sizeof(Equiv));
+
+    ep->base = estrdup(base);
+    ep->next = equivalences;
+    equivalences = ep;
+    return ep;
+} /* equivNew */
+
+static void
+equivRebase(const char * base, const char * name)
+{
+    Equiv *	ep;
+
+    if ((ep = equivGet(base)) != NULL) {
+	free(ep->base);
+	ep->base = estrdup(name);	/* move equivalence set to new base */
+	if (opt_t) printf("--- delete equivalences[%s]\n", base);
+    }
+} /* equivRebase */
+
+static void
+equivInsert(Equiv * ep, EqGroup * gp, int front)
+{
+    if (ep->cnt >= ep->size) {
+	ep->size = ep->size ? ep->size * 2 : 4;
+	ep->groups = realloc(ep->groups, ep->size * sizeof(EqGroup *));	/* initially NULL */
+	assert(ep->groups);
+    }
+    if (front) {
+	memmove(&ep->groups[1], &ep->groups[0], ep->cnt * sizeof(EqGroup *));
+	ep->groups[0] = gp;
+    } else {
+	ep->groups[ep->cnt] = gp;
+    }
+    ep->cnt++;
+} /* equivInsert */
+
+static void
+instPush(EqGroup * gp, const char * inst, const char * name)
+{
+    if (gp->cnt >= gp->size) {
+	gp->size = gp->size ? gp->size * 2 : 4;
+	gp->insts = realloc(gp->insts, gp->size * sizeof(Inst));	/* initially NULL */
+	assert(gp->insts);
+    }
+    gp->insts[gp->cnt].inst = estrdup(inst);
+    gp->insts[gp->cnt++].name = estrdup(name);
+} /* instPush */
+
+static Inst *
+instFind(EqGroup * gp, const char * inst)
+{
+    int		i;
+
+    for (i = 0; i < gp->cnt; i++) {
+	if (strcmp(gp->insts[i].inst, inst) == 0) {
+	    return &gp->insts[i];
+	}
+    }
+    return NULL;
+} /* instFind */
+
+static void
+setEquivBase(const char * name, const char * base, int primCh, int secCh)
+{
+    Name *	np = lookup(name, 1);
+
+    free(np->base);
+    np->base = estrdup(base);
+    np->primCh = primCh;
+    np->secCh = secCh;
+} /* setEquivBase */
+
+static void
+rebasePrimary(int oldPrimCh, const char * base, int primCh)
+{
+    int		h;
+    Name *	np;
+
+    for (h = 0; h < NSIZ; h++) {
+	for (np = names[h]; np; np = np->next) {
+	    if (np->base && np->primCh == oldPrimCh) {	/* find old primary channel */
+		free(np->base);
+		np->base = estrdup(base);	/* re-assign base */
+		np->primCh = primCh;		/* re-assign primary channel */
+	    }
+	}
+    }
+} /* rebasePrimary */
+
+static int	autoDelete(const char * iec);
+
+/********************************************************************
+ *
+ *	Allocate equivalences  -  with the -e option in this server
+ *	or from another iC app either
+ *	    as a single equivalence IX0=IX0-1
+ *	    or as a multiple equivalence IX0=IX0-1=IX0-2
+ *	    or as group-equivalences IX0=IX2=IX4, which belong to one instance of
+ *		an app characterized by having the same connection
+ *	    or as a space or comma separated list of the above equivalences
+ *
+ *	The data structures and the algorithm are the same as described
+ *	for allocateEquivalences() in goserver.go.
+ *
+ *******************************************************************/
+
+static void
+allocateEquivalences(const char * arg)
+{
+    char *	args = estrdup(arg);
+    char *	equiv;
+    char *	sp1;
+    int		errFlag = 0;
+
+    for (equiv = strtok_r(args, ", ", &sp1); equiv; equiv = strtok_r(NULL, ", ", &sp1)) {
+	char *	copy = estrdup(equiv);
+	char *	nn;
+	char *	sp2;
+	char **	setNames = NULL;	/* initially NULL */
+	char **	setInsts = NULL;
+	int	setCnt = 0;
+	int	dupFlag = 0;
+	int	xbwlh = 0;
+	char	base[128] = "";
+	int	primCh = 0, secCh = 0, ch = 0;
+	int	i;
+
+	if (!opt_q) printf("Equivalence \"%s\"\n", equiv);
+	/********************************************************************
+	 *  The following are all part of a set of equivalence groups belonging to
+	 *  one base IEC name. Scan once to see of this set extends a previous set
+	 *  by checking in equivBase[].
+	 *******************************************************************/
+	for (nn = strtok_r(copy, "=", &sp2); nn; nn = strtok_r(NULL, "=", &sp2)) {
+	    char *	cp = nn + 2;
+	    char *	inst;
+	    Name *	np;
+
+	    if (opt_t) printf("--- nn = \"%s\"\n", nn);
+	    if ((nn[0] != 'I' && nn[0] != 'Q') || strchr("XBWLH", nn[1]) == NULL || nn[1] == '\0' ||
+		!isdigit((unsigned char)*cp)) {
+		goto notIEC;
+	    }
+	    while (isdigit((unsigned char)*cp)) cp++;
+	    inst = cp;
+	    if (*cp == '-') {
+		while (isdigit((unsigned char)*++cp));
+		if (cp - inst < 2 || cp - inst > 4) goto notIEC;
+	    }
+	    if (*cp != '\0' || strlen(nn) >= sizeof(base)) {
+	      notIEC:
+		fprintf(stderr, "ERROR %s: \"%s\" in \"%s\" is not an IEC name - will not work!\n", named, nn, equiv);
+		errFlag = 1;
+		continue;
+	    }
+	    if (xbwlh) {
+		if (xbwlh != nn[1]) {
+		    fprintf(stderr, "ERROR %s: \"%s\" in \"%s\" is not the same IEC type - will not work!\n", named, nn, equiv);
+		    errFlag = 1;
+		}
+	    } else {
+		xbwlh = nn[1];		/* IEC type of first equivalence entry */
+	    }
+	    if ((np = lookup(nn, 0)) != NULL && np->base) {
+		strcpy(base, np->base);
+		primCh = np->primCh;
+		secCh = np->secCh;
+	    } else {
+		ch = np ? np->channel : 0;
+		if (opt_t) printf("%%%%%% N nn = \"%s\" inst = \"%s\" base = \"%s\" primCh = %d secCh = %d ch = %d\n",
+		    nn, inst, base, primCh, secCh, ch);
+		if (*base == '\0' || nn[0] == 'Q' || ch > 0) {
+		    if (ch > 0 && primCh > 0) {
+			/********************************************************************
+			 *  Encountered a pre-registered input, whose channel has been allocated
+			 *   1) ignore 2nd and further pre-registered inputs per equivalence
+			 *   2) move the equivalence set from the previous base to this input name
+			 *   3) re-assign the new name and channel as base and primary channel
+			 *   4) rebase alternate receivers already registered to new primary channel
+			 *   5) rebase primary receivers already registered as secondary channel
+			 *      entries in alternate receivers because channels have been acked
+			 *   6) delete Autovivify entry for primary input already registered
+			 *******************************************************************/
+			Channel *	op = &chans[primCh];
+			Channel *	cp1 = &chans[ch];
+			if (dupFlag) {		/* 1) */
+			    fprintf(stderr, "Warning %s: cannot have more than 1 pre-registered input \"%s\" on ch '%d' in \"%s\" - ignore\n",
+				named, nn, ch, equiv);
+			    continue;
+			}
+			dupFlag = 1;
+			equivRebase(base, nn);			/* 2) */
+			rebasePrimary(primCh, nn, ch);		/* 3) */
+			if (op->altCnt) {			/* 4) */
+			    free(cp1->alt);
+			    cp1->alt = op->alt; cp1->altCnt = op->altCnt; cp1->altSize = op->altSize;
+			    op->alt = NULL; op->altCnt = op->altSize = 0;
+			}
+			if (op->recv.cnt > 0) {			/* 5) */
+			    AltRecv *	ap = altPush(cp1, primCh, 1);	/* unshift */
+			    ap->r = op->recv;
+			    memset(&op->recv, 0, sizeof(Recv));
+			}
+			if (boxName) {				/* 6) */
+			    autoDelete(base);
+			}
+		    } else {
+			ch = 0;			/* no primary channel (or no channel) */
+		    }
+		    strcpy(base, nn);
+		    setNames = realloc(setNames, (setCnt + 1) * sizeof(char *));	/* initially NULL */
+		    assert(setNames);
+		    setInsts = realloc(setInsts, (setCnt + 1) * sizeof(char *));
+		    assert(setInsts);
+		    memmove(&setNames[1], &setNames[0], setCnt * sizeof(char *));	/* unshift output or first input */
+		    memmove(&setInsts[1], &setInsts[0], setCnt * sizeof(char *));
+		    setNames[0] = nn;
+		    setInsts[0] = inst;
+		} else {
+		    setNames = realloc(setNames, (setCnt + 1) * sizeof(char *));	/* push later inputs */
+		    assert(setNames);
+		    setInsts = realloc(setInsts, (setCnt + 1) * sizeof(char *));
+		    assert(setInsts);
+		    setNames[setCnt] = nn;
+		    setInsts[setCnt] = inst;
+		}
+		setCnt++;
+	    }
+	}
+	/********************************************************************
+	 *  Now a base IEC name has been determined distribute equivalences
+	 *  in equivalences[] - also update equivBase[].
+	 *******************************************************************/
+	if (opt_t) printf("--- base = \"%s\"\n", base);
+	for (i = 0; i < setCnt; i++) {
+	    Equiv *	ep;
+	    EqGroup *	gp;
+	    int		j;
+
+	    nn = setNames[i];
+	    if (opt_t) printf("--- nn = \"%s\" inst = \"%s\" primCh = %d ch = %d\n", nn, setInsts[i], primCh, ch);
+	    if (ch > 0) {
+		primCh = secCh = ch;
+	    } else {
+		if ((ep = equivGet(base)) != NULL) {
+		    for (j = 0; j < ep->cnt; j++) {
+			gp = ep->groups[j];
+			secCh = gp->channel;
+			if (instFind(gp, setInsts[i]) == NULL) {
+			    instPush(gp, setInsts[i], nn);	/* extend group with different instance */
+			    allocateChannel(nn, secCh);		/* same channel for next IEC instance */
+			    setEquivBase(nn, base, primCh, 0);
+			    if (opt_t) printf("--- ext secCh = %d nn = \"%s\"\n", secCh, nn);
+			    goto EquivStored;
+			}
+		    }
+		}
+		secCh = allocateChannel(nn, 0);	/* new channel for first IEC name in group */
+	    }
+	    if (primCh == 0) {
+		primCh = secCh;
+	    }
+	    if (opt_t) printf("--- new secCh = %d nn = \"%s\"\n", secCh, nn);
+	    gp = emalloc(sizeof(EqGroup));
+	    gp->channel = secCh;
+	    instPush(gp, setInsts[i], nn);
+	    if ((ep = equivGet(base)) == NULL) {
+		ep = equivNew(base);
+	    }
+	    if (ch > 0) {
+		equivInsert(ep, gp, 1);	/* new group for pre-registered input - unshift */
+		ch = 0;
+	    } else {
+		equivInsert(ep, gp, 0);	/* new group on a different channel - push */
+	    }
+	    setEquivBase(nn, base, primCh, 0);
+	  EquivStored: ;
+	}
+	free(setNames);
+	free(setInsts);
+	free(copy);
+    }
+    free(args);
+    if (errFlag) {
+	shutdownServer(9, "Hard error in equivalence specifications");
+    }
+} /* allocateEquivalences */
+
+/********************************************************************
+ *
+ *	Binary records - same encoding as iC_put_record() and
+ *	iC_get_record() in tcpc.c
+ *
+ *******************************************************************/
+
+static char *
+putRecord(char * bp, unsigned short channel, long val)
+{
+    unsigned long	u;
+    unsigned char	b[BSIZ];
+    int			n = 0;
+
+    u = (unsigned long)val << 1;
+    if (val < 0) u = ~u;			/* zig-zag: small negative values are short */
+    *bp++ = channel >> 8;
+    *bp++ = channel;
+    do {
+	b[n++] = u & 0x7f;
+	u >>= 7;
+    } while (u);
+    while (--n > 0) {
+	*bp++ = b[n] | 0x80;			/* more bytes follow */
+    }
+    *bp++ = b[0];				/* last byte */
+    return bp;
+} /* putRecord */
+
+static const char *
+getRecord(const char * bp, const char * ep, unsigned short * channelp, long * valp)
+{
+    unsigned long	u = 0;
+    unsigned char	c;
+
+    if (ep - bp < 3) {
+	return NULL;				/* shortest record is 3 bytes */
+    }
+    *channelp = (unsigned char)bp[0] << 8 | (unsigned char)bp[1];
+    bp += 2;
+    do {
+	if (bp >= ep) {
+	    return NULL;			/* truncated value */
+	}
+	c = *bp++;
+	u = u << 7 | (c & 0x7f);
+    } while (c & 0x80);
+    *valp = (u & 1) ? ~(long)(u >> 1) : (long)(u >> 1);
+    return bp;
+} /* getRecord */
+
+/********************************************************************
+ *
+ *	Decode a binary frame into comma separated channel:value pairs
+ *	in valBuf. Returns NULL if a record is truncated.
+ *
+ *******************************************************************/
+
+static char *
+decodeFrame(const char * bp, int len)
+{
+    const char *	ep = bp + len;
+    unsigned short	channel;
+    long		val;
+    int			n = 0;
+
+    if (valSize < len * 8 + 1) {
+	valSize = len * 8 + 1;			/* 3 byte record => at most 24 characters */
+	valBuf = realloc(valBuf, valSize);	/* initially NULL */
+	assert(valBuf);
+    }
+    for (bp++; bp < ep; ) {			/* skip BIN_FRAME */
+	if ((bp = getRecord(bp, ep, &channel, &val)) == NULL) {
+	    return NULL;
+	}
+	n += sprintf(valBuf + n, n ? ",%hu:%ld" : "%hu:%ld", channel, val);
+    }
+    valBuf[n] = '\0';
+    return valBuf;
+} /* decodeFrame */
+
+/********************************************************************
+ *
+ *	Make room for a file descriptor in conns[]
+ *
+ *******************************************************************/
+
+static void
+connsGrow(int fd)
+{
+    if (fd >= connSize) {
+	int	size = connSize ? connSize : 64;
+	while (fd >= size) size *= 2;
+	conns = realloc(conns, size * sizeof(Conn *));	/* initially NULL */
+	assert(conns);
+	memset(&conns[connSize], 0, (size - connSize) * sizeof(Conn *));
+	connSize = size;
+    }
+} /* connsGrow */
+
+/********************************************************************
+ *
+ *	Shared memory transport with a client on the same host
+ *
+ *	shmOpen() maps the rings and opens both doorbells named in the
+ *	registration item M<name>. If this fails the registration is not
+ *	acknowledged with ",M" and the client keeps using TCP/IP.
+ *
+ *	shmStart() is called after the acknowledgment has been sent on
+ *	the TCP/IP socket. From then on messages use the rings.
+ *
+ *******************************************************************/
+
+static void
+shmOpen(Conn * c, const char * name)
+{
+    char	path[SHM_NSIZ + sizeof(SHM_DIR)];
+    struct stat	st;
+    ShmArea *	ap;
+    int		fd, n;
+
+    if (c->shm || strchr(name, '/') ||
+	(n = snprintf(path, sizeof path - 3, SHM_DIR "%s", name)) >= (int)sizeof path - 3) {
+	errno = EINVAL;				/* leave room for ".up" */
+	goto failed;
+    }
+    if ((fd = open(path, O_RDWR | O_CLOEXEC)) < 0) goto failed;
+    if (fstat(fd, &st) < 0 || st.st_size != sizeof(ShmArea) ||
+	(ap = mmap(NULL, sizeof(ShmArea), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+	if (errno == 0) errno = EINVAL;
+	close(fd);
+	goto failed;
+    }
+    close(fd);					/* mapping stays valid */
+    strcpy(path + n, ".dn");
+    if ((c->bellOut = open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC)) < 0) {
+	munmap(ap, sizeof(ShmArea));
+	goto failed;
+    }
+    strcpy(path + n, ".up");
+    if ((c->bellIn = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC)) < 0) {
+	close(c->bellOut);
+	munmap(ap, sizeof(ShmArea));
+	goto failed;
+    }
+    c->shm = ap;
+    if (opt_t) printf("S%d: shared memory %s\n", c->id, name);
+    return;
+
+  failed:
+    if (opt_t) printf("S%d: no shared memory %s: %s - use TCP/IP\n", c->id, name, strerror(errno));
+} /* shmOpen */
+
+static void
+shmStart(Conn * c)
+{
+    struct epoll_event	ev;
+
+    connsGrow(c->bellIn);
+    conns[c->bellIn] = c;			/* doorbell events for this connection */
+    ev.events = EPOLLIN;
+    ev.data.fd = c->bellIn;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, c->bellIn, &ev) < 0) {
+	shutdownServer(3, strerror(errno));
+    }
+    c->shmOn = 1;
+} /* shmStart */
+
+/********************************************************************
+ *
+ *	Write frames to a client via shared memory
+ *	Wait if the ring is full until the client has read some of it
+ *
+ *******************************************************************/
+
+static int
+shmFrames(Conn * c, struct iovec * vp, int n)
+{
+    ShmRing *		rp = &c->shm->dn;
+    struct pollfd	pfd;
+    const char *	bp;
+    int			len, w;
+
+    for ( ; n > 0; vp++, n--) {
+	bp = vp->iov_base;
+	for (len = vp->iov_len; len > 0; len -= w, bp += w) {
+	    if ((w = shmWrite(rp, bp, len)) == 0) {
+		shmWake(rp, c->bellOut);	/* client must read before there is room */
+		pfd.fd = c->bellIn;		/* only POLLHUP if client has gone */
+		pfd.events = 0;
+		if (poll(&pfd, 1, 1) > 0) {
+		    fprintf(stderr, "%s: write to '%s' failed: client has gone\n", named, c->name ? c->name : "<undef>");
+		    return -1;
+		}
+	    }
+	}
+    }
+    shmWake(rp, c->bellOut);
+    return 0;
+} /* shmFrames */
+
+/********************************************************************
+ *
+ *	Send frames to one connection with one writev()
+ *
+ *	Each frame is described by 2 consecutive iovec entries, the first
+ *	for its length header in hdr[], the second for its data, which
+ *	may be text in the output buffer or binary records in binBuf.
+ *
+ *******************************************************************/
+
+static void
+iovGrow(int n)
+{
+    if (n > iovSize) {
+	iovSize = n + 64;
+	iov = realloc(iov, iovSize * sizeof(struct iovec));	/* initially NULL */
+	assert(iov);
+	hdr = realloc(hdr, iovSize * HSIZ);			/* initially NULL */
+	assert(hdr);
+    }
+} /* iovGrow */
+
+static int
+iovFrame(int n, const char * data, int len)
+{
+    unsigned char *	hp;
+
+    iovGrow(n + 2);
+    hp = &hdr[n * HSIZ];
+    hp[0] = len >> 24; hp[1] = len >> 16; hp[2] = len >> 8; hp[3] = len;
+    iov[n].iov_base = hp;
+    iov[n++].iov_len = HSIZ;
+    iov[n].iov_base = (void *)data;
+    iov[n++].iov_len = len;
+    return n;
+} /* iovFrame */
+
+static int
+writeFrames(Conn * c, int n)
+{
+    struct iovec *	vp = iov;
+    ssize_t		r;
+    int			i;
+
+    for (i = 0; i < n; i += 2) {
+	iov[i].iov_base = &hdr[i * HSIZ];	/* hdr may have moved */
+    }
+    if (c->shmOn) {
+	return shmFrames(c, iov, n);
+    }
+    while (n > 0) {
+	if ((r = writev(c->fd, vp, n > IOV_MAX ? IOV_MAX : n)) < 0) {
+	    if (errno == EINTR) continue;
+	    fprintf(stderr, "%s: write to '%s' failed: %s\n", named, c->name ? c->name : "<undef>", strerror(errno));
+	    return -1;
+	}
+	while (n > 0 && (size_t)r >= vp->iov_len) {
+	    r -= vp->iov_len;			/* complete entries */
+	    vp++;
+	    n--;
+	}
+	if (n > 0) {
+	    vp->iov_base = (char *)vp->iov_base + r;	/* partial write */
+	    vp->iov_len -= r;
+	}
+    }
+    return 0;
+} /* writeFrames */
+
+static void
+sendText(Conn * c, const char * msg)
+{
+    writeFrames(c, iovFrame(0, msg, strlen(msg)));
+} /* sendText */
+
+/********************************************************************
+ *
+ *	Add frames for one message of comma separated channel:value pairs
+ *	to the iovec entries for one connection starting at entry n.
+ *	Returns the next free iovec entry.
+ *
+ *	A client which registered B receives integer values in binary
+ *	frames, whose records are placed at *bpp. Text values and values
+ *	out of range are sent in text frames. The order of all
+ *	channel:value pairs is kept.
+ *	Other clients have a fixed receive buffer of REPLY bytes - long
+ *	text messages for them are split into several shorter messages.
+ *
+ *******************************************************************/
+
+static int
+framePairs(Conn * c, char * msg, int len, int n, char ** bpp)
+{
+    char *	cp = msg;
+    char *	ep = msg + len;
+    char *	tp = NULL;		/* start of current text frame */
+    char *	bp = *bpp;
+    char *	fp = NULL;		/* start of current binary frame */
+
+    if (c->binary) {
+	while (cp < ep) {
+	    char *	np = memchr(cp, ',', ep - cp);
+	    char *	vp;
+	    long	ch, val = 0;
+
+	    if (np == NULL) np = ep;
+	    ch = strtol(cp, &vp, 10);
+	    if (isdigit((unsigned char)*cp) && *vp == ':' && ch <= 0xffff &&
+		(*++vp == '-' || isdigit((unsigned char)*vp)) &&
+		(val = strtol(vp, &vp, 10), vp == np) &&
+		val >= -2147483648L && val <= 2147483647L) {
+		if (tp) {
+		    n = iovFrame(n, tp, cp - 1 - tp);	/* text frame up to ',' */
+		    tp = NULL;
+		}
+		if (fp == NULL) {
+		    fp = bp;
+		    *bp++ = BIN_FRAME;
+		}
+		bp = putRecord(bp, ch, val);
+	    } else {
+		if (fp) {
+		    n = iovFrame(n, fp, bp - fp);
+		    fp = NULL;
+		}
+		if (tp == NULL) tp = cp;
+	    }
+	    cp = np + 1;
+	}
+	if (tp) n = iovFrame(n, tp, ep - tp);
+	if (fp) n = iovFrame(n, fp, bp - fp);
+	*bpp = bp;
+    } else if (len <= REPLY) {
+	n = iovFrame(n, msg, len);
+    } else {
+	tp = cp;
+	while (cp < ep) {
+	    char *	np = memchr(cp, ',', ep - cp);
+
+	    if (np == NULL) np = ep;
+	    if (np - tp > REPLY && cp > tp) {
+		n = iovFrame(n, tp, cp - 1 - tp);	/* split long message for fixed buffer */
+		tp = cp;
+	    }
+	    cp = np + 1;
+	}
+	n = iovFrame(n, tp, ep - tp);
+    }
+    return n;
+} /* framePairs */
+
+static void
+binGrow(int len)
+{
+    if (binSize < len) {
+	binSize = len;				/* records are never longer than their text */
+	binBuf = realloc(binBuf, binSize);	/* initially NULL */
+	assert(binBuf);
+    }
+} /* binGrow */
+
+static void
+sendPairs(Conn * c, char * msg, int len)
+{
+    char *	bp;
+
+    binGrow(len + 1);
+    bp = binBuf;
+    writeFrames(c, framePairs(c, msg, len, 0, &bp));
+} /* sendPairs */
+
+/********************************************************************
+ *
+ *	Collect channel:value pairs for one receiver
+ *
+ *	Pairs from one received message are collected in one frame.
+ *	Pairs from different messages are kept in separate frames, so
+ *	that a receiver sees every value of a channel, but all frames
+ *	for one receiver are sent with one writev(). Each frame in out
+ *	is terminated by '\0'.
+ *
+ *******************************************************************/
+
+static void
+pushReceiverData(Conn * c, const char * msg, int len)
+{
+    if (c->outLen + len + 2 > c->outSize) {
+	c->outSize = (c->outLen + len + 2) * 2;
+	c->out = realloc(c->out, c->outSize);	/* initially NULL */
+	assert(c->out);
+    }
+    if (c->endCnt == 0) {
+	c->nextOut = outList;			/* first data for this receiver */
+	outList = c;
+    }
+    if (c->endCnt && c->seq == msgSeq) {
+	c->out[c->outLen++] = ',';		/* same message */
+    } else {
+	if (c->endCnt >= c->endSize) {
+	    c->endSize = c->endSize ? c->endSize * 2 : 8;
+	    c->ends = realloc(c->ends, c->endSize * sizeof(int));	/* initially NULL */
+	    assert(c->ends);
+	}
+	if (c->endCnt++) c->outLen++;		/* new frame after '\0' of previous frame */
+	c->seq = msgSeq;
+    }
+    memcpy(c->out + c->outLen, msg, len);
+    c->outLen += len;
+    c->out[c->outLen] = '\0';			/* strtol() in framePairs() stops here */
+    c->ends[c->endCnt - 1] = c->outLen;
+} /* pushReceiverData */
+
+/********************************************************************
+ *
+ *	Write messages collected for different connections
+ *
+ *******************************************************************/
+
+static void
+writeReceiverData(void)
+{
+    Conn *	c;
+    char *	bp;
+    int		start, i, n;
+
+    while ((c = outList) != NULL) {
+	outList = c->nextOut;
+	if (!c->dead) {
+	    binGrow(c->outLen + c->endCnt);	/* 1 BIN_FRAME per frame */
+	    bp = binBuf;
+	    for (n = start = i = 0; i < c->endCnt; start = c->ends[i++] + 1) {
+		if (opt_t) {
+		    int	ch = atoi(c->out + start);
+		    if (ch > maxChannel || !chans[ch].cd) {
+			printf("S%d: %.*s > %s\n", c->id, c->ends[i] - start, c->out + start,
+			    c->name ? c->name : "<undef>");
+		    }
+		}
+		n = framePairs(c, c->out + start, c->ends[i] - start, n, &bp);
+	    }
+	    writeFrames(c, n);
+	}
+	c->outLen = c->endCnt = 0;
+    }
+} /* writeReceiverData */
+
+/********************************************************************
+ *
+ *	Warning sent to Debug (iClive) registered on channel 0
+ *
+ *******************************************************************/
+
+static void
+warnD(const char * fmt, ...)
+{
+    char	msg[REPLY];
+    va_list	ap;
+    int		i;
+
+    va_start(ap, fmt);
+    memcpy(msg, "0:1;", 4);
+    vsnprintf(msg + 4, sizeof(msg) - 4, fmt, ap);
+    va_end(ap);
+    fprintf(stderr, "%s: WARNING: %s\n", named, msg + 4);
+    if (chanSize > 0) {
+	Recv *	rp = &chans[0].recv;	/* channel 0 for error messages */
+	for (i = 0; i < rp->cnt; i++) {
+	    if (!rp->cons[i]->dead) {
+		if (opt_t) fprintf(stderr, "%s: sent warning => %s\n", named, rp->cons[i]->name);
+		sendText(rp->cons[i], msg);
+	    }
+	}
+    }
+} /* warnD */
+
+/********************************************************************
+ *
+ *	Find the connection of a registered client
+ *
+ *******************************************************************/
+
+static Conn *
+clientCon(const char * name)
+{
+    int		fd;
+    Conn *	c;
+
+    for (fd = 0; fd < connSize; fd++) {
+	if ((c = conns[fd]) != NULL && !c->dead && c->name && strcmp(c->name, name) == 0) {
+	    return c;
+	}
+    }
+    return NULL;
+} /* clientCon */
+
+/********************************************************************
+ *
+ *	AutoVivify one or more iCbox's with option -a or -A 'iCbox <flags>'
+ *
+ *	autoStart() names the iCbox and starts collecting arguments.
+ *	autoAdd() and autoDelete() modify the collected arguments.
+ *	Each call delays autoVivify() by AUTODELAY ms for other apps to
+ *	register, which is then called from the main loop.
+ *
+ *******************************************************************/
+
+static void
+autoStart(const char * sender)
+{
+    if (boxName == NULL) {
+	boxName = emalloc(strlen(sender) + 4);
+	sprintf(boxName, "%s-IO", sender);	/* start AutoVivify iCbox */
+	autoCnt = 0;
+    }
+    autoDeadline = msNow() + AUTODELAY;
+} /* autoStart */
+
+static void
+autoAdd(const char * base, const char * bits)
+{
+    char	arg[128];
+    int		i;
+
+    snprintf(arg, sizeof(arg), bits && *bits ? "%s,%s" : "%s", base, bits);
+    for (i = 0; i < autoCnt; i++) {
+	if (strcmp(autoMap[i].base, base) == 0) {
+	    char *	pb = strchr(autoMap[i].arg, ',');
+	    if (bits && *bits) {
+		if (pb) {
+		    int	b = atoi(bits) | atoi(pb + 1);
+		    snprintf(arg, sizeof(arg), b == 255 ? "%s" : "%s,%d", base, b);
+		} else {
+		    snprintf(arg, sizeof(arg), "%s", base);	/* no ,bits in previous iec */
+		}
+	    }
+	    free(autoMap[i].arg);
+	    autoMap[i].arg = estrdup(arg);
+	    goto added;
+	}
+    }
+    if (autoCnt >= autoSize) {
+	autoSize = autoSize ? autoSize * 2 : 16;
+	autoMap = realloc(autoMap, autoSize * sizeof(AutoEntry));	/* initially NULL */
+	assert(autoMap);
+    }
+    autoMap[autoCnt].base = estrdup(base);
+    autoMap[autoCnt++].arg = estrdup(arg);
+  added:
+    if (opt_t) printf("=b= autoMsg    = %s\n", arg);
+    autoDeadline = msNow() + AUTODELAY;
+} /* autoAdd */
+
+static void
+autoRemove(const char * iec)
+{
+    int		i;
+
+    for (i = 0; i < autoCnt; i++) {
+	if (strcmp(autoMap[i].base, iec) == 0) {
+	    free(autoMap[i].base);
+	    free(autoMap[i].arg);
+	    autoMap[i] = autoMap[--autoCnt];
+	    return;
+	}
+    }
+} /* autoRemove */
+
+static int
+autoDelete(const char * iec)
+{
+    Name *	np;
+
+    if (boxName == NULL) {
+	return 0;
+    }
+    if (opt_t) printf("=b= autoMsg    = -%s\n", iec);
+    autoRemove(iec);
+    if ((np = lookup(iec, 0)) != NULL && np->base && strcmp(np->base, iec) != 0) {
+	autoRemove(np->base);
+    }
+    autoDeadline = msNow() + AUTODELAY;
+    return 1;
+} /* autoDelete */
+
+static void
+autoVivify(void)
+{
+    char *	cmd;
+    char **	argv;
+    char *	ioName;
+    char *	sp;
+    char *	tp;
+    int		argc = 0;
+    int		i;
+    pid_t	pid;
+
+    if (autoCnt > 0) {
+	char **	iCboxArgs = emalloc(autoCnt * sizeof(char *));
+	for (i = 0; i < autoCnt; i++) {
+	    iCboxArgs[i] = autoMap[i].arg;
+	}
+	qsort(iCboxArgs, autoCnt, sizeof(char *), iCboxOrder);
+	if (opt_a) {
+	    ioName = emalloc(strlen(boxName) + 64);
+	    strcpy(ioName, boxName);
+	    while (clientCon(ioName) && strlen(ioName) < strlen(boxName) + 63) {
+		strcat(ioName, "x");
+	    }
+	    cmd = estrdup(opt_A);
+	    argv = emalloc((strlen(opt_A) + autoCnt + 16) * sizeof(char *));
+	    for (tp = strtok_r(cmd, " ", &sp); tp; tp = strtok_r(NULL, " ", &sp)) {
+		argv[argc++] = tp;
+	    }
+	    if (IS_UNIX(opt_s)) { argv[argc++] = "-s"; argv[argc++] = (char *)opt_s; }
+	    if (strcmp(opt_p, iC_PORT) != 0) { argv[argc++] = "-p"; argv[argc++] = (char *)opt_p; }
+	    if (opt_t) argv[argc++] = "-t";
+	    if (opt_m) argv[argc++] = "-m";
+	    if (opt_q) argv[argc++] = "-q";
+	    argv[argc++] = "-n";
+	    argv[argc++] = ioName;
+	    for (i = 0; i < autoCnt; i++) {
+		argv[argc++] = iCboxArgs[i];
+	    }
+	    argv[argc] = NULL;
+	    if (!opt_q) {
+		printf("$");
+		for (i = 0; i < argc; i++) printf(" %s", argv[i]);
+		printf("\n");
+	    }
+	    fflush(stdout);
+	    if ((pid = fork()) == 0) {
+		execvp(argv[0], argv);		/* execute iCbox in another process */
+		perror(argv[0]);
+		_exit(7);
+	    } else if (pid < 0) {
+		shutdownServer(7, "fork failed");
+	    }
+	    if (opt_d) {
+		opt_a = 0;			/* autovivify iCbox -d only once to stop recursion */
+	    }
+	    free(argv);
+	    free(cmd);
+	    free(ioName);
+	} else {
+	    char	msg[REPLY];
+	    int		n = 0;
+	    for (i = 0; i < autoCnt && n < (int)sizeof(msg) - 1; i++) {
+		n += snprintf(msg + n, sizeof(msg) - n, i ? " %s" : "%s", iCboxArgs[i]);
+	    }
+	    warnD("\"%s\" I/Os are missing", msg);
+	}
+	free(iCboxArgs);
+    }
+    while (autoCnt > 0) {
+	autoRemove(autoMap[0].base);
+    }
+    free(boxName);
+    boxName = NULL;
+} /* autoVivify */
+
+/********************************************************************
+ *
+ *	Auxiliary routine for printTables()
+ *	Append registered Receivers
+ *
+ *******************************************************************/
+
+static void
+printTail(Recv * rp, int ch)
+{
+    int		i;
+
+    if (rp->cnt == 0) {
+	printf("<no receivers>");
+    }
+    for (i = 0; i < rp->cnt; i++) {
+	printf("%s%s\t%s", i ? "\t" : "", rp->cons[i]->name ? rp->cons[i]->name : "<undef>", rp->names[i]);
+    }
+    printf("%s\n", chans[ch].cd ? "\t[iClive]" : "");
+} /* printTail */
+
+/********************************************************************
+ *
+ *	Print tables of clientNames
+ *	Print table of equivalences if any are defined
+ *	Print table of registered Senders and Receivers
+ *
+ *******************************************************************/
+
+static void
+printTables(void)
+{
+    char **	list;
+    int		cnt = 0;
+    int		fd, i, j, h;
+    Equiv *	ep;
+    Name *	np;
+    Conn *	c;
+
+    printf("%s: Table of clientNames and registered Senders and Receivers\n", named);
+    list = emalloc((connSize + 1) * sizeof(char *));
+    for (fd = 0; fd < connSize; fd++) {
+	if ((c = conns[fd]) != NULL && c->name) {
+	    list[cnt] = emalloc(strlen(c->name) + 16);
+	    sprintf(list[cnt++], "%s%s", c->name, c->name[0] == '-' ? "\t[iClive]" : c->app);
+	}
+    }
+    qsort(list, cnt, sizeof(char *), strOrder);
+    for (i = 0; i < cnt; i++) {
+	printf("%s\n", list[i]);
+	free(list[i]);
+    }
+    free(list);
+    if (equivalences) {
+	printf("\nequivalences = {\n");
+	for (cnt = 0, ep = equivalences; ep; ep = ep->next) cnt++;
+	list = emalloc(cnt * sizeof(char *));
+	for (i = 0, ep = equivalences; ep; ep = ep->next) list[i++] = ep->base;
+	qsort(list, cnt, sizeof(char *), iCboxOrder);
+	for (i = 0; i < cnt; i++) {
+	    ep = equivGet(list[i]);
+	    printf("%-6s => [\n", ep->base);
+	    for (j = 0; j < ep->cnt; j++) {
+		EqGroup *	gp = ep->groups[j];
+		char **		insts = emalloc(gp->cnt * sizeof(char *));
+		int		k;
+		printf("    [ %d, {", gp->channel);
+		for (k = 0; k < gp->cnt; k++) insts[k] = gp->insts[k].inst;
+		qsort(insts, gp->cnt, sizeof(char *), strOrder);
+		for (k = 0; k < gp->cnt; k++) {
+		    printf(" \"%s\" => %s,", insts[k], instFind(gp, insts[k])->name);
+		}
+		printf(" } ],\n");
+		free(insts);
+	    }
+	    printf("],\n");
+	}
+	printf("}\n");
+	free(list);
+	for (cnt = 0, h = 0; h < NSIZ; h++) {
+	    for (np = names[h]; np; np = np->next) if (np->base) cnt++;
+	}
+	list = emalloc(cnt * sizeof(char *));
+	for (i = 0, h = 0; h < NSIZ; h++) {
+	    for (np = names[h]; np; np = np->next) if (np->base) list[i++] = np->name;
+	}
+	qsort(list, cnt, sizeof(char *), iCboxOrder);
+	printf("\nequivBase\tchannels\nname\tbase\tprimCh\tsecCh\tch\n");
+	for (i = 0; i < cnt; i++) {
+	    np = lookup(list[i], 0);
+	    printf("%s\t%s\t%d\t%d\t%d\n", np->name, np->base, np->primCh, np->secCh, np->channel);
+	}
+	free(list);
+    }
+    printf("\nch  Sender          name            value       Recv[0]\tname[0]\tRecv[1]\tname[1]\t...\n");
+    for (i = 0; i <= maxChannel && i < chanSize; i++) {
+	Channel *	cp = &chans[i];
+	if (cp->sender || cp->recv.cnt > 0) {
+	    printf("%-3d %-15s %-15s %-11s ", i,
+		cp->sender && cp->sender->name ? cp->sender->name : "<no sender>",
+		cp->senderName ? cp->senderName : "", cp->value ? cp->value : "");
+	    printTail(&cp->recv, i);
+	}
+	for (j = 0; j < cp->altCnt; j++) {
+	    printf("    %-43d ", cp->alt[j].secCh);	/* secondary channel */
+	    printTail(&cp->alt[j].r, i);
+	}
+    }
+    fflush(stdout);
+} /* printTables */
+
+/********************************************************************
+ *
+ *	Store the current value of a channel
+ *
+ *******************************************************************/
+
+static void
+setValue(Channel * cp, const char * val, int len)
+{
+    if (len + 1 > cp->valSize) {
+	cp->valSize = len + 16;
+	cp->value = realloc(cp->value, cp->valSize);	/* initially NULL */
+	assert(cp->value);
+    }
+    memcpy(cp->value, val, len);
+    cp->value[len] = '\0';
+} /* setValue */
+
+/********************************************************************
+ *
+ *	Disconnect a client
+ *
+ *	clear 'sender' for all channels at this connection
+ *	splice out all receiver entries with this connection
+ *	as well as similar entries in the alternate receivers
+ *
+ *******************************************************************/
+
+static void
+disconnect(Conn * c)
+{
+    int		channel, i, j;
+    char	msg[32];
+    const char *	name = c->name ? c->name : "<undef>";
+
+    c->dead = 1;				/* close after current events */
+    msgSeq++;					/* resets go in their own frames */
+    if (c->name && !opt_q) printf("S%d: %s: disconnecting now\n", c->id, c->name);
+    for (channel = 0; channel <= maxChannel && channel < chanSize; channel++) {
+	Channel *	cp = &chans[channel];
+	int		rflag = 0;
+	if (cp->sender == c) {
+	    cp->sender = NULL;			/* no need to splice out only array entry */
+	    if (opt_r && cp->value && strcmp(cp->value, "0") != 0) {
+		rflag = 1;
+		setValue(cp, "0", 1);		/* reset sender value */
+	    }
+	    if (opt_t) printf("S%d: %s: S %s\t%d nil\n", c->id, name, cp->senderName, channel);
+	}
+	if (rflag) {
+	    /* scan once, resetting receivers, before splicing out any array elements */
+	    for (i = 0; i < cp->recv.cnt; i++) {
+		if (cp->recv.cons[i] != c) {
+		    pushReceiverData(cp->recv.cons[i], msg, snprintf(msg, sizeof(msg), "%d:0", channel));
+		}
+	    }
+	    for (j = 0; j < cp->altCnt; j++) {
+		for (i = 0; i < cp->alt[j].r.cnt; i++) {
+		    pushReceiverData(cp->alt[j].r.cons[i], msg, snprintf(msg, sizeof(msg), "%d:0", cp->alt[j].secCh));
+		}
+	    }
+	}
+	for (i = 0; i < cp->recv.cnt; i++) {
+	    if (cp->recv.cons[i] == c) {
+		Name *	np = lookup(cp->recv.names[i], 0);
+		if (np && np->base) {
+		    np->secCh = 0;		/* clear secondary channel to flag no registration */
+		}
+		if (opt_t) printf("S%d: %s: R %s\t%d spliced out\n", c->id, name, cp->recv.names[i], channel);
+		recvSplice(&cp->recv, i--);	/* splice out connection and name */
+	    }
+	}
+	for (j = 0; j < cp->altCnt; j++) {
+	    Recv *	rp = &cp->alt[j].r;
+	    for (i = 0; i < rp->cnt; i++) {
+		if (rp->cons[i] == c) {
+		    Name *	np = lookup(rp->names[i], 0);
+		    if (np && np->base) {
+			np->secCh = 0;		/* clear secondary channel to flag no registration */
+		    }
+		    if (opt_t) printf("S%d: %s: R %s\t%d spliced out\n", c->id, name, rp->names[i], cp->alt[j].secCh);
+		    recvSplice(rp, i--);
+		}
+	    }
+	    if (rp->cnt == 0) {		/* group has no connections left, only alternate channel */
+		if (opt_t) printf("S%d: altRecvCons[%d] group %d spliced out\n", c->id, channel, j);
+		free(rp->cons);
+		free(rp->names);
+		cp->altCnt--;
+		memmove(&cp->alt[j], &cp->alt[j+1], (cp->altCnt - j) * sizeof(AltRecv));
+		j--;				/* adjust index of next group to be spliced out */
+	    }
+	}
+    }
+    if (c->name == NULL) {
+	return;					/* client was not registered or has unregistered */
+    }
+    if (boxName && opt_t) printf("delete Autovivify entry 'AutoVivify[%s]'\n", c->name);
+    autoDelete(c->name);			/* ignored if already done */
+    if (!opt_q) printf("S%d: %s: disconnected\n", c->id, c->name);
+    free(c->name);
+    c->name = NULL;
+    if (--numberOfConnections <= 0) {
+	int	h;
+	Name *	np;
+	Equiv *	ep;
+	/********************************************************************
+	 *  This was last connection - clear all arrays and hashes
+	 *  this prevents channel numbers getting higher and higher
+	 *******************************************************************/
+	for (channel = 0; channel < chanSize; channel++) {
+	    Channel *	cp = &chans[channel];
+	    recvClear(&cp->recv);
+	    for (j = 0; j < cp->altCnt; j++) {
+		recvClear(&cp->alt[j].r);
+		free(cp->alt[j].r.cons);
+		free(cp->alt[j].r.names);
+	    }
+	    cp->altCnt = 0;
+	    cp->sender = NULL;
+	    free(cp->senderName);
+	    cp->senderName = NULL;
+	    if (cp->value) setValue(cp, "", 0);
+	    cp->cd = 0;
+	}
+	for (h = 0; h < NSIZ; h++) {
+	    for (np = names[h]; np; np = np->next) {
+		np->channel = 0;
+	    }
+	}
+	numberOfConnections = 0;
+	maxChannel = 0;
+	connCount = 0;
+	/********************************************************************
+	 *  Re-constitute channels of equivalence arguments.
+	 *  All secondary channels in equivBase[] have been set to 0
+	 *  so use equivalences[] to get secondary channels instead.
+	 *******************************************************************/
+	if (equivalences) {
+	    char **	list;
+	    int		cnt;
+	    for (cnt = 0, ep = equivalences; ep; ep = ep->next) cnt++;
+	    list = emalloc(cnt * sizeof(char *));
+	    for (i = 0, ep = equivalences; ep; ep = ep->next) list[i++] = ep->base;
+	    qsort(list, cnt, sizeof(char *), iCboxOrder);
+	    for (i = 0; i < cnt; i++) {
+		ep = equivGet(list[i]);
+		for (j = 0; j < ep->cnt; j++) {
+		    EqGroup *	gp = ep->groups[j];
+		    char **	insts = emalloc(gp->cnt * sizeof(char *));
+		    int		k;
+		    for (k = 0; k < gp->cnt; k++) insts[k] = gp->insts[k].inst;
+		    qsort(insts, gp->cnt, sizeof(char *), strOrder);
+		    for (k = 0; k < gp->cnt; k++) {
+			allocateChannel(instFind(gp, insts[k])->name, gp->channel);
+		    }
+		    free(insts);
+		}
+	    }
+	    free(list);
+	}
+	if (!opt_q) printf("S%d: last client has disconnected\n", c->id);
+    }
+} /* disconnect */
+
+/********************************************************************
+ *
+ *	Parse an IEC registration item  [SRsr]name[-inst][(bits)]
+ *	Terminates name in place and returns bits or "" - NULL if no match
+ *
+ *******************************************************************/
+
+static char *
+parseIec(char * name)
+{
+    char *	cp = name;
+    char *	bits;
+
+    while (isalnum((unsigned char)*cp) || *cp == '_' || *cp == '/' || *cp == '\\') cp++;
+    if (cp == name) return NULL;
+    if (*cp == '-') {
+	while (isdigit((unsigned char)*++cp));
+    }
+    if (*cp == '\0') return cp;		/* "" */
+    if (*cp != '(' || !isdigit((unsigned char)cp[1])) return NULL;
+    *cp++ = '\0';
+    bits = cp;
+    while (isdigit((unsigned char)*cp)) cp++;
+    if (cp[0] != ')' || cp[1] != '\0') return NULL;
+    *cp = '\0';
+    return bits;
+} /* parseIec */
+
+static int
+isIEC(const char * name, int iq)
+{
+    return name[0] == iq && strchr("XBWL", name[1]) && name[1] && isdigit((unsigned char)name[2]);
+} /* isIEC */
+
+/********************************************************************
+ *
+ *	Register a sender or receiver - returns ack or 0 for aborted
+ *
+ *******************************************************************/
+
+static int
+registerIO(Conn * c, int direction, char * name, const char * bits, char ** iniString, int * iniLen)
+{
+    int		channel, primCh, secCh, ack, i, j;
+    char	base[128];
+    Channel *	cp;
+    Name *	np;
+    const char *	sender = c->name ? c->name : "";
+
+    channel = allocateChannel(name, 0);
+    cp = &chans[channel];
+    if (name[0] == 'C' || name[0] == 'D') {
+	cp->cd = 1;
+    }
+    np = lookup(name, 0);
+    if (np->base) {
+	snprintf(base, sizeof(base), "%s", np->base);
+	primCh = np->primCh;
+	secCh = np->secCh;
+	if (secCh == 0) {
+	    np->secCh = channel;		/* assign secondary channel now to flag registration */
+	} else if (secCh != channel) {
+	    warnD("\"%s\" equivalenced channel %d not allocated channel %d ???", name, secCh, channel);
+	    return 0;
+	}
+    } else {
+	snprintf(base, sizeof(base), "%s", name);
+	primCh = channel;
+	secCh = 0;
+    }
+    ack = channel;				/* used to build acknowledge string */
+    if (opt_t) printf("S%d: register %c \"%s\" base = \"%s\" primCh = %d secCh = %d channel = %d ack = %d\n",
+	c->id, direction, name, base, primCh, secCh, channel, ack);
+    if (direction == 'S') {
+	if (primCh != channel) {
+	    /********************************************************************
+	     *  A client is trying to register a sender on a channel for
+	     *  an alternate equivalence group
+	     *******************************************************************/
+	    Name *	bp = lookup(base, 0);
+	    Equiv *	ep;
+	    if (bp && bp->secCh != 0) {		/* secondary channel of base name already registered */
+		warnD("\"%s\" trying to register S \"%s\" for alternative channel %d/%d - aborted", sender, name, primCh, channel);
+		return 0;
+	    }
+	    /********************************************************************
+	     *  Locate secondary group in equivalences[] and move it
+	     *  to the primary position - adjust equivBase[]
+	     *******************************************************************/
+	    if ((ep = equivGet(base)) != NULL) {
+		for (i = 0; i < ep->cnt; i++) {
+		    if (ep->groups[i]->channel == channel) {
+			EqGroup *	gp = ep->groups[i];
+			memmove(&ep->groups[1], &ep->groups[0], i * sizeof(EqGroup *));
+			ep->groups[0] = gp;
+			equivRebase(base, name);
+			rebasePrimary(primCh, name, channel);
+			break;
+		    }
+		}
+	    }
+	}
+	if (cp->sender) {
+	    /********************************************************************
+	     *  A client is trying to register a sender twice on the same
+	     *  channel
+	     *******************************************************************/
+	    warnD("\"%s\" trying to register S \"%s\" for channel %d twice - aborted", sender, name, channel);
+	    return 0;
+	}
+	/********************************************************************
+	 *  Register a new Sender
+	 *  sends all registered receivers on the channel a 0 value
+	 *  (this also works for iClive - NOP)
+	 *******************************************************************/
+	cp->sender = c;
+	free(cp->senderName);
+	cp->senderName = estrdup(name);
+	setValue(cp, "0", 1);			/* default initial value */
+	for (i = 0; i < cp->recv.cnt; i++) {
+	    char	msg[32];
+	    pushReceiverData(cp->recv.cons[i], msg, snprintf(msg, sizeof(msg), "%d:0", channel));	/* reset receiver */
+	}
+	if (isIEC(name, 'Q')) {
+	    if (cp->recv.cnt == 0) {		/* no iCbox for this sender if it has receivers */
+		autoStart(sender);
+		autoAdd(name, bits);
+		if (opt_t) printf("S%d: Autovivify %s: sender %s\n", c->id, boxName, name);
+	    }
+	} else if (boxName && isIEC(name, 'I')) {
+	    autoDelete(name);			/* ignored if already done */
+	    if (opt_t) printf("S%d: Delete autovivify %s: sender %s\n", c->id, boxName, name);
+	}
+	if (opt_t) printf("S%d: \"%s\" S \"%s\"\tack = %d\n", c->id, sender, name, ack);
+    } else {
+	const char *	ini;
+	/********************************************************************
+	 *  ignore duplicate Receiver entries for this conn
+	 *******************************************************************/
+	if (primCh == channel) {
+	    for (i = 0; i < cp->recv.cnt; i++) {
+		if (cp->recv.cons[i] == c) {
+		    ack = -channel;		/* not an error in iCbox */
+		    warnD("register R \"%s\" for channel %d at \"%s\" twice", name, channel, sender);
+		}
+	    }
+	} else {
+	    Channel *	pp = &chans[primCh];
+	    for (j = 0; j < pp->altCnt; j++) {
+		for (i = 0; i < pp->alt[j].r.cnt; i++) {
+		    if (pp->alt[j].r.cons[i] == c) {
+			ack = -pp->alt[j].secCh;	/* not an error in iCbox */
+			warnD("register R \"%s\" for channel %d/%d at \"%s\" twice", name, primCh, pp->alt[j].secCh, sender);
+		    }
+		}
+	    }
+	}
+	ini = cp->value ? cp->value : "";	/* current value */
+	if (ack > 0) {
+	    if (primCh == channel) {
+		recvPush(&cp->recv, c, name);	/* simple R registration */
+	    } else {
+		Channel *	pp = &chans[primCh];
+		for (j = 0; j < pp->altCnt; j++) {
+		    if (pp->alt[j].secCh == channel) {
+			recvPush(&pp->alt[j].r, c, name);	/* extend alternate R registration group */
+			if (opt_t) printf("%02d: extend alternate R registration name = \"%s\" primCh = %d channel = %d\n",
+			    c->id, name, primCh, channel);
+			goto AltStored;
+		    }
+		}
+		/* new alternate R registration in group on a different channel */
+		recvPush(&altPush(pp, channel, 0)->r, c, name);
+		if (opt_t) printf("%02d: new    alternate R registration name = \"%s\" primCh = %d channel = %d\n",
+		    c->id, name, primCh, channel);
+	      AltStored: ;
+	    }
+	    /********************************************************************
+	     *  do not AutoVivify an iC box for this receiver if there is already
+	     *  a sender unless it is an extern Q... receiver (iC app)
+	     *******************************************************************/
+	    if (*c->app && isIEC(base, 'Q')) {
+		autoStart(sender);
+		autoAdd(base, bits);
+		if (opt_t) printf("S%d: Autovivify %s: receiver extern %s\n", c->id, boxName, base);
+	    } else {
+		if (chans[primCh].sender) {	/* is sender registered on primary channel ? */
+		    ini = chans[primCh].value;	/* yes - current value */
+		    if (strcmp(ini, "0") != 0) {
+			/********************************************************************
+			 *  sender is registered and has a current value different to 0
+			 *  send new receiver this value
+			 *******************************************************************/
+			int	len = strlen(ini) + 16;
+			*iniString = realloc(*iniString, *iniLen + len);	/* initially NULL */
+			assert(*iniString);
+			*iniLen += sprintf(*iniString + *iniLen, *iniLen ? ",%d:%s" : "%d:%s", channel, ini);
+		    }
+		} else if (isIEC(base, 'I')) {
+		    autoStart(sender);
+		    autoAdd(base, bits);
+		    if (opt_t) printf("S%d: Autovivify %s: receiver %s\n", c->id, boxName, base);
+		}
+		if (boxName && isIEC(base, 'Q')) {
+		    autoDelete(base);		/* ignored if already done */
+		    if (opt_t) printf("S%d: Delete autovivify %s: receiver %s\n", c->id, boxName, base);
+		}
+	    }
+	}
+	if (opt_t) printf("S%d: %s R %s\tack = %d\tini = \"%s\"\n", c->id, sender, name, ack, ini);
+    }
+    return ack;
+} /* registerIO */
+
+/********************************************************************
+ *
+ *	Handle one data message channel:value
+ *
+ *	Central function of server done at maximum speed.
+ *	Transmit message from a sender for a particular channel
+ *	to each receiver on that channel - most common case.
+ *	Transmit message to each receiver on equivalenced alternate
+ *	channels - this is very rare.
+ *
+ *******************************************************************/
+
+static void
+dataMsg(Conn * c, int channel, const char * msg, int len, const char * val)
+{
+    Channel *	cp;
+    int		i, j;
+    int		sendFlag = 0;
+
+    if (channel > maxChannel || channel >= chanSize) {
+	if (opt_t) printf("S%d: %s %.*s => dummy\n", c->id, c->name, len, msg);
+	return;
+    }
+    cp = &chans[channel];
+    setValue(cp, val, msg + len - val);		/* latest value in case lost connection */
+    for (i = 0; i < cp->recv.cnt; i++) {
+	pushReceiverData(cp->recv.cons[i], msg, len);	/* messages to receiver channels */
+	sendFlag = 1;
+    }
+    for (j = 0; j < cp->altCnt; j++) {
+	char	buf[REPLY];
+	int	n = snprintf(buf, sizeof(buf), "%d:%s", cp->alt[j].secCh, cp->value);
+	for (i = 0; i < cp->alt[j].r.cnt; i++) {
+	    pushReceiverData(cp->alt[j].r.cons[i], buf, n);	/* message to alternate channels */
+	    sendFlag = 1;
+	}
+    }
+    if (!sendFlag && opt_t) {
+	printf("S%d: %s %.*s => dummy\n", c->id, c->name, len, msg);
+    }
+} /* dataMsg */
+
+/********************************************************************
+ *
+ *	Handle one message from a client
+ *
+ *	message 'rbuf' has the following characteristics:
+ *	. zero length		client has signalled shutdown
+ *	. starts with BIN_FRAME	binary records - decode into text pairs
+ *	. comma separated list	break up into individual items 'msg'
+ *	  each item 'msg' has the following characteristics:
+ *	  . matches /^\d+:.+$/	  split into channel and value, send
+ *				  value to all receivers for the channel
+ *	  . matches /^[NnSsRrBZ]/ registration item
+ *	  . matches /^E.*$/	  equivalance message from an app
+ *	  . matches /^[XT]/	  special actions
+ *	  . equals ''		  ignore empty message before leading comma
+ *	  . else eror
+ *
+ *******************************************************************/
+
+static void
+handleMessage(Conn * c, char * rbuf, int len)
+{
+    char	wbuf[REPLY+1];			/* acknowledge string */
+    int		wlen = 0;
+    char *	iniString = NULL;		/* initially NULL */
+    int		iniLen = 0;
+    char *	msg;
+    char *	ep;
+    char *	cp;
+
+    msgSeq++;					/* pairs from this message share frames */
+    if (opt_m) {
+	struct timeval	t1;
+	gettimeofday(&t1, NULL);
+	printf(opt_t ? "S %f: " : "S %f\n", (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec) / 1e6);
+    }
+    if (len == 0) {
+	/********************************************************************
+	 *  Client has signalled shutdown - disconnect client
+	 *******************************************************************/
+	disconnect(c);
+	return;
+    }
+    if (*rbuf == BIN_FRAME) {
+	if ((rbuf = decodeFrame(rbuf, len)) == NULL) {
+	    warnD("truncated binary frame from \"%s\" - ignored", c->name);
+	    return;
+	}
+	len = strlen(rbuf);
+    }
+    rbuf[len] = '\0';
+    if (opt_t && isdigit((unsigned char)*rbuf)) {
+	int	ch = atoi(rbuf);
+	if (ch > maxChannel || !chans[ch].cd) {
+	    printf("S%d: %s < %s\n", c->id, rbuf, c->name);
+	}
+    }
+    for (msg = rbuf; msg && !c->dead; msg = ep ? ep + 1 : NULL) {
+	if ((ep = strchr(msg, ',')) != NULL) {
+	    *ep = '\0';				/* split at ',' */
+	}
+	if (isdigit((unsigned char)*msg)) {
+	    int	channel = strtol(msg, &cp, 10);
+	    if (*cp == ':') {
+		if (!c->regFlag) {
+		    warnD("data \"%s\" during registration - app spec error", msg);
+		    continue;
+		}
+		/********************************************************************
+		 *  Allow message to be received from any connection, not just
+		 *  from the sender. This allows apps to re-transmit received
+		 *  messages for debugging
+		 *******************************************************************/
+		dataMsg(c, channel, msg, (ep ? ep : msg + strlen(msg)) - msg, cp + 1);
+		continue;
+	    }
+	}
+	switch (*msg) {
+	case 'N':
+	    if (msg[1] && strchr(msg + 1, '.') == NULL) {
+		c->app = "";
+	    } else if ((cp = strchr(msg + 1, '.')) != NULL && cp > msg + 1 && strcmp(cp, ".ic") == 0) {
+		*cp = '\0';
+		c->app = "\t[iC app]";
+	    } else {
+		goto strange;
+	    }
+	    {
+		char *	name = msg + 1;
+		char	dname[128];
+		Conn *	con;
+		int	i;
+		if (*name == '-') {		/* -bar is name of iClive session for program bar */
+		    for (i = 0; i < chans[0].recv.cnt; i++) {
+			if (chans[0].recv.cons[i] == c) {
+			    free(chans[0].recv.names[i]);
+			    chans[0].recv.names[i] = estrdup(name);	/* name has changed in old warning registration */
+			    goto ALREADY_REGISTERED;
+			}
+		    }
+		    recvPush(&chans[0].recv, c, name);	/* new warning registration */
+		} else if ((con = clientCon(name)) != NULL) {
+		    /********************************************************************
+		     *  a client with the same name was previously registered
+		     *******************************************************************/
+		    if (!opt_k) {
+			/********************************************************************
+			 *  kill the new client and report error
+			 *******************************************************************/
+			warnD("trying to register client \"%s\" twice - aborted", name);
+			c->dead = 1;		/* new client was not registered yet */
+			goto done;
+		    }
+		    /********************************************************************
+		     *  -k option: unregister and disconnect previous instance
+		     *  proceed with new registration
+		     *******************************************************************/
+		    disconnect(con);		/* kills old client process */
+		    snprintf(dname, sizeof(dname), "D%s", name);
+		    if ((i = channelOf(dname)) != 0) {
+			iniString = realloc(iniString, 32);	/* initially NULL */
+			assert(iniString);
+			iniLen = snprintf(iniString, 32, "%d:1", i);	/* get S.T. from new client */
+		    }
+		}
+	      ALREADY_REGISTERED:
+		free(c->name);
+		c->name = estrdup(name);	/* name may change for iClive connections */
+		numberOfConnections++;
+		if (!opt_q) printf("S%d: %s: client registering now\n", c->id, c->name);
+	    }
+	    break;
+	case 'S':
+	case 'R':
+	    {
+		char *	bits = parseIec(msg + 1);
+		int	ack;
+		if (bits == NULL) goto strange;
+		if ((ack = registerIO(c, *msg, msg + 1, bits, &iniString, &iniLen)) == 0) {
+		    /* client registration terminated */
+		    disconnect(c);
+		    wlen = 0;
+		    goto done;
+		}
+		if (wlen < REPLY - 12) {
+		    wlen += sprintf(wbuf + wlen, wlen ? ",%d" : "%d", ack);
+		}
+	    }
+	    break;
+	case 'B':
+	    if (msg[1] != '\0') goto strange;
+	    c->binary = 1;			/* client requests binary channel data frames */
+	    break;
+	case 'M':
+	    if (msg[1] == '\0') goto strange;
+	    shmOpen(c, msg + 1);		/* client on this host offers shared memory */
+	    break;
+	case 'Z':
+	    if (msg[1] != '\0') goto strange;
+	    if (wlen == 0) {
+		wlen = sprintf(wbuf, "-0");	/* send a null acknowledgment */
+	    }
+	    if (c->binary) {
+		wlen += sprintf(wbuf + wlen, ",B");	/* acknowledge binary channel data frames */
+	    }
+	    if (c->shm) {
+		wlen += sprintf(wbuf + wlen, ",M");	/* acknowledge shared memory - must be last */
+	    }
+	    c->regFlag = 1;			/* client has registered */
+	    break;
+	case 'n':
+	    if (msg[1] == '\0') goto strange;
+	    if (c->name) {
+		if (!opt_q) printf("S%d: %s: client unregistering now\n", c->id, c->name);
+		free(c->name);
+		c->name = NULL;
+		numberOfConnections--;
+	    } else {
+		/********************************************************************
+		 *  no client with this name was previously registered
+		 *******************************************************************/
+		warnD("no client with n \"%s\" was previously registered", msg + 1);
+	    }
+	    c->regFlag = 0;			/* client has deregistered (iClive only) */
+	    break;
+	case 's':
+	case 'r':
+	    {
+		int	channel, i;
+		Channel *	cpp;
+		if (parseIec(msg + 1) == NULL) goto strange;	/* ignore bits */
+		if ((channel = channelOf(msg + 1)) == 0) {
+		    warnD("\"%s\" trying to unregister \"%s\" not previously registered - aborted", c->name, msg + 1);
+		    break;
+		}
+		cpp = &chans[channel];
+		if (*msg == 's') {
+		    /********************************************************************
+		     *  Unregister a previously registered Sender
+		     *******************************************************************/
+		    if (cpp->sender == c) {
+			cpp->sender = NULL;	/* no need to splice out only array entry */
+			if (opt_t) printf("S%d: unregister sender   %s\n", c->id, msg + 1);
+		    } else {
+			warnD("\"%s\" trying to unregister s '%s; not registered as sender - aborted", c->name, msg + 1);
+		    }
+		    setValue(cpp, "0", 1);	/* reset initial value */
+		} else {
+		    for (i = 0; i < cpp->recv.cnt; i++) {
+			if (cpp->recv.cons[i] == c) {
+			    if (opt_t) printf("S%d: unregister receiver %s\n", c->id, msg + 1);
+			    recvSplice(&cpp->recv, i);	/* splice out connection and name */
+			    break;
+			}
+		    }
+		}
+	    }
+	    break;
+	case 'E':
+	    if (msg[1] == '\0') goto strange;
+	    /* equivalences from an app are a comma separated list - use rest of message */
+	    if (ep) *ep = ',';
+	    if (opt_t) printf("S%d: Allocate equivs \"%s\"\n", c->id, msg + 1);
+	    allocateEquivalences(msg + 1);
+	    ep = NULL;
+	    break;
+	case 'T':
+	    if (msg[1] != '\0') goto strange;
+	    if (opt_t) printf("S%d: Print Tables\n", c->id);
+	    printTables();
+	    break;
+	case 'X':
+	    if (msg[1] == '\0') {
+		shutdownServer(0, "Stop from parent");
+	    } else {
+		char	buf[256];
+		snprintf(buf, sizeof(buf), "Stop from \"%s\" - stop %s", msg + 1, named);
+		shutdownServer(0, buf);
+	    }
+	    break;
+	case '\0':
+	    break;				/* ignore empty message before leading comma */
+	default:
+	  strange:
+	    printf("S%d: Warning strange message %s in %s ???\n", c->id, msg, rbuf);
+	    break;
+	}
+    }
+  done:
+    if (wlen > 0 && !c->dead) {
+	/********************************************************************
+	 *  Send partial or final registration acknowledge string
+	 *  Must be sent before any initialization data generated during
+	 *  registration
+	 *******************************************************************/
+	if (opt_t) printf("S%d: ACK: %s => %s\n", c->id, wbuf, c->name);
+	writeReceiverData();			/* data collected so far goes first */
+	sendText(c, wbuf);			/* registration acknowledgement */
+	if (c->shm && c->regFlag && !c->shmOn) {
+	    shmStart(c);			/* following messages use shared memory */
+	}
+	if (c->regFlag && iniString) {		/* defer ini until registration terminated */
+	    /* must be independent xmission, because different rcv call in client */
+	    if (opt_t) printf("S%d: INI: %s => %s\n", c->id, iniString, c->name);
+	    sendPairs(c, iniString, iniLen);	/* registration initialisation */
+	}
+    }
+    free(iniString);
+} /* handleMessage */
+
+/********************************************************************
+ *
+ *	Accept a new TCP connection
+ *
+ *******************************************************************/
+
+static void
+acceptConn(void)
+{
+    struct sockaddr_storage	addr;
+    socklen_t		addrLen = sizeof(addr);
+    struct epoll_event	ev;
+    int			fd;
+    int			on = 1;
+    Conn *		c;
+
+    if ((fd = accept(lfd, (SA)&addr, &addrLen)) < 0) {
+	if (errno == EINTR || errno == EAGAIN || errno == ECONNABORTED) return;
+	shutdownServer(3, strerror(errno));
+    }
+    if (unixPath == NULL) {
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));	/* disable Nagle's algorithm */
+    }
+    connsGrow(fd);
+    c = emalloc(sizeof(Conn));
+    c->fd = fd;
+    c->id = ++connCount;			/* identify this connection */
+    c->app = "";
+    conns[fd] = c;
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+	shutdownServer(3, strerror(errno));
+    }
+    if (!opt_q) {
+	if (unixPath) {
+	    printf("S%d: Connection %s at %s\n", c->id, opt_s, named);
+	} else {
+	    struct sockaddr_in *	ap = (struct sockaddr_in *)&addr;
+	    printf("S%d: Connection %s:%d at %s\n", c->id, inet_ntoa(ap->sin_addr), ntohs(ap->sin_port), named);
+	}
+    }
+} /* acceptConn */
+
+/********************************************************************
+ *
+ *	Receive all available data on a connection with one recv()
+ *	or from its shared memory ring if fromShm is set
+ *	and handle each complete message in the receive buffer.
+ *	Incomplete messages are kept until the rest arrives.
+ *
+ *******************************************************************/
+
+static void
+readConn(Conn * c, int fromShm)
+{
+    ssize_t	r;
+    int		len;
+    char *	data;
+    char	save;
+
+    if (c->head > 0 && c->head == c->tail) {
+	c->head = c->tail = 0;
+    }
+    if (c->inSize - c->tail < HSIZ + REPLY) {
+	if (c->head > 0) {
+	    memmove(c->in, c->in + c->head, c->tail - c->head);	/* keep partial message */
+	    c->tail -= c->head;
+	    c->head = 0;
+	}
+	if (c->inSize - c->tail < HSIZ + REPLY) {
+	    c->inSize = c->inSize ? c->inSize * 2 : HSIZ + FRAME + 1;
+	    c->in = realloc(c->in, c->inSize);	/* initially NULL */
+	    assert(c->in);
+	}
+    }
+    /* leave room for '\0' after the last message */
+    if (fromShm) {
+	r = shmRead(&c->shm->up, c->in + c->tail, c->inSize - c->tail - 1);
+    } else if ((r = recv(c->fd, c->in + c->tail, c->inSize - c->tail - 1, 0)) <= 0) {
+	if (r < 0 && (errno == EINTR || errno == EAGAIN)) return;
+	if (r < 0 && opt_t) printf("S%d: recv: %s\n", c->id, strerror(errno));
+	disconnect(c);				/* lost connection */
+	return;
+    }
+    c->tail += r;
+    while (!c->dead && c->tail - c->head >= HSIZ) {
+	unsigned char *	hp = (unsigned char *)c->in + c->head;
+	len = hp[0] << 24 | hp[1] << 16 | hp[2] << 8 | hp[3];
+	if (len < 0) {
+	    warnD("illegal message length %d from \"%s\" - disconnect", len, c->name);
+	    disconnect(c);
+	    return;
+	}
+	if (c->tail - c->head - HSIZ < len) {
+	    if (HSIZ + len + 1 > c->inSize) {
+		memmove(c->in, c->in + c->head, c->tail - c->head);
+		c->tail -= c->head;
+		c->head = 0;
+		c->inSize = HSIZ + len + 1;	/* grow for a message of any size */
+		c->in = realloc(c->in, c->inSize);
+		assert(c->in);
+	    }
+	    break;				/* wait for rest of message */
+	}
+	data = c->in + c->head + HSIZ;
+	c->head += HSIZ + len;
+	save = data[len];			/* first byte of next header */
+	handleMessage(c, data, len);
+	data[len] = save;
+    }
+} /* readConn */
+
+/********************************************************************
+ *
+ *	Doorbell from a client using shared memory - read until the
+ *	ring is empty, then announce waiting for the next doorbell
+ *
+ *******************************************************************/
+
+static void
+readShm(Conn * c)
+{
+    ShmRing *	rp = &c->shm->up;
+
+    if (shmDrain(c->bellIn) == 0) {
+	epoll_ctl(epfd, EPOLL_CTL_DEL, c->bellIn, NULL);	/* client has gone - socket reports it */
+    }
+    do {
+	while (!c->dead && shmAvail(rp) != 0) {
+	    readConn(c, 1);
+	}
+    } while (!c->dead && shmArm(rp) != 0);
+} /* readShm */
+
+/********************************************************************
+ *
+ *	Close connections which were disconnected
+ *
+ *******************************************************************/
+
+static void
+closeDead(void)
+{
+    int		fd;
+    Conn *	c;
+
+    for (fd = 0; fd < connSize; fd++) {
+	if ((c = conns[fd]) != NULL && c->dead && fd == c->fd) {
+	    if (c->shm) {
+		epoll_ctl(epfd, EPOLL_CTL_DEL, c->bellIn, NULL);
+		close(c->bellIn);
+		close(c->bellOut);
+		if (c->bellIn < connSize) conns[c->bellIn] = NULL;
+		munmap(c->shm, sizeof(ShmArea));
+	    }
+	    epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+	    close(fd);
+	    conns[fd] = NULL;
+	    free(c->name);
+	    free(c->in);
+	    free(c->out);
+	    free(c->ends);
+	    free(c);
+	}
+    }
+} /* closeDead */
+
+/********************************************************************
+ *
+ *	Keyboard input unless -z option
+ *
+ *******************************************************************/
+
+static void
+keyboardIn(void)
+{
+    char	buf[64];
+    int		n, i;
+
+    if ((n = read(0, buf, sizeof(buf))) <= 0) {
+	shutdownServer(0, "Stop from keyboard");	/* gracefull shutdown */
+    }
+    for (i = 0; i < n; i++) {
+	switch (buf[i]) {
+	case 'T':
+	    printTables();
+	    break;
+	case 'm':
+	    opt_m = !opt_m;			/* toggle -m option */
+	    break;
+	case 't':
+	    opt_t = !opt_t;			/* toggle -t option */
+	    break;
+	case 'q':
+	    shutdownServer(0, "Stop from keyboard");	/* gracefull shutdown */
+	}
+    }
+} /* keyboardIn */
+
+/********************************************************************
+ *
+ *	Quit program
+ *
+ *******************************************************************/
+
+static void
+shutdownServer(int ret, const char * message)
+{
+    if (ret != 0) {
+	fprintf(stderr, "%s\n", message);
+    } else if (!opt_q) {
+	printf("%s\n", message);
+    }
+    fflush(stdout);
+    if (unixPath) unlink(unixPath);		/* next iCserver can bind the same path */
+    exit(ret);
+} /* shutdownServer */
+
+static void
+sigHandler(int sig)
+{
+    sigFlag = sig;				/* handled in main loop */
+} /* sigHandler */
+
+/********************************************************************
+ *
+ *	Process command line arguments
+ *
+ *	Bundled flags -abc are interpreted as -a -b -c. Value flags may be
+ *	followed directly by their value -xVal or by -x Val.
+ *
+ *	The -f <include file> argument reads the include file, which is
+ *	trimmed of extraneous spaces and comments and produces another
+ *	list of command line arguments, which are processed recursively.
+ *
+ *	The first -R option starts a Bernstein chain. All further arguments
+ *	are saved in runArgs for the apps in the chain and -z is inserted
+ *	after the first app.
+ *
+ *******************************************************************/
+
+static void	processArgs(int argc, char ** argv);
+
+static void
+runPush(char * arg)
+{
+    if (runCnt + 1 >= runSize) {
+	runSize = runSize ? runSize * 2 : 16;
+	runArgs = realloc(runArgs, runSize * sizeof(char *));	/* initially NULL */
+	assert(runArgs);
+    }
+    runArgs[runCnt++] = arg;
+    runArgs[runCnt] = NULL;
+} /* runPush */
+
+static void
+readIniFile(const char * file)
+{
+    FILE *	fp;
+    char	line[1024];
+    char **	incArgs = NULL;			/* initially NULL */
+    int		incCnt = 0;
+
+    if ((fp = fopen(file, "r")) == NULL) {
+	shutdownServer(8, strerror(errno));
+    }
+    while (fgets(line, sizeof(line), fp)) {
+	char *	sp = line;
+	char *	dp = line;
+	char *	tp;
+	if ((tp = strchr(line, '#')) != NULL) *tp = '\0';	/* strip trailing comment */
+	while (*sp) {
+	    if (strchr("=:,;.", *sp)) {	/* remove spaces around separators */
+		while (dp > line && isspace((unsigned char)dp[-1])) dp--;
+		*dp++ = *sp++;
+		while (isspace((unsigned char)*sp)) sp++;
+	    } else {
+		*dp++ = *sp++;
+	    }
+	}
+	*dp = '\0';
+	for (tp = strtok(line, " \t\r\n"); tp; tp = strtok(NULL, " \t\r\n")) {
+	    incArgs = realloc(incArgs, (incCnt + 1) * sizeof(char *));
+	    assert(incArgs);
+	    incArgs[incCnt++] = estrdup(tp);	/* options may point into these strings */
+	}
+    }
+    fclose(fp);
+    if (incCnt > 0) {
+	processArgs(incCnt, incArgs);		/* recursive call to add options in include file */
+    }
+    free(incArgs);
+} /* readIniFile */
+
+static void
+processArgs(int argc, char ** argv)
+{
+    int		i;
+    char *	cp;
+    char *	val;
+
+    for (i = 0; i < argc; i++) {
+	if (Rflag) {
+	    if (strncmp(argv[i], "-R", 2) == 0 && argv[i][2]) {
+		runPush("-R");
+		runPush(argv[i] + 2);
+	    } else {
+		runPush(argv[i]);		/* arguments for apps in the Bernstein chain */
+	    }
+	    continue;
+	}
+	cp = argv[i];
+	if (*cp != '-' || cp[1] == '\0') {
+	    fprintf(stderr, "ERROR: unknown command line argument '%s'\n", cp);
+	    fprintf(stderr, usage, named, iC_PORT, named, named, RCS_Id);
+	    exit(1);
+	}
+	while (*++cp) {
+	    switch (*cp) {
+	    case 'a': opt_a = 1; break;
+	    case 'd': opt_d = 1; break;
+	    case 't': opt_t = 1; break;
+	    case 'm': opt_m = 1; break;
+	    case 'q': opt_q = 1; break;
+	    case 'r': opt_r = 1; break;
+	    case 'k': opt_k = 1; break;
+	    case 'z': opt_z = 1; break;
+	    case 's':
+	    case 'p':
+	    case 'e':
+	    case 'A':
+	    case 'f':
+	    case 'R':
+		if (cp[1]) {
+		    val = cp + 1;		/* value flag followed directly by value */
+		} else if (++i < argc) {
+		    val = argv[i];
+		} else {
+		    fprintf(stderr, "%s: value for final command line switch '-%c' missing\n", named, *cp);
+		    exit(1);
+		}
+		switch (*cp) {
+		case 's': opt_s = val; break;
+		case 'p': opt_p = val; break;
+		case 'A': opt_A = val; break;
+		case 'f': readIniFile(val); break;
+		case 'e':
+		    if (equivArgs) {
+			char *	ep = emalloc(strlen(equivArgs) + strlen(val) + 2);
+			sprintf(ep, "%s,%s", equivArgs, val);
+			free(equivArgs);
+			equivArgs = ep;
+		    } else {
+			equivArgs = estrdup(val);
+		    }
+		    break;
+		case 'R':
+		    Rflag = 1;
+		    runPush(val);
+		    runPush("-z");		/* insert -z after first -R <app> */
+		    break;
+		}
+		goto nextArg;
+	    case 'h':
+		fprintf(stderr, usage, named, iC_PORT, named, named, RCS_Id);
+		exit(0);
+	    default:
+		fprintf(stderr, "%s: unknown command line switch '-%c'\n", named, *cp);
+		fprintf(stderr, usage, named, iC_PORT, named, named, RCS_Id);
+		exit(1);
+	    }
+	}
+      nextArg: ;
+    }
+} /* processArgs */
+
+/********************************************************************
+ *
+ *	Listen on TCP/IP address opt_s and port opt_p
+ *
+ *******************************************************************/
+
+static void
+listenTcp(void)
+{
+    struct sockaddr_in	addr;
+    struct servent *	sp;
+    int			on = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    if (inet_aton(opt_s, &addr.sin_addr) == 0) {
+	struct hostent *	hp = gethostbyname(opt_s);
+	if (hp == NULL) shutdownServer(2, "unknown host");
+	memcpy(&addr.sin_addr, hp->h_addr, hp->h_length);
+    }
+    if (isdigit((unsigned char)*opt_p)) {
+	addr.sin_port = htons(atoi(opt_p));
+    } else if ((sp = getservbyname(opt_p, "tcp")) != NULL) {
+	addr.sin_port = sp->s_port;
+    } else {
+	shutdownServer(2, "unknown service port");
+    }
+    if ((lfd = socket(AF_INET, SOCK_STREAM, 0)) < 0 ||
+	setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0 ||
+	bind(lfd, (SA)&addr, sizeof(addr)) < 0 ||
+	listen(lfd, SOMAXCONN) < 0) {
+	shutdownServer(2, strerror(errno));
+    }
+} /* listenTcp */
+
+/********************************************************************
+ *
+ *	Listen on Unix domain socket 'path' given as -s unix:<path>
+ *
+ *	A path left over from an iCserver which crashed is removed.
+ *	A path on which another iCserver still accepts is not touched.
+ *
+ *******************************************************************/
+
+static void
+listenUnix(const char * path)
+{
+    struct sockaddr_un	addr;
+    int			fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+	shutdownServer(2, "Unix domain socket path too long");
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) >= 0) {
+	if (connect(fd, (SA)&addr, sizeof(addr)) == 0) {
+	    shutdownServer(2, strerror(EADDRINUSE));	/* do not unlink the other server's path */
+	}
+	close(fd);
+    }
+    unlink(path);				/* stale socket - no server listening */
+    if ((lfd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+	bind(lfd, (SA)&addr, sizeof(addr)) < 0) {
+	shutdownServer(2, strerror(errno));
+    }
+    unixPath = path;				/* bound - unlink in shutdownServer() */
+    if (listen(lfd, SOMAXCONN) < 0) {
+	shutdownServer(2, strerror(errno));
+    }
+} /* listenUnix */
+
+/********************************************************************
+ *
+ *	Main program
+ *
+ *	Create server by listening on the specified TCP port or Unix
+ *	domain socket and then accepting connections from different iC
+ *	clients.
+ *	All connections are handled by one epoll loop.
+ *
+ *******************************************************************/
+
+int
+main(int argc, char ** argv)
+{
+    struct epoll_event	ev;
+    struct epoll_event	events[EVENTS];
+    struct sigaction	sa;
+    char *		cp;
+    int			n, i, timeout;
+    Conn *		c;
+
+    named = (cp = strrchr(argv[0], '/')) != NULL ? cp + 1 : argv[0];
+    processArgs(argc - 1, argv + 1);
+    if (opt_A) {
+	opt_a = 1;
+	if (opt_d && (cp = strstr(opt_A, "iCbox")) != NULL && strncmp(cp + 5, " -d", 3) != 0) {
+	    char *	ap = emalloc(strlen(opt_A) + 4);
+	    sprintf(ap, "%.*s -d%s", (int)(cp + 5 - opt_A), opt_A, cp + 5);
+	    opt_A = ap;
+	}
+    } else if (opt_d) {
+	opt_a = 1;
+	opt_A = "iCbox -d";
+    } else {
+	opt_A = "iCbox";
+    }
+    if ((cp = strchr(opt_A, ' ')) != NULL && strncmp(cp, " -d", 3) == 0 && (cp[3] == '\0' || cp[3] == ' ')) {
+	opt_d = 1;				/* may be set with -A */
+    }
+    /********************************************************************
+     *  Prime ctrl-C interrupt and terminate signals
+     *******************************************************************/
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = sigHandler;			/* no SA_RESTART - interrupt epoll_wait() */
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);			/* write errors are reported */
+    signal(SIGCHLD, SIG_IGN);			/* autovivified iCbox and -R apps are not waited for */
+    growChannels(0);				/* channel 0 for iClive warnings */
+    /********************************************************************
+     *  Optionally allocate equivalences
+     *******************************************************************/
+    if (equivArgs) {
+	if (opt_t) printf("Allocate equivs '%s'\n", equivArgs);
+	allocateEquivalences(equivArgs);
+    }
+    /********************************************************************
+     *  Optionally start Bernstein chain of iC apps with -R option
+     *******************************************************************/
+    if (runCnt > 0) {
+	char **	args = emalloc((runCnt + 8) * sizeof(char *));
+	n = 0;
+	args[n++] = runArgs[0];
+	if (IS_UNIX(opt_s)) { args[n++] = "-s"; args[n++] = (char *)opt_s; }
+	if (strcmp(opt_p, iC_PORT) != 0) { args[n++] = "-p"; args[n++] = (char *)opt_p; }
+	if (opt_t) args[n++] = "-t";		/* insert -p <port> etc */
+	if (opt_m) args[n++] = "-m";
+	if (opt_q) args[n++] = "-q";
+	for (i = 1; i < runCnt; i++) {
+	    args[n++] = runArgs[i];
+	}
+	args[n] = NULL;
+	if (!opt_q) {
+	    printf("$");
+	    for (i = 0; i < n; i++) printf(" %s", args[i]);
+	    printf("\n");
+	}
+	fflush(stdout);
+	if (fork() == 0) {
+	    execvp(args[0], args);		/* execute first iC app of Bernstein chain */
+	    perror(args[0]);
+	    _exit(7);
+	}
+	free(args);
+    }
+    /********************************************************************
+     *  Launch server
+     *******************************************************************/
+    if (!opt_q) printf("%s created. Waiting for events\n", named);
+    if (IS_UNIX(opt_s)) {
+	listenUnix(opt_s + sizeof(UNIX_PREFIX) - 1);
+    } else {
+	listenTcp();
+    }
+    if ((epfd = epoll_create1(0)) < 0) {
+	shutdownServer(2, strerror(errno));
+    }
+    ev.events = EPOLLIN;
+    ev.data.fd = lfd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, lfd, &ev);
+    if (!opt_z) {
+	ev.data.fd = 0;				/* keyboard input */
+	epoll_ctl(epfd, EPOLL_CTL_ADD, 0, &ev);
+    }
+    fflush(stdout);
+    /********************************************************************
+     *  Handle events forever
+     *******************************************************************/
+    for (;;) {
+	timeout = -1;
+	if (boxName) {
+	    if ((timeout = autoDeadline - msNow()) <= 0) {
+		autoVivify();			/* no more registrations for AUTODELAY ms */
+		continue;
+	    }
+	}
+	if (opt_m) gettimeofday(&t0, NULL);
+	if ((n = epoll_wait(epfd, events, EVENTS, timeout)) < 0) {
+	    if (errno != EINTR) {
+		shutdownServer(11, strerror(errno));
+	    }
+	    if (sigFlag) {
+		char	buf[64];
+		snprintf(buf, sizeof(buf), "\nStopped by %s signal", sigFlag == SIGINT ? "interrupt" : "terminated");
+		shutdownServer(0, buf);
+	    }
+	    continue;
+	}
+	for (i = 0; i < n; i++) {
+	    int	fd = events[i].data.fd;
+	    if (fd == lfd) {
+		acceptConn();			/* accept a TCP connection */
+	    } else if (fd == 0) {
+		keyboardIn();
+	    } else if (fd < connSize && (c = conns[fd]) != NULL && !c->dead) {
+		if (fd == c->fd) {
+		    readConn(c, 0);		/* TCP/IP socket */
+		} else {
+		    readShm(c);			/* shared memory doorbell */
+		}
+	    }
+	}
+	writeReceiverData();			/* write data collected for different receivers */
+	closeDead();
+	fflush(stdout);
+    }
+} /* main */
+
+/*********** POD to generate man page *******************************
+
+=encoding utf8
+
+=head1 NAME
+
+iCserver - the central server for iC clients (C version)
+
+=head1 SYNOPSIS
+
+  cserver[ -qadrkztmh][ -s <host>|unix:<path>][ -p <port>]
+          [ -e <equivalences>][ -A <cmd>][ -f <file>]
+          [ -R <aux_app>[ <aux_argument> -R ...]] # must be last arguments
+
+The options and keyboard inputs are the same as for the Perl and
+Go versions of B<iCserver>.
+
+=head1 DESCRIPTION
+
+B<cserver> is a C implementation of B<iCserver> for Linux. Registration,
+equivalences, autovivification and all options behave exactly as in the
+Perl B<iCserver> and in B<goserver>, whose man pages describe them in
+detail. Any of the three programs can be installed as B<iCserver>.
+
+All client connections are handled in one process with epoll(7). Each
+connection has a receive buffer in which messages of any length are
+reassembled, so one recv() may deliver many messages. Channel:value
+pairs collected for one receiver while handling the messages from one
+recv() are sent to that receiver with a single writev(). The tables of
+senders and receivers are arrays indexed by channel, which are doubled
+when they fill up.
+
+Clients which register 'B' receive binary channel data frames and the
+messages for them are not limited in length. Long text messages for
+other clients are split, because their receive buffers have a fixed
+size of 1396 bytes.
+
+With -s unix:<path> B<cserver> listens on a Unix domain socket instead
+of a TCP/IP port and all clients must be started with the same -s
+option. The messages are the same. A stale <path> left by a server
+which crashed is removed; if another server still accepts on <path>
+B<cserver> stops. The path is removed again when B<cserver> stops.
+
+iC apps and I/O drivers connected to B<cserver> on the same host offer
+shared memory with the registration item 'M<name>'. B<cserver> maps the
+two rings in /dev/shm/<name> and acknowledges with ',M'. From then on
+all messages to and from that client are copied through the rings
+instead of the loopback socket; a named pipe for each direction wakes
+the reader only if it is waiting. The socket connection stays open and
+signals when the client disconnects. Clients on other hosts, and all
+clients of the Perl B<iCserver> and B<goserver>, use their socket as
+before.
+
+To compare the speed of the Perl, Go and C versions, run the same iC
+apps with each server in turn, optionally with the -m option, which
+displays the time between messages.
+
+=head1 AUTHOR
+
+John E. Wulff
+
+=head1 BUGS
+
+Email bug reports to B<immediateC@gmail.com> with L<iC Project> in the
+subject field.
+
+=head1 SEE ALSO
+
+L<iCserver(1)>, L<immcc(1)>, L<iCbox(1)>, L<iClive(1)>
+
+=head1 COPYRIGHT
+
+Copyright (C) 2000-2021  John E. Wulff
+
+You may distribute under the terms of either the GNU General Public
+License or the Artistic License, as specified in the README file.
+
+For more information about this program, or for information on how
+to contact the author, see the README file.
+
+=for ******* End of man page POD ***********************************/
@@ -139,7 +139,7 @@ sy_push(Symbol * var)			/* create List element for variable */
 {
     List_e *	lp;
 
-    lp = (List_e *) iC_emalloc(sizeof(List_e));
+    lp = new_le();
     lp->le_sym = var;			/* point to variables Symbol entry */
 #if YYDEBUG
     if ((iC_debug & 0402) == 0402) {
@@ -163,7 +163,7 @@ sy_pop(List_e * lp)			/* delete List element left over */
     Symbol *	sp;
 
     sp = lp ? lp->le_sym: NULL;		/* point to variables Symbol entry */
-    free(lp);
+    free_le(lp);
 #if YYDEBUG
     if ((iC_debug & 0402) == 0402) {
 	fprintf(iC_outFP, "sy_pop:   %s--\n", sp ? sp->name : "(null)");
@@ -187,14 +187,13 @@ atSymbol(void)
     char 	temp[TSIZE];
 #endif
 
-    sp = (Symbol *) iC_emalloc(sizeof(Symbol));
+    sp = new_sym();
     sp->name = NS;			/* no name at present */
     sp->fm |= FT;			/* marks temporary Symbol */
 #if YYDEBUG
     if ((iC_debug & 0402) == 0402) {	/* DEBUG name */
 	snprintf(temp, TSIZE, "@%d", ++tn);
-	sp->name = iC_emalloc(strlen(temp)+1);	/* +1 for '\0' */
-	strcpy(sp->name, temp);
+	sp->name = new_name(temp);
     }
 #endif
     return sp;				/* return pointer to new '@' Symbol */
@@ -291,12 +290,7 @@ freeTempSym(Symbol * sp)			/* free Symbol without popping link */
 	    }
 	    tsp->next = sp->next;		/* unlink sp from templist */
 	}
-#if YYDEBUG
-	if ((iC_debug & 0402) == 0402) {
-	    free(sp->name);			/* free name space */
-	}
-#endif
-	free(sp);				/* free Symbol */
+	free_sym(sp);				/* recycle Symbol - name is not freed */
     }
 } /* freeTempSym */
 
@@ -1126,13 +1120,12 @@ op_asgn(				/* assign List_e stack to links */
 
     if (sv == 0) {
 	/* null var - generate a temporary Symbol of type UNDEF */
-	var = (Symbol *) iC_emalloc(sizeof(Symbol));
+	var = new_sym();
 	do {
 	    /* do not use generated name used somewhere else already */
 	    snprintf(temp, TSIZE, "%s_f%d", iFunSymExt ? iFunBuffer : "", ++ttn);
 	} while (lookup(temp) != 0);
-	var->name = iC_emalloc(strlen(temp)+1);	/* +1 for '\0' */
-	strcpy(var->name, temp);	/* name needed for derived Sy's */
+	var->name = new_name(temp);	/* name needed for derived Sy's */
 	sflag = 0;			/* don't output name */
     } else {
 	var = sv->v;			/* Symbol * var */
@@ -1761,7 +1754,6 @@ op_asgn(				/* assign List_e stack to links */
 		    } else {
 			fprintf(iC_outFP, "\t  %s cleared\n", gp->name);
 		    }
-		    free(gp->name);			/* free name space "@x" */
 		}
 #endif
 		/********************************************************************
@@ -1771,8 +1763,7 @@ op_asgn(				/* assign List_e stack to links */
 		do {
 		    snprintf(temp, TSIZE, "%s_%d", var->name, ++atn);
 		} while (lookup(temp) != 0);
-		gp->name = iC_emalloc(strlen(temp)+1);	/* +1 for '\0' */
-		strcpy(gp->name, temp);			/* mark Symbol */
+		gp->name = new_name(temp);		/* mark Symbol */
 	    }
 	    if (iC_debug & 04) {
 		if (fflag && plp) {
@@ -2160,12 +2151,7 @@ op_asgn(				/* assign List_e stack to links */
      *******************************************************************/
     if (right->le_val == (NOT^NOT)) {
 	sy_pop(right);			/* right Symbol and List_e */
-#if YYDEBUG
-	if ((iC_debug & 0402) == 0402) {
-	    free(rsp->name);		/* free name space of @x */
-	}
-#endif
-	free(rsp);			/* free right Symbol */
+	free_sym(rsp);			/* recycle right Symbol */
     }
     /********************************************************************
      * A Symbol is marked by storing a pointer value in ->name
@@ -2197,8 +2183,7 @@ op_asgn(				/* assign List_e stack to links */
 		fflush(iC_outFP);
 	    }
     #endif
-	    free(var->name);		/* free name space */
-	    free(var);			/* temporary Symbol */
+	    free_sym(var);		/* temporary Symbol */
 	    var = 0;
 	}
     }
@@ -3402,7 +3387,6 @@ functionDefinition(Symbol * functionHead, List_e * fParams)
 	sp = lp->le_sym;			/* first varList Symbol */
 	while (sp) {				/* varList may be empty */
 	    assert((sp->fm & FM) == 0);		/* newly generated expression net Symbol */
-	    free(sp->name);			/* free name space generated for listing name */
 	    sp->name = 0;			/* mark the Symbol as function internal (no '@') */
 	    sp->list = 0;			/* clear internal Symbol pointers */
 	    sp = sp->next;			/* next varList Symbol */
@@ -3438,7 +3422,7 @@ functionDefinition(Symbol * functionHead, List_e * fParams)
 		ierror("trying to assign to a value parameter:", sp->name);
 		for (lp1 = sp->list; lp1; lp1 = vlp) {	/* has no follow ups - but just in case */
 		    vlp = lp1->le_next;		/* next expression link */
-		    free(lp1);			/* delete expression link */
+		    free_le(lp1);		/* delete expression link */
 		}
 		sp->list = 0;			/* clear pointer to real parameter */
 	    }
@@ -3667,52 +3651,50 @@ clearFunDef(Symbol * functionHead)
 		assert(vsp && vsp->list == 0);	/* call leaves link to real member cleared */
 		if (vsp->name) {		/* name was cleared if already unlinked */
 		    unlink_sym(vsp);		/* unlink formal member Symbol */
-		    if (d) free(vsp->name);	/* free name space */
 		    vsp->name = NULL;		/* no longer done in unlink_sym - jw 20141007 */
 		    vsp->next = clearList;
 		    clearList = vsp;
 		}
 		vlp = lp1->le_next;
-		if (d) free(lp1);		/* delete formal member link */
+		if (d) free_le(lp1);		/* delete formal member link */
 	    }
 	} else {
 	    lp = sp->u_blist;			/* cloned expression links */
 	    while (lp) {
 		lp1 = lp->le_next;		/* next expression link */
-		if (d) free(lp);		/* delete expression link */
+		if (d) free_le(lp);		/* delete expression link */
 		lp = lp1;
 	    }
 	    lp = sp->list;			/* possible link to function head */
 	    while (lp) {
 		lp1 = lp->le_next;		/* next expression link */
-		if (d) free(lp);		/* delete expression link */
+		if (d) free_le(lp);		/* delete expression link */
 		lp = lp1;			/* has no follow ups - but just in case */
 	    }
 	}
 	if (sp->name) {				/* name was cleared if already unlinked */
 	    unlink_sym(sp);			/* unlink formal statement head Symbol */
-	    if (d) free(sp->name);		/* free name space */
 	    sp->name = NULL;			/* no longer done in unlink_sym - jw 20141007 */
 	    sp->next = clearList;
 	    clearList = sp;
 	}
 	vlp = slp->le_next;			/* next varList link */
-	if (d) free(slp);			/* delete statement link */
+	if (d) free_le(slp);			/* delete statement link */
 	assert(vlp);				/* statement list is in pairs */
 	vsp = vlp->le_sym;			/* varList of temp Symbols */
 	while (vsp) {				/* varList may be empty */
 	    lp = vsp->u_blist;			/* cloned expression links */
 	    while (lp) {
 		lp1 = lp->le_next;		/* next expression link */
-		if (d) free(lp);		/* delete expression link */
+		if (d) free_le(lp);		/* delete expression link */
 		lp = lp1;
 	    }
 	    sp = vsp->next;			/* next varList Symbol */
-	    if (d) free(vsp);				/* delete varList Symbol which has no name */
+	    if (d) free_sym(vsp);			/* delete varList Symbol which has no name */
 	    vsp = sp;				/* and is not in the Symbol Table */
 	}
 	slp = vlp->le_next;			/* next statement link */
-	if (d) free(vlp);			/* delete varList link */
+	if (d) free_le(vlp);			/* delete varList link */
     }
     /********************************************************************
      * Pass 2: parameter list
@@ -3728,24 +3710,22 @@ clearFunDef(Symbol * functionHead)
 		assert(vsp && vsp->list == 0);	/* call leaves link to real member cleared */
 		if (vsp->name) {		/* name was cleared if already unlinked */
 		    unlink_sym(vsp);		/* unlink formal member Symbol */
-		    if (d) free(vsp->name);	/* free name space */
 		    vsp->name = NULL;		/* no longer done in unlink_sym - jw 20141007 */
 		    vsp->next = clearList;
 		    clearList = vsp;
 		}
 		vlp = lp1->le_next;
-		if (d) free(lp1);		/* delete formal member link */
+		if (d) free_le(lp1);		/* delete formal member link */
 	    }
 	}
 	if (sp->name) {				/* name was cleared if already unlinked */
 	    unlink_sym(sp);			/* unlink formal parameter Symbol */
-	    if (d) free(sp->name);		/* free name space */
 	    sp->name = NULL;			/* no longer done in unlink_sym - jw 20141007 */
 	    sp->next = clearList;
 	    clearList = sp;
 	}
 	vlp = slp->le_next;
-	if (d) free(slp);			/* delete formal parameter link */
+	if (d) free_le(slp);			/* delete formal parameter link */
 	slp = vlp;
     }
     /********************************************************************
@@ -3754,7 +3734,7 @@ clearFunDef(Symbol * functionHead)
      *******************************************************************/
     for (sp = clearList; sp; sp = clearList) {
 	clearList = sp->next;
-	if (d) free(sp);			/* free previously unlinked Symbol */
+	if (d) free_sym(sp);			/* free previously unlinked Symbol */
     }
     functionHead->u_blist = functionHead->list = 0;	/* clear for next definition */
     functionHead->v_cnt = instanceNum;		/* in case instances of old definition */
@@ -3890,7 +3870,7 @@ getRealParameter(Symbol * hsp, List_e * lp)
 
     assert(lp && lp->le_sym && lp->le_next == 0);
     if (hsp == 0) {
-	hsp = (Symbol *) iC_emalloc(sizeof(Symbol));
+	hsp = new_sym();
 	hsp->list = hsp->u_blist = lp;	/* first and only parameter so far */
 	prevFtype = 0;
     } else {
@@ -5393,16 +5373,7 @@ cloneFunction(Sym * fhs, Sym * hsym, Val * par)
     while (freelist) {
 	lp1 = freelist;
 	freelist = lp1->le_next;		/* before link is popped */
-#if YYDEBUG
-	sp1 = lp1->le_sym;
-	sy_pop(lp1);				/* free merge List_e */
-	if (sp1 && sp1->name) {
-	    free(sp1->name);			/* free name space */
-	}
-	free(sp1);				/* free merge Symbol */
-#else
-	free(sy_pop(lp1));			/* merge List_ and Symbol */
-#endif
+	free_sym(sy_pop(lp1));			/* merge List_ and Symbol */
     }
     free(iSav);					/* free memory - no need for size */
     functionHead->fm = fm;			/* restore original functionHead->fm */
@@ -37,6 +37,7 @@ import (
 	"strconv"
 	"strings"
 	"sync"
+	"sync/atomic"
 	"syscall"
 	"tcpcomm" // own package handling Perl type messages
 	"time"
@@ -45,6 +46,7 @@ import (
 
 const ID_goserver_go = "$Id: goserver.go 1.10 $"
 const TCP_PORT = "8778" // default TCP port for iC system
+const UNIX_PREFIX = "unix:" // -s unix:<path> listens on a Unix domain socket
 
 type eq struct {
 	channel int
@@ -60,7 +62,7 @@ type altRecv struct {
 	altCons  []net.Conn // slice of alternate receiver connections
 }
 
-var muConn sync.Mutex  // guard activity associated with one message in handleConnection()
+var muConn sync.Mutex  // guard the tables below - data messages use a copy in routes without it
 var muEquiv sync.Mutex // guard equivalences and equivBase modifications
 
 /********************************************************************
@@ -83,10 +85,10 @@ var equivBase = map[string]*eqB{}       // hashed by name - base name of equival
  *  increased in allocateChannel() where len and cap of all
  *  5 slices is doubled when maxLen >= cap(senderCon)
  *******************************************************************/
-var senderCon = make([]net.Conn, 16)      // indexed by channel ... sender connections      conn
-var senderName = make([]string, 16)       // indexed by channel ... sender names            name
-var senderValue = make([]string, 16)      // indexed by channel ... current sender values   value
-var receiverCons = make([][]net.Conn, 16) // indexed by channel ... primary channel receiver connections
+var senderCon = make([]net.Conn, 16)        // indexed by channel ... sender connections      conn
+var senderName = make([]string, 16)         // indexed by channel ... sender names            name
+var senderValue = make([]*atomic.Value, 16) // indexed by channel ... current sender values   value
+var receiverCons = make([][]net.Conn, 16)   // indexed by channel ... primary channel receiver connections
 // [conn1 conn2 conn3 ...]
 var receiverNames = make([][]string, 16) // indexed by channel ... primary channel receiver names
 // [name1 name2 name3 ...]
@@ -98,6 +100,221 @@ var altRecvNames = map[int][][]string{} // hashed by channel  ... receiver names
 // [[name4 name5 ...] [name6 name7 ...] ...]
 
 var goCount, numberOfConnections, maxChannel int
+var unixPath string // bound Unix domain socket - removed by shutdownServer()
+
+/********************************************************************
+ *  Routing table for data messages
+ *
+ *  Data messages are routed by routeData() without muConn from the
+ *  table last stored in 'routes'. A stored table is never changed.
+ *  Registrations, which change 'receiverCons' and 'altRecvCons', are
+ *  handled with muConn and publish a new copy with publishRoutes().
+ *  Only the sender value cells are shared by all copies, because
+ *  data messages update them.
+ *******************************************************************/
+type route struct {
+	cons  []net.Conn    // copy of receiverCons[channel]
+	alts  []altRecv     // copy of altRecvCons[channel]
+	value *atomic.Value // senderValue[channel] - same cell in all copies
+}
+
+var routes atomic.Value // []route indexed by channel
+
+/********************************************************************
+ *  A client connection with its own writer goroutine
+ *
+ *  Messages for a client from any goroutine are queued in 'out' with
+ *  their length header. The writer goroutine writes all messages
+ *  queued so far with one conn.Write(), so a burst for one receiver
+ *  from several senders costs one system call. Messages queued by one
+ *  goroutine are written in the order they were queued.
+ *******************************************************************/
+type client struct {
+	net.Conn
+	mu     sync.Mutex // guard out and closed
+	wmu    sync.Mutex // held while writing
+	out    []byte     // messages queued for writer()
+	closed bool       // no more messages are queued
+	kick   chan bool  // wake writer() - buffered 1
+	done   chan bool  // writer() has finished
+}
+
+var muClients sync.Mutex
+var allClients = map[*client]bool{} // flushed by shutdownServer()
+
+func newClient(conn net.Conn) *client {
+	c := &client{Conn: conn, kick: make(chan bool, 1), done: make(chan bool)}
+	muClients.Lock()
+	allClients[c] = true
+	muClients.Unlock()
+	go c.writer()
+	return c
+} // newClient
+
+/********************************************************************
+ *  Queue a message built in wbuf with 4 bytes room for the length
+ *******************************************************************/
+func (c *client) send(wbuf []byte) error {
+	if err := tcpcomm.Frame(&wbuf); err != nil {
+		return err
+	}
+	c.mu.Lock()
+	if !c.closed {
+		c.out = append(c.out, wbuf...)
+		select {
+		case c.kick <- true:
+		default: // writer() has been woken already
+		}
+	}
+	c.mu.Unlock()
+	return nil
+} // send
+
+func (c *client) writer() {
+	var buf []byte
+	for range c.kick {
+		c.wmu.Lock()
+		c.mu.Lock()
+		buf, c.out = c.out, buf[:0] // buf was written - reuse it for the next messages
+		c.mu.Unlock()
+		if len(buf) > 0 {
+			if _, err := c.Conn.Write(buf); err != nil {
+				shutdownServer(4, fmt.Sprint(err))
+			}
+		}
+		c.wmu.Unlock()
+	}
+	close(c.done)
+} // writer
+
+/********************************************************************
+ *  Write the messages still queued, stop writer() and close the
+ *  connection
+ *******************************************************************/
+func (c *client) close() {
+	c.mu.Lock()
+	c.closed = true
+	close(c.kick)
+	c.mu.Unlock()
+	<-c.done
+	muClients.Lock()
+	delete(allClients, c)
+	muClients.Unlock()
+	c.Conn.Close()
+} // close
+
+/********************************************************************
+ *  Write the messages still queued for all clients before exit
+ *******************************************************************/
+func flushClients() {
+	muClients.Lock()
+	for c := range allClients {
+		c.wmu.Lock() // wait for writer() - not unlocked, because process exits
+		c.mu.Lock()
+		c.Conn.Write(c.out)
+	}
+} // flushClients
+
+/********************************************************************
+ *
+ *	Current value of a channel - "" if it never had a sender
+ *
+ *******************************************************************/
+
+func getValue(channel int) string {
+	if v := senderValue[channel]; v != nil {
+		return v.Load().(string)
+	}
+	return ""
+} // getValue
+
+func setValue(channel int, value string) {
+	if senderValue[channel] == nil {
+		senderValue[channel] = new(atomic.Value) // called with muConn
+	}
+	senderValue[channel].Store(value)
+} // setValue
+
+/********************************************************************
+ *
+ *	Publish a new copy of the routing table - called with muConn
+ *
+ *******************************************************************/
+
+func publishRoutes() {
+	rt := make([]route, maxChannel+1)
+	for channel := range rt {
+		r := &rt[channel]
+		r.cons = append([]net.Conn(nil), receiverCons[channel]...)
+		for _, aref := range altRecvCons[channel] {
+			r.alts = append(r.alts, altRecv{aref.altsecCh, append([]net.Conn(nil), aref.altCons...)})
+		}
+		if senderValue[channel] == nil {
+			setValue(channel, "")
+		}
+		r.value = senderValue[channel]
+	}
+	routes.Store(rt)
+} // publishRoutes
+
+/********************************************************************
+ *
+ *	Split a message into data items channel:value
+ *	Return nil unless all items are data items
+ *
+ *******************************************************************/
+
+func dataItems(rbuf []byte) [][]string {
+	if len(rbuf) == 0 {
+		return nil // client has signalled shutdown
+	}
+	items := strings.Split(string(rbuf), ",")
+	ms := make([][]string, len(items))
+	for i, msg := range items {
+		if ms[i] = reData.FindStringSubmatch(msg); len(ms[i]) == 0 { // "^([0-9]+):(.*)$"
+			return nil
+		}
+	}
+	return ms
+} // dataItems
+
+/********************************************************************
+ *
+ *	Route a message consisting only of data items from a registered
+ *	client without muConn - the central function of the server.
+ *	Return false if the message must be handled with muConn.
+ *
+ *******************************************************************/
+
+func routeData(rbuf []byte) bool {
+	ms := dataItems(rbuf)
+	rt, _ := routes.Load().([]route)
+	if ms == nil {
+		return false
+	}
+	for _, m := range ms {
+		if channel, _ := strconv.Atoi(m[1]); channel >= len(rt) {
+			return false // not published yet
+		}
+	}
+	receiverData := map[net.Conn][]string{} // hashed by con
+	for _, m := range ms {
+		channel, _ := strconv.Atoi(m[1])
+		r := &rt[channel]
+		r.value.Store(m[2]) // latest value in case lost connection
+		for _, rconn := range r.cons {
+			receiverData[rconn] = append(receiverData[rconn], m[0]) //  messages to receiver channels
+		}
+		for _, aref := range r.alts {
+			msg := fmt.Sprintf("%d:%s", aref.altsecCh, m[2]) // message value
+			for _, rconn := range aref.altCons {
+				receiverData[rconn] = append(receiverData[rconn], msg) //  message to alternate channels
+			}
+		}
+	}
+	writeReceiverData(receiverData, 0) // no trace output - only used without -t and -m
+	return true
+} // routeData
 
 /********************************************************************
  *
@@ -126,7 +343,7 @@ func allocateChannel(name string, channel int) int {
 				 *******************************************************************/
 				senderCon = append(senderCon, make([]net.Conn, maxChannel)...)
 				senderName = append(senderName, make([]string, maxChannel)...)
-				senderValue = append(senderValue, make([]string, maxChannel)...)
+				senderValue = append(senderValue, make([]*atomic.Value, maxChannel)...)
 				receiverCons = append(receiverCons, make([][]net.Conn, maxChannel)...)
 				receiverNames = append(receiverNames, make([][]string, maxChannel)...)
 				if *opt_t {
@@ -494,7 +711,7 @@ func printTables() {
 			if chName = clientNames[con][0]; chName == "" {
 				chName = "<no sender>"
 			}
-			fmt.Printf("%-3d %-15s %-15s %-11s ", channel, chName, senderName[channel], senderValue[channel])
+			fmt.Printf("%-3d %-15s %-15s %-11s ", channel, chName, senderName[channel], getValue(channel))
 			nref := receiverNames[channel]
 			printTail(aref, nref, channel)
 		}
@@ -522,7 +739,7 @@ func writeReceiverData(receiverData map[net.Conn][]string, goId int) {
 				fmt.Printf("S%d: %s > %s\n", goId, wbuf[4:], clientNames[con][0])
 			}
 		}
-		err := tcpcomm.Write(con, &wbuf)
+		err := con.(*client).send(wbuf) // queue for writer goroutine of con
 		if err != nil {
 			fmt.Fprintf(os.Stderr, "S%d: msg = %q client = %q\n", goId, wbuf[4:], clientNames[con][0])
 			shutdownServer(4, fmt.Sprint(err))
@@ -553,9 +770,9 @@ func disconnect(name string, goId int) {
 			nam := clientNames[con][0]
 			if nam == name {
 				senderCon[channel] = nil // no need to splice out only array entry
-				if *opt_r && senderValue[channel] != "0" {
+				if *opt_r && getValue(channel) != "0" {
 					rflag = true
-					senderValue[channel] = "0" // reset sender value
+					setValue(channel, "0") // reset sender value
 				}
 				if *opt_t {
 					fmt.Printf("S%d: %s: S %s	%d nil\n", goId, name, senderName[channel], channel)
@@ -669,7 +886,7 @@ func disconnect(name string, goId int) {
 			clientNames = map[net.Conn][2]string{}
 			senderCon = make([]net.Conn, 16)
 			senderName = make([]string, 16)
-			senderValue = make([]string, 16)
+			senderValue = make([]*atomic.Value, 16)
 			receiverCons = make([][]net.Conn, 16)
 			receiverNames = make([][]string, 16)
 			altRecvCons = map[int][]altRecv{}
@@ -746,15 +963,25 @@ func warnD(warnMsg string) {
 
 func handleConnection(conn net.Conn) {
 	iCapp := ""
+	c := newClient(conn)
+	conn = c // all messages to this client are queued for its writer goroutine
 	muConn.Lock()
-	defer muConn.Unlock() // unlock when client disconnects
+	defer func() {
+		publishRoutes() // without this client
+		muConn.Unlock() // unlock when client disconnects
+	}()
 	goCount++
 	goId := goCount // identify this goroutine
 	if !*opt_q {
-		fmt.Printf("S%d: Connection %s at %s\n", goId, conn.RemoteAddr().String(), named)
+		if unixPath != "" {
+			fmt.Printf("S%d: Connection %s at %s\n", goId, *opt_s, named)
+		} else {
+			fmt.Printf("S%d: Connection %s at %s\n", goId, conn.RemoteAddr().String(), named)
+		}
 	}
-	defer conn.Close()
+	defer c.close()
 	var regFlag bool // initially false
+	publish := true  // registration may have changed the routing table
 	/********************************************************************
 	 *  Receive messages from clients
 	 *
@@ -780,9 +1007,21 @@ func handleConnection(conn net.Conn) {
 		if *opt_m {
 			t0 = time.Now()
 		}
+		if publish {
+			publishRoutes()
+		}
 		muConn.Unlock()
 		rbuf, err := tcpcomm.Read(conn) // Read message from client
+		/********************************************************************
+		 *  Messages with only data items from a registered client are
+		 *  routed without muConn, so goroutines for different clients
+		 *  route in parallel. Traces (-t and -m) need muConn for order.
+		 *******************************************************************/
+		for err == nil && regFlag && !*opt_t && !*opt_m && routeData(rbuf) {
+			rbuf, err = tcpcomm.Read(conn) // Read next message from client
+		}
 		muConn.Lock()
+		publish = !regFlag || dataItems(rbuf) == nil
 		if err != nil {
 			if err == io.EOF {
 				break
@@ -825,7 +1064,7 @@ func handleConnection(conn net.Conn) {
 				 *  This allows apps to re-transmit received messages for debugging
 				 *******************************************************************/
 				channel, _ := strconv.Atoi(m[1])
-				senderValue[channel] = m[2] // latest value in case lost connection
+				setValue(channel, m[2]) // latest value in case lost connection
 				sendFlag := false
 				/********************************************************************
 				 *  Central function of server done at maximum speed.
@@ -1003,7 +1242,7 @@ func handleConnection(conn net.Conn) {
 					 *******************************************************************/
 					senderCon[channel] = conn
 					senderName[channel] = name
-					senderValue[channel] = "0" // default initial value
+					setValue(channel, "0") // default initial value
 					flag := false
 					for _, rconn := range receiverCons[channel] {
 						receiverData[rconn] = append(receiverData[rconn], fmt.Sprintf("%d:0", channel)) //  reset receiver
@@ -1058,7 +1297,7 @@ func handleConnection(conn net.Conn) {
 							}
 						}
 					}
-					ini := senderValue[channel] // current value
+					ini := getValue(channel) // current value
 					if ack > 0 {
 						if primCh == channel {
 							receiverCons[channel] = append(receiverCons[channel], conn) // simple R registration
@@ -1112,7 +1351,7 @@ func handleConnection(conn net.Conn) {
 							}
 						} else {
 							if senderCon[primCh] != nil {	// is sender registered on primary channel ?
-								ini = senderValue[primCh];	// yes - current value
+								ini = getValue(primCh);	// yes - current value
 								if ini != "0" {
 									/********************************************************************
 									 *  sender is registered and has either initial value 0 or other
@@ -1201,7 +1440,7 @@ func handleConnection(conn net.Conn) {
 						warnD(fmt.Sprintf("%q trying to unregister s '%s; not registered as sender - aborted", sender, name))
 					}
 					// leave name
-					senderValue[channel] = "0" // reset initial value
+					setValue(channel, "0") // reset initial value
 				} else if direction == "r" {
 					/********************************************************************
 					 *  check that there are no Receiver entries with this conn
@@ -1229,6 +1468,8 @@ func handleConnection(conn net.Conn) {
 					fmt.Printf("S%d: Allocate equivs %q\n", goId, m[1])
 				}
 				allocateEquivalences(m[1])
+			} else if len(msg) > 1 && msg[0] == 'M' {
+				// client offers shared memory - not supported here, no ",M" in acknowledgment
 			} else if msg == "T" {
 				if *opt_t {
 					fmt.Printf("S%d: Print Tables\n", goId)
@@ -1253,7 +1494,7 @@ func handleConnection(conn net.Conn) {
 			if *opt_t {
 				fmt.Printf("S%d: ACK: %s => %s\n", goId, wbuf[4:], sender)
 			}
-			err = tcpcomm.Write(conn, &wbuf) // registration acknowledgement
+			err = c.send(wbuf) // registration acknowledgement
 			if err != nil {
 				shutdownServer(5, fmt.Sprint(err))
 			}
@@ -1265,7 +1506,7 @@ func handleConnection(conn net.Conn) {
 					} // registration initialization
 					wbuf = []byte{0, 0, 0, 0}                 // clear wbuf for this iteration
 					wbuf = append(wbuf, []byte(iniString)...) // build Perl type message
-					err = tcpcomm.Write(conn, &wbuf)
+					err = c.send(wbuf)
 					if err != nil {
 						shutdownServer(6, fmt.Sprint(err))
 					}
@@ -1356,6 +1597,9 @@ func autoVivBox(avArg string) {
 			}
 			iCboxFlags = append(iCboxFlags, iCboxCmd[1:]...)
 		}
+		if strings.HasPrefix(*opt_s, UNIX_PREFIX) {
+			iCboxFlags = append(iCboxFlags, "-s", *opt_s)
+		}
 		if *opt_p != TCP_PORT {
 			iCboxFlags = append(iCboxFlags, "-p", *opt_p)
 		}
@@ -1482,6 +1726,12 @@ func shutdownServer(ret int, message string) {
 	} else if !*opt_q {
 		fmt.Println(message)
 	}
+	if ret == 0 {
+		flushClients() // messages still queued - not after a write error
+	}
+	if unixPath != "" {
+		os.Remove(unixPath) // next iCserver can listen on the same path
+	}
 	os.Exit(ret)
 } // shutdownServer
 
@@ -1741,6 +1991,9 @@ separate process; -R ... must be last arguments`)
 	 *******************************************************************/
 	if len(runArgs) > 0 {
 		var runFlags = make([]string, 0, 5)
+		if strings.HasPrefix(*opt_s, UNIX_PREFIX) {
+			runFlags = append(runFlags, "-s", *opt_s)
+		}
 		if *opt_p != TCP_PORT {
 			runFlags = append(runFlags, "-p", *opt_p)
 		}
@@ -1787,10 +2040,22 @@ separate process; -R ... must be last arguments`)
 	if !*opt_q {
 		fmt.Printf("%s created. Waiting for events\n", named)
 	}
-	listen, err := net.Listen("tcp4", ipAdress)
+	network := "tcp4"
+	if strings.HasPrefix(*opt_s, UNIX_PREFIX) {
+		network, ipAdress = "unix", strings.TrimPrefix(*opt_s, UNIX_PREFIX)
+		if c, err := net.Dial(network, ipAdress); err == nil {
+			c.Close() // do not remove the path of another iCserver
+			shutdownServer(2, fmt.Sprintf("listen unix %s: address already in use", ipAdress))
+		}
+		os.Remove(ipAdress) // stale socket - no server listening
+	}
+	listen, err := net.Listen(network, ipAdress)
 	if err != nil {
 		shutdownServer(2, fmt.Sprint(err))
 	}
+	if network == "unix" {
+		unixPath = ipAdress
+	}
 	defer listen.Close()
 	/********************************************************************
 	 *  Accept TCP connections forever and handle communication in
@@ -1815,11 +2080,12 @@ iCserver - the central server for iC clients (Go version)
 
 =head1 SYNOPSIS
 
-  iCserver[ -qadrkztmh][ -s <host>][ -p <port>]
+  iCserver[ -qadrkztmh][ -s <host>|unix:<path>][ -p <port>]
           [ -e <equivalences>][ -A <cmd>][ -f <file>]
           [ -R <aux_app>[ <aux_argument> -R ...]] # must be last arguments
     -s host address of server - clients must specify the same address
             unless (default '0.0.0.0' which accepts any client host)
+            or unix:<path> to listen on a Unix domain socket (no port)
     -p port service port of server for all clients  (default '8778')
             make sure the Firewall is open for the TCP port used.
     -e equivalences  eg: -e IX0=IX0-1     (can be used more than once)
@@ -91,6 +91,14 @@
 #   Modification John Wulff 2018.06.03 - output rcv and send trace messages to STDERR
 #       rename package to iCmsg in file iCmsg.pm because of the many changes
 #
+#   Modification 2026.10.17 - Unix domain sockets
+#	A host given as unix:<path> connects to or listens on the Unix domain
+#	socket <path> instead of TCP/IP. The port is not used. The messages
+#	and their length headers are the same. TCP_NODELAY is only set for
+#	TCP/IP sockets. new_server() does not remove a path on which another
+#	server still accepts; a stale path is removed before binding and the
+#	bound path is removed again when the server exits.
+#
 ########################################################################
 
 package iCmsg;
@@ -134,9 +142,13 @@ sub connect {
     my ($sock);
     my $time_out = $time_out_inhibit ? 0 : 3;
 
-    # Create a new internet socket
+    # Create a new internet or Unix domain socket
     until (defined (
-        $sock = IO::Socket::INET->new (
+        $sock = $to_host =~ /^unix:(.+)/ ?
+        IO::Socket::UNIX->new (
+                                       Peer     => $1,
+                                       Type     => SOCK_STREAM) :
+        IO::Socket::INET->new (
                                        PeerAddr => $to_host,
                                        PeerPort => $to_port,
                                        Proto    => 'tcp',
@@ -149,7 +161,8 @@ sub connect {
 	sleep(2);			# wait 2 seconds for server to start
     }
 
-    setsockopt($sock, IPPROTO_TCP, TCP_NODELAY, $nagle) if defined $nagle;	# inhibit Nagle's algorithm
+    setsockopt($sock, IPPROTO_TCP, TCP_NODELAY, $nagle)
+	if defined $nagle and $sock->isa('IO::Socket::INET');	# inhibit Nagle's algorithm
     # Create a connection end-point object
     my $conn = bless {			# Reference to $conn{sock} and $conn{rcvd_notification_proc}
         sock                   => $sock,
@@ -305,16 +318,29 @@ sub handle_send_err {
 
 my ($g_login_proc,$g_pkg);
 my $main_socket = 0;
+my ($g_unix_path, $g_unix_pid);		# bound Unix domain socket and its server process
 sub new_server {
     @_ == 4 || die "iCmsg->new_server (myhost, myport, login_proc)\n";
     my ($pkg, $my_host, $my_port, $login_proc) = @_;
 
-    $main_socket = IO::Socket::INET->new (
+    if ($my_host =~ /^unix:(.+)/) {
+	my $path = $1;
+	die "Could not create socket: '$path' is in use by another server\n"
+	    if IO::Socket::UNIX->new (Peer => $path, Type => SOCK_STREAM);
+	unlink $path;			# stale socket - no server listening
+	$main_socket = IO::Socket::UNIX->new (
+                                          Local     => $path,
+                                          Listen    => 5,
+                                          Type      => SOCK_STREAM);
+	($g_unix_path, $g_unix_pid) = ($path, $$) if $main_socket;
+    } else {
+	$main_socket = IO::Socket::INET->new (
                                           LocalAddr => $my_host,
                                           LocalPort => $my_port,
                                           Listen    => 5,
                                           Proto     => 'tcp',
                                           Reuse     => 1);
+    }
     die "Could not create socket: $! \n" unless $main_socket;
     print STDERR "iCmsg.pm:new_server\n" if $trace_rcv or $trace_send;
     set_event_handler ($main_socket, "read" => \&_new_client);
@@ -407,13 +433,14 @@ sub _rcv {                     # Complement to _send
 
 sub _new_client {
     my $sock = $main_socket->accept();
-    setsockopt($sock, IPPROTO_TCP, TCP_NODELAY, $nagle) if defined $nagle;	# inhibit Nagle's algorithm
+    my $inet = $sock->isa('IO::Socket::INET');
+    setsockopt($sock, IPPROTO_TCP, TCP_NODELAY, $nagle) if defined $nagle and $inet;	# inhibit Nagle's algorithm
     my $conn = bless {			# Reference to $conn{sock} and $conn{state}
         'sock' =>  $sock,
         'state' => 'connected'
     }, $g_pkg;				# CLASSNAME $g_pkg from new_server
     my $rcvd_notification_proc =
-        &$g_login_proc ($conn, $sock->peerhost(), $sock->peerport());
+        &$g_login_proc ($conn, $inet ? ($sock->peerhost(), $sock->peerport()) : ("unix:$g_unix_path", undef));
     if ($rcvd_notification_proc) {
         $conn->{rcvd_notification_proc} = $rcvd_notification_proc;
         my $callback = sub {_rcv($conn,0)};
@@ -493,6 +520,11 @@ sub event_loop {
     }
 }
 
+END {
+    # remove the bound Unix domain socket - not in forked children
+    unlink $g_unix_path if defined $g_unix_path and $$ == $g_unix_pid;
+}
+
 1;
 
 __END__
@@ -66,6 +66,7 @@ static const char *	usage =
 "          [ [~]QXn[-QXm][+[<mask>]]:<pfa>[-<inst>] ...]\n"
 "          [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments\n"
 "    -s host IP address of server    (default '%s')\n"
+"            or unix:<path> of a local server's Unix domain socket\n"
 "    -p port service port of server  (default '%s')\n"
 "    -i inst instance of this client (default '') or 1 to %d digits\n"
 "            calling with alternate name \"iCpiGPIO\" has the same effect\n"
@@ -2021,6 +2022,7 @@ iCpiFace - real digital I/O on a Raspberry Pi for the iC environment
           [ [~]QXn[-QXm|+[<mask>]][:<pfa>][-<inst>] ...]
           [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments
     -s host IP address of server    (default '127.0.0.1127.0.0.1s')
+            or unix:<path> of a local server's Unix domain socket
     -p port service port of server  (default '8778')
     -i inst instance of this client (default '') or 1 to 3 digits
             calling with alternate name \"iCpiGPIO\" has the same effect
@@ -78,6 +78,7 @@ static const char *	usage =
 "          [ [~]QXn.<bit>,<gpio>[-<inst>] ...]      # at least 1 IEC argument\n"
 "          [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments\n"
 "    -s host IP address of server    (default '%s')\n"
+"            or unix:<path> of a local server's Unix domain socket\n"
 "    -p port service port of server  (default '%s')\n"
 "    -i inst instance of this client (default '') or 1 to %d digits\n"
 "    -B      start iCbox -d to monitor active GPIO I/O\n"
@@ -1876,6 +1877,7 @@ iCpiGPIO - real digital I/O on a Raspberry Pi for the iC environment
           [ [~]QXn.<bit>,<gpio>[-<inst>] ...]      # at least 1 IEC argument
           [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments
     -s host IP address of server    (default '127.0.0.1')
+            or unix:<path> of a local server's Unix domain socket
     -p port service port of server  (default '8778')
     -i inst instance of this client (default '') or 1 to 3 digits
     -B      start iCbox -d to monitor active GPIO I/O
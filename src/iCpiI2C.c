@@ -199,6 +199,7 @@ static const char *	usage =
 "          [ [~]QXcng-QXcng[,<mask>][-<inst>] ...]\n"
 "          [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments\n"
 "    -s host IP address of server    (default '%s')\n"
+"            or unix:<path> of a local server's Unix domain socket\n"
 "    -p port service port of server  (default '%s')\n"
 "    -i inst instance of this client (default '') or 1 to %d digits\n"
 "    -o offs offset for MCP GPIOA/GPIOB selection in a second iCpiI2C in the\n"
@@ -2285,6 +2286,7 @@ iCpiI2C - real I2C digital I/O on a Raspberry Pi for the iC environment
           [ [~]QXcng-QXcng[,<mask>][-<inst>] ...]
           [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments
     -s host IP address of server    (default '127.0.0.1')
+            or unix:<path> of a local server's Unix domain socket
     -p port service port of server  (default '8778')
     -i inst instance of this client (default '') or 1 to 3 digits
     -o offs offset for MCP GPIOA/GPIOB selection in a second iCpiI2C in the
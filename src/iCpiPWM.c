@@ -82,6 +82,7 @@ static const char *	usage =
 "         [ -r <time>][ -e <expf>][ -H <hyst>]\n"
 "         [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments\n"
 "    -s host IP address of server    (default '%s')\n"
+"            or unix:<path> of a local server's Unix domain socket\n"
 "    -p port service port of server  (default '%s')\n"
 "    -i inst instance of this client (default '') or 1 to %d digits\n"
 "    -B      start iCbox -d to monitor active analog I/O\n"
@@ -1342,6 +1343,7 @@ iCpiPWM - real PWM analog I/O on a Raspberry Pi for the iC environment
          [ -r <time>][ -e <expf>][ -H <hyst>]
          [ -R <aux_app>[ <aux_app_argument> ...]] # must be last arguments
     -s host IP address of server    (default '127.0.0.1')
+            or unix:<path> of a local server's Unix domain socket
     -p port service port of server  (default '8778')
     -i inst instance of this client (default '') or 1 to 3 digits
     -B      start iCbox -d to monitor active analog I/O
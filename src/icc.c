@@ -41,12 +41,13 @@ extern const char	iC_ID[];
 extern const char	iC_PATCH[];
 extern const char	iC_OPT[];
 unsigned short		iC_gflag = 0;		/* -g independent C code for gdb debugging */
+unsigned short		iC_Gflag = 0;		/* -G Gates in one static table in fan-out order */
 
 unsigned int		iC_uses = USE_STRICT | USE_LIST; /* 01=alias 02=strict 04=strict; strict and list is default */
 unsigned int		iC_useStack[USESTACKSZ];
 unsigned int		iC_useStackIndex = 0;
 
-unsigned short		iC_optimise = 07;	/* optimisation levels 0 - 7 */
+unsigned short		iC_optimise = 07;	/* optimisation levels 0 - 037 */
 
 static const char *	usage =
 "Usage:\n"
@@ -54,7 +55,7 @@ static const char *	usage =
 #if defined(RUN) || defined(TCP)
 "c"
 #endif	/* RUN or TCP */
-"agASpR"
+"agGASpR"
 #if !defined(RUN) && !defined(TCP)
 "v"
 #endif	/* not RUN and not TCP */
@@ -77,6 +78,8 @@ static const char *	usage =
 "        -e <err>        name of error file (default is stderr)\n"
 "        -L              compile with linking information in auxiliary files\n"
 "        -g              each expression has its own C code for debugging with gdb\n"
+"        -G              generate all Gates in one static table in fan-out order\n"
+"                        pre-sorted for loading (single module - not with -L)\n"
 "        -A              compile output ARITHMETIC ALIAS nodes for symbol debugging\n"
 "        -S              use strict - immediate variables must be declared (default)\n"
 "        -N              no strict - deprecated style - undeclared variables imm bit\n"
@@ -85,6 +88,8 @@ static const char *	usage =
 "        -R              no maximum error count (default: abort after 100 errors)\n"
 "        -O <level>      optimisation -O0 none -O1 bit -O2 arithmetic -O4 eliminate \n"
 "                        duplicate arithmetic expressions; -O7 all (default)\n"
+"                        -O10 merge identical AND and OR gates; -O20 fold constant\n"
+"                        and remove dead AND and OR gates; -O37 all of these\n"
 "        -D <macro>      predefine <macro> for the iC preprocessor phase\n"
 "        -U <macro>      cancel previous definition of <macro> for the iC phase\n"
 "                        Note: do not use the same macros for the iC and the C phase\n"
@@ -155,7 +160,7 @@ static const char *	usage =
 "Extra options for run mode: (direct interpretation)\n"
 " [-"
 #ifdef	TCP
-"l"
+"bjlr"
 #endif	/* TCP */
 #if YYDEBUG && !defined(_WINDOWS)
 "t"
@@ -170,7 +175,7 @@ static const char *	usage =
 "[ -n<count>"
 #ifdef TCP
 "][ -s <host>][ -p <port>][ -u <unitID>][ -i <instanceID>]\n"
-" [ -v <file.vcd>"
+" [ -v <file.vcd>][ -w <time>][ -y <time>"
 #endif	/* TCP */
 "]\n"
 "        -n <count>      maximum oscillator count (default is %d, limit 15)\n"
@@ -178,6 +183,7 @@ static const char *	usage =
 #ifdef TCP
 "        -l              start 'iClive' with correct source\n"
 "        -s host         IP address of iCserver           (default '%s')\n"
+"                        or unix:<path> of a local iCserver's Unix domain socket\n"
 "        -p port         service port of iCserver (not p) (default '%s')\n"
 "        -u unitID       of this client (default base name of <src.ic>)\n"
 "        -i instanceID   of this client (default '%s'; 1 to %d numeric digits)\n"
@@ -187,6 +193,11 @@ static const char *	usage =
 "                  only IEC inputs can be equivalenced (see iCserver)\n"
 "        -e I      equivalence all IEC input names to the same names-<inst>\n"
 "        -v <file.vcd>   output a .vcd and a .sav file for gtkwave\n"
+"        -b              exchange channel data with iCserver in binary frames\n"
+"        -j              send to iCserver from a separate sender thread\n"
+"        -r              receive from iCserver in a separate receive thread\n"
+"        -w <time>       input coalescing window eg: 200us 1ms (default off)\n"
+"        -y <time>       live data refresh period for iClive eg: 20ms (default off)\n"
 #endif	/* TCP */
 #if YYDEBUG && !defined(_WINDOWS)
 "        -d <debug>2000  display scan_cnt and link_cnt\n"
@@ -590,6 +601,31 @@ main(
 		    if (! *++*argv) { --argc; if(! *++argv) goto missing; }
 		    if (strlen(*argv)) iC_vcd = *argv; else goto missing;
 		    goto break2;	/* output vcd dump file for gtkwave */
+		case 'b':
+		    iC_opt_b = 1;	/* request binary channel data frames */
+		    break;
+		case 'j':
+		    iC_opt_j = 1;	/* separate sender thread */
+		    break;
+		case 'r':
+		    iC_opt_r = 1;	/* separate receive thread */
+		    break;
+		case 'w':
+		    if (! *++*argv) { --argc; if(! *++argv) goto missing; }
+		    if ((iC_opt_w = iC_usecs(*argv)) < 0) {
+			fprintf(iC_errFP, "ERROR: %s: '-w %s' is not a time up to 1s (eg 200us)\n",
+			    iC_progname, *argv);
+			goto error;
+		    }
+		    goto break2;	/* input coalescing window */
+		case 'y':
+		    if (! *++*argv) { --argc; if(! *++argv) goto missing; }
+		    if ((iC_opt_y = iC_usecs(*argv)) < 0) {
+			fprintf(iC_errFP, "ERROR: %s: '-y %s' is not a time up to 1s (eg 20ms)\n",
+			    iC_progname, *argv);
+			goto error;
+		    }
+		    goto break2;	/* live data refresh period */
 #if YYDEBUG && !defined(_WINDOWS)
 		case 'm':
 		    iC_micro++;		/* microsecond info */
@@ -839,11 +875,14 @@ main(
 		case 'g':
 		    iC_gflag = 1;		/* independent C code for gdb debugging */
 		    break;	/* allows setting breakpoints in C code in iC listings */
+		case 'G':
+		    iC_Gflag = 1;		/* Gates in one static table in fan-out order */
+		    break;
 		case 'O':
 		    if (! *++*argv) { --argc; if(! *++argv) goto missing; }
-		    if (sscanf(*argv, "%o%s", &debi, tempBuf) != 1 || debi > 07) {
+		    if (sscanf(*argv, "%o%s", &debi, tempBuf) != 1 || debi > 037) {
 			fprintf(iC_errFP,
-			    "%s: -O levels can only be 0 - 7 (7 is default)\n", iC_progname);
+			    "%s: -O levels can only be 0 - 37 (7 is default)\n", iC_progname);
 			goto error;
 		    }
 		    iC_optimise = debi;		/* short */
@@ -1079,6 +1118,10 @@ main(
 	goto error;
     }
 #endif	/* RUN */
+    if (iC_Gflag && iC_Lflag) {
+	fprintf(iC_errFP, "WARNING: %s: -G cannot be used with -L - ignore -G\n", iC_progname);
+	iC_Gflag = 0;			/* linked modules reference Gates by name */
+    }
     iFlag = 0;
     /********************************************************************
      *  Generate and open temporary files T1FN T2FN T3FN
@@ -1366,7 +1409,7 @@ immcc - the immediate-C to C compiler
 
 =head1 SYNOPSIS
 
- immcc [-agASRh][ -o<out>][ -l<lst>][ -e<err>][ -k<lim>][ -d<deb>]
+ immcc [-agGASRh][ -o<out>][ -l<lst>][ -e<err>][ -k<lim>][ -d<deb>]
        [ -O<level>][ -Dmacro[=defn]...][ -Umacro...]
        [ -Cmacro[=defn]...][ -Vmacro...][ -W[no-]<warn>...][ <src.ic>]
     -o <out> name of generated C output file
@@ -1375,6 +1418,8 @@ immcc - the immediate-C to C compiler
     -e <err> name of error file (default is stderr)
     -L       compile with linking information in auxiliary files
     -g       each expression has its own C code for debugging with gdb
+    -G       generate all Gates in one static table in fan-out order
+             pre-sorted for loading (single module - not with -L)
     -A       compile output ARITHMETIC ALIAS nodes for symbol debugging
     -S       use strict - immediate variables must be declared (default)
     -N       no strict - deprecated style - undeclared variables imm bit
@@ -128,6 +128,7 @@ static const char icc_h[] =
 typedef union GppIpI {
     struct Gate **	gpp;		/* Gate pointer array */
     struct Gate *	gp;		/* Gate pointer */
+    struct Wheel *	whp;		/* timing wheel of a timer */
     int		*	ip;		/* int array */
 #ifdef TCP
     unsigned short	channel;	/* output channel */
@@ -156,15 +157,20 @@ typedef struct Gate {			/* Gate */
 	struct Gate *	gt_next;	/* forward link */
 	unsigned short	gt_mark;	/* mark for stamping gate */
 	unsigned short	gt_live;	/* live flag and index */
-#ifdef DEQ
-	struct Gate *	gt_prev;	/* back link for double ended queue */
-#endif
 #if INT_MAX == 32767 && defined (LONG16)
 	long		gt_new;		/* new value for arithhmetic */
 	long		gt_old;		/* old value for arithhmetic */
 #else
 	int		gt_new;		/* new value for arithhmetic */
 	int		gt_old;		/* old value for arithhmetic */
+#endif
+	unsigned int	gt_lev   : 15;	/* logic level for levelized scan */
+	unsigned int	gt_dirty : 1;	/* ARN is on iC_arDirty list -A */
+#ifdef BLX
+	unsigned int	gt_idx   : 16;	/* index of back link in iC_blx[] */
+#endif
+#ifdef DEQ
+	struct Gate *	gt_prev;	/* back link for double ended queue */
 #endif
 } iC_Gt;
 
@@ -175,6 +181,8 @@ typedef struct Gate {			/* Gate */
 #define	gt_list		gt_ll.gpp
 				/* normal gate pointer */
 #define	gt_ptr		gt_ll.gp
+				/* timing wheel of TIMRL list head */
+#define	gt_wheel	gt_ll.whp
 #ifdef TCP
 				/* OUT channel for OUTW gates */
 #define	gt_channel	gt_ll.channel
@@ -614,6 +622,33 @@ extern unsigned short	iC_osc_max;
 extern unsigned short	iC_osc_lim;
 extern unsigned short	iC_osc_flag;
 
+					/*   link.c   */
+#define	LEV_LISTS	4		/* alist0 alist1 olist0 olist1 are levelized */
+#define	LEV_MAX		0x7fff		/* highest logic level held in gt_lev */
+extern unsigned short	iC_levMax;	/* highest logic level for levelized scan */
+extern Gate **		iC_levTail;	/* last Gate of each level in each levelized list */
+				/* list head gt_lev 1 - LEV_LISTS selects its set of level tails */
+#define	Lev_tail(ol,lev) iC_levTail[((ol)->gt_lev - 1) * (iC_levMax + 1) + (lev)]
+#ifdef BLX
+extern Gate **		iC_blx;		/* back link of each linked Gate indexed by gt_idx */
+				/* gt_idx 0 (list heads not in sTable) shares a dummy slot */
+#define	BLX_MAX		0xffff		/* highest index held in gt_idx - larger nets are reported */
+#define	Blx(gp)		iC_blx[(gp)->gt_idx]
+#endif
+
+					/*   rsff.c   */
+#define	WHL_BITS	8		/* 2 levels of 256 slots cover 65536 ticks */
+#define	WHL_SIZE	(1 << WHL_BITS)
+#define	WHL_MASK	(WHL_SIZE - 1)
+typedef struct Wheel {			/* hierarchical timing wheel of a TIMER */
+    unsigned short	wh_now;		/* ticks counted while timing */
+    unsigned short	wh_next;	/* tick of the earliest timed action */
+    unsigned short	wh_on;		/* 1 while timed actions are in the wheel */
+    Gate		wh_slot[2 * WHL_SIZE];	/* list heads level 0 (1 tick) and 1 (256 ticks) */
+} Wheel;
+				/* count of the head entry for iClive and VCD */
+#define	Wh_count(wh)	((wh)->wh_on ? (unsigned short)((wh)->wh_next - (wh)->wh_now) : 0)
+
 #define USE_ALIAS	(1<<0)
 #define USE_STRICT	(1<<1)
 #define USE_LIST	(1<<2)
@@ -642,7 +677,7 @@ extern unsigned short	iFlag;		/* inversion correction needed */
 extern int		iC_inversionCorrection(void);
 extern int		iC_maxIO;	/* I/O index limited to 64 or -1 no limit */
 extern unsigned char	iC_QX_[];	/* Output bit field slots */
-extern unsigned short	iC_optimise;	/* optimisation levels 0 - 7 */
+extern unsigned short	iC_optimise;	/* optimisation levels 0 - 037 */
 #if ! defined(TCP) && ! defined(LOAD)	/* OLD I/O */
 extern Gate *		iC_TX_[];	/* pointers to bit System Gates */
 extern Gate *		iC_IX_[];	/* pointers to bit Input Gates */
@@ -666,6 +701,27 @@ extern Gate *		iC_sList;	/* send bit and byte outputs */
 
 extern unsigned int	iC_bit2[];
 extern Gate *		iC_gx;		/* points to action Gate in chMbit and riMbit */
+extern Gate **		iC_arDirty;	/* ARN nodes to evaluate once per arithmetic pass -A */
+					/* bit parallel scan -X (alloc in load) */
+typedef struct BitTerm {		/* inputs of some lanes of a bit scan word */
+    int			bt_word;	/* index of the input word in iC_bsVal[] */
+    int			bt_rot;		/* rotate left to move the inputs to their lanes */
+    unsigned long	bt_mask;	/* lanes which take their input from this word */
+} BitTerm;
+#define	BS_BITS		(8 * (int)sizeof(unsigned long))	/* lanes per word */
+#define	BsRotl(x,r)	((x) << (r) | (x) >> ((BS_BITS - (r)) & (BS_BITS - 1)))
+extern int		iC_bsWords;	/* words of AND and OR Gates evaluated by iC_scan_bs() */
+extern int		iC_bsBits;	/* member lanes, ONE word and the Gates which feed members */
+extern Gate **		iC_bsGate;	/* Gate of each bit in iC_bsVal[] - 0 if unused or ONE */
+extern int *		iC_bsSlotIx;	/* first input slot of each member word and end */
+extern unsigned long *	iC_bsInv;	/* lanes which invert each input slot */
+extern int *		iC_bsTermIx;	/* first BitTerm of each input slot and end */
+extern BitTerm *	iC_bsTerm;	/* BitTerms of all input slots */
+extern unsigned long *	iC_bsOr;	/* OR lanes of each member word */
+extern int *		iC_bsFanIx;	/* first fan out of each bit and end */
+extern int *		iC_bsFan;	/* member word fed by each fan out */
+extern unsigned long *	iC_bsVal;	/* logic value of each bit */
+extern unsigned long *	iC_bsDirty;	/* member words to evaluate in the next bit scan */
 #if YYDEBUG && !defined(_WINDOWS)
 extern short		iC_dc;		/* debug display counter in scan and rsff */
 #endif
@@ -721,6 +777,8 @@ extern void	iC_fSsw(Gate *, Gate *);	/* F_SW slave action on SW */
 extern void	iC_fScf(Gate *, Gate *);	/* F_CF F_CE slave action on CF */
 extern void	iC_clockSfn(Gate *, Gate *);	/* CLCK slave action on CLK */
 extern void	iC_timerSfn(Gate *, Gate *);	/* TIMR slave action on TIM */
+extern void	iC_wheelLink(Gate *, Gate *, unsigned short);	/* link timed action to wheel */
+extern void	iC_wheelUnlink(Gate *, Gate *);	/* unlink timed action after glitch */
 extern void	iC_err_fn(Gate *, Gate *);	/* no master or slave function */
 
 extern void	iC_null(void);		/* null function */
@@ -732,6 +790,8 @@ extern void	iC_scan(Gate *);		/* scan logic action list */
 extern void	iC_scan_ar(Gate *);		/* scan arithmetic action list */
 extern void	iC_scan_clk(Gate *);		/* scan a clock list */
 extern void	iC_scan_snd(Gate *)		/* scan send list */;
+extern void	iC_bsInit(void);		/* start bit parallel scan -X */
+extern int	iC_scan_bs(void);		/* bit parallel scan of pure logic -X */
 extern void	iC_pass1(Gate *, int);		/* Pass1 init on gates */
 extern void	iC_pass2(Gate *, int);		/* Pass2 init on gates */
 extern void	iC_gate2(Gate *, int);		/* pass2 function init gates */
@@ -899,6 +959,15 @@ extern gpioIO *	iC_gpL[];		/* gpio name/gates and channels */
 extern void	iC_gpio_pud(int gpio, int pud);	/*  execute iCgpioPUD(gpio, pud) to set pull-up/down */
 #endif	/* RASPBERRYPI */
 extern int	iC_opt_l;
+extern int	iC_opt_b;		/* request binary channel data frames */
+extern int	iC_opt_j;		/* send to iCserver from a separate sender thread */
+extern int	iC_opt_r;		/* receive from iCserver in a separate receive thread */
+extern long	iC_opt_w;		/* input coalescing window in microseconds */
+extern unsigned long	iC_winScans;	/* scans which opened a -w window */
+extern unsigned long	iC_winSaved;	/* scans saved by absorbing input in a -w window */
+extern long	iC_opt_y;		/* live data refresh period in microseconds */
+extern unsigned long	iC_liveSaved;	/* live data updates suppressed by -y */
+extern long	iC_usecs(const char * str);	/* time with unit us, ms or s in us */
 #endif	/* TCP */
 
 extern void		iC_initIO(void);	/* init signal and correct interrupt vectors */
@@ -909,9 +978,9 @@ extern Gate *		iC_pf0_1;		/* pointer to _f0_1 if generated in buildNet() */
 
 #if defined(RUN) || defined(TCP) || defined(LOAD)
 extern Gate **		iC_list[];		/* used to load several modules */
+#endif /* RUN or TCP or LOAD */
 extern int		iC_cmp_gt_ids( const Gate ** a, const Gate ** b);
 typedef int (*iC_fptr)(const void*, const void*);
-#endif /* RUN or TCP or LOAD */
 #ifndef LOAD
 #if INT_MAX == 32767 && defined (LONG16)
 extern long		iC_exec(int iC_indx, Gate * gp);
@@ -37,7 +37,13 @@ static const char ict_c[] =
 #include	<Time.h>
 #else	/* ! _WIN32 Linux */
 #include	<sys/time.h>
+#include	<unistd.h>
 #endif	/* _WIN32 */
+#ifdef	__linux__
+#include	<stdint.h>
+#include	<sys/timerfd.h>
+#define	TFD				/* TX0 deadlines are delivered by a timerfd */
+#endif	/* __linux__ */
 #include	<signal.h>
 #include	<ctype.h>
 #include	<assert.h>
@@ -65,20 +71,71 @@ static int		stdinFlag = 0;
 static fd_set		infds;			/* initialised file descriptor set for normal iC_wait_for_next_event() */
 static fd_set		ixfds;			/* initialised extra descriptor set for normal iC_wait_for_next_event() */
 static fd_set		idfds;			/* initialised file descriptor set for debug iC_wait_for_next_event() */
-struct timeval		iC_timeOut = { 0, 49850 }; /* 50 mS select timeout - 5 ms if TX0.3 programmed */
-static struct timeval	toCnt  = { 0, 4850 };	/* fast timeout counter that select uses for 5 ms */
-static int		t5msFlag = 0;		/* set if 5 ms timer TX0.3 is programmed */
+struct timeval		iC_timeOut = { 0, 50000 }; /* 50 mS select timeout while oscillating */
+static struct timeval	toCnt;			/* timeout that select uses */
 #ifdef	RASPBERRYPI
-static struct timeval *	toCoff = NULL;		/* select() timeout off when NULl pointer for PiFaceCad and debug timeout */
 static piFaceIO *	pfCADpfp = NULL;	/* for PiFaceCAD string via PFCAD4 */
 static unsigned short	pfCADchannel = 0;
 #endif	/* RASPBERRYPI */
 static Gate		pfCADgate = { 1, -iC_ARNC, iC_ARITH, 0, "PFCAD4", {0}, {0}, 0, S_WIDTH };	/* iC string */
-static struct timeval *	toCntp = NULL;		/* select timeout switched off when NULl pointer */
+
+/********************************************************************
+ *  The internal TIMERS TX0.2 to TX0.7 toggle on deadlines, which are
+ *  multiples of 0.5 ms from an absolute CLOCK_MONOTONIC epoch. Time
+ *  spent in scans and early or late wake ups do not accumulate drift.
+ *  txUnit counts 0.5 ms units in a frame of 60 seconds, which is a
+ *  multiple of all TX0 periods. The epoch moves on by one frame when
+ *  txUnit overflows.
+ *******************************************************************/
+#define	TX_UNIT		500000L			/* 0.5 ms in ns */
+#define	TX_SEC		2000L			/* 0.5 ms units per second */
+#define	TX_FRSEC	60			/* seconds per frame */
+#define	TX_FRAME	(TX_FRSEC * TX_SEC)	/* 60 seconds in 0.5 ms units */
+#define	TX_LATE		TX_SEC			/* re-synchronise rather than catch up */
+static const long	txHalf[] = { 0, 0, 1, 10, 100, 1000, 10000, 60000, }; /* half periods of TX0.n */
+#if	YYDEBUG && !defined(_WINDOWS)
+static const char *	txMsg[] = { 0, 0, "Timer TX0.2 received",
+			    "Timer TX0.3 received", "Timer TX0.4 received",
+			    "Timer TX0.5 received", "Timer TX0.6 received",
+			    "Timer TX0.7 received", };
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+static struct timespec	txEpoch;		/* start of current 60 second frame */
+static struct timespec	txDl;			/* absolute deadline of txDue */
+static long		txUnit;			/* unit of last deadline processed */
+static long		txDue = 0;		/* unit of next deadline - 0 when disarmed */
+#ifdef	TFD
+static long		txSet = 0;		/* unit programmed in timerFN */
+static int		timerFN = -1;		/* timerfd delivering txDl */
+#endif	/* TFD */
+#if	YYDEBUG && !defined(_WINDOWS)
+static long		txJn;			/* -m wake up latency of TX0 deadlines */
+static long		txJmin;			/* in us - reported every second */
+static long		txJmax;
+static long long	txJsum;
+static long		txJsec = -1;		/* second in frame of last report */
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+static struct timespec	winEnd;			/* end of -w input coalescing window */
+typedef struct LiveHold {
+    unsigned short	index;			/* of a live gate changed in this -y period */
+    long		value;			/* its latest value */
+} LiveHold;
+static LiveHold *	liveQ = NULL;		/* live data held for the -y period */
+static unsigned short *	liveSlot = NULL;	/* 1 + position in liveQ of each index or 0 */
+static int		liveN = 0;		/* entries in liveQ */
+static struct timespec	liveDue;		/* end of the current -y period */
+static struct timespec	liveLast;		/* time held live data was last sent */
 
 static void	regAck(Gate ** oStart, Gate ** oEnd);
 static void	sendOutput(void);
 static void	debugWait(void);
+static void	monoNow(struct timespec * tp);
+static int	txActive(Gate * gp);
+static struct timeval *	txSchedule(void);
+static int	txExpired(int retval);
+static long	usRest(struct timespec * endp);
+static void	usAdd(struct timespec * tp, long us);
+static struct timeval *	tvLimit(struct timeval * tvp, long us);
+static void	liveFlush(void);
 static void	receiveActiveSymbols(char * cp1);
 static void	receiveWatchOrRestore(char * cp1);
 static void	storeChannel(unsigned short channel, Gate * gp
@@ -151,13 +208,21 @@ static unsigned int waitCount;		/* for WAIT display */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 #ifndef	EFENCE
 char		msgBuf[REQUEST];	/* Buffer in which live data is collected */
-char		iC_outBuf[REQUEST];	/* Buffer in which output is collected in iC_output() */
+char		iC_outBuf[FRAME];	/* Buffer in which output is collected in iC_output() */
 #else	/* EFENCE */
 char *		msgBuf;
 char *		iC_outBuf;
 #endif	/* EFENCE */
 static char *	outPtr;
 static int	outBufLen = REQUEST;
+static int	outSize = REQUEST;	/* FRAME after iCserver acknowledged B - any size is received */
+static int	binFrames = 0;		/* iCserver acknowledged binary channel data frames */
+static char *	inBuf = NULL;		/* messages of any size from iCserver - initially NULL */
+static int	inSize = 0;
+#ifndef	_WIN32
+static ChannelValue *	inVal = NULL;	/* values parsed by receive thread - initially NULL */
+static int	inValSize = 0;
+#endif	/* _WIN32 */
 static int	msgOffset;		/* for message send */
 extern const char	iC_ID[];
 static char *	iC_sav;
@@ -187,10 +252,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
     Gate *		gp;
     int			len;
     iC_Functp		init_fa;
-    int			t50m  = 1;
-    int			t500m = 1;
-    int			t5s   = 1;
-    int			t30s  = 1;
+    struct timeval *	tvp;
     int			retval;
     int			mask;
 #if	INT_MAX == 32767 && defined (LONG16)
@@ -203,6 +265,9 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
     unsigned short	debugBlock;
     FILE *		vcdFlag;
     int			infinityCnt;
+    int			winOpen;		/* -w input coalescing window is open */
+    int			winCnt;			/* cnt before waiting */
+    int			tcpCnt;			/* cnt before input from iCserver or -1 */
 #ifdef	RASPBERRYPI
     piFaceIO *		pfp;
     iqDetails *		pfq;
@@ -223,7 +288,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 
 #ifdef	EFENCE
     msgBuf = iC_emalloc(REQUEST);
-    iC_outBuf = iC_emalloc(REQUEST);
+    iC_outBuf = iC_emalloc(FRAME);
 #endif	/* EFENCE */
     signal(SIGSEGV, iC_quit);		/* catch memory access signal */
 
@@ -248,24 +313,8 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
     if ((gp = iC_TX0p) != 0) {		/* are EOI etc or TX0 timers programmed */
 	tim = gp->gt_list;		/* TX0.0 - TX0.7, TX0.0 is EOI - end of initialisation */
 	assert(tim);			/* TX0.1 is used to report receiving a new line on STDIN */
-	for (i = 3; i < 8; i++) {	/* TX0.2 is reserved for 1 ms timer T1ms (TODO implement) */
-	    if (tim[i] != NULL) {	/* any of the 5 timers 10 ms - 60 seconds programmed ? */
-		if (i == 3) {
-		    t5msFlag = 1;	/* 10 ms (5 on 5 off) timer is programmed */
-		    iC_timeOut = toCnt;	/* { 0, 5000 } initially */
-		}
-#ifdef	RASPBERRYPI
-		toCoff =		/* permanent select timeout for PiFaceCAD shift and debug timeout */
-#endif	/* RASPBERRYPI */
-		toCntp = &toCnt;	/* activate select timeout */
-		break;			/* could optimise by varying timeout value */
-	    }
-	}
     }
-#if YYDEBUG && !defined(_WINDOWS)
-    if (iC_debug & 04) fprintf(iC_outFP, "t5msFlag  %d, iC_timeout  %d:%d\n",
-	t5msFlag, (int)iC_timeOut.tv_sec, (int)iC_timeOut.tv_usec);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
+    monoNow(&txEpoch);			/* TX0.2 - TX0.7 deadlines are scheduled from here */
     /********************************************************************
      *  Clear and then set all bits to wait for interrupts
      *******************************************************************/
@@ -278,6 +327,19 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 #if YYDEBUG && !defined(_WINDOWS)
     if (iC_debug & 04) fprintf(iC_outFP, "*** all extra interrupts have been cleared\n");
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
+#ifdef	TFD
+    if ((timerFN = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+	perror("ERROR: timerfd_create failed");
+	iC_quit(SIGUSR1);
+    }
+    if (timerFN > iC_maxFN) {
+	iC_maxFN = timerFN;
+    }
+    FD_SET(timerFN, &infds);		/* watch timerfd for TX0 deadlines in normal wait */
+#if YYDEBUG && !defined(_WINDOWS)
+    if (iC_debug & 04) fprintf(iC_outFP, "*** TX0 timers use timerfd %d\n", timerFN);
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+#endif	/* TFD */
 
     if ((iC_debug & 0400) == 0 && iC_argh <= 0) {
 	char *		tbp;		/* points to next entry in regBuf */
@@ -665,7 +727,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 		if (mask && mask < X_MASK) {
 		    el += snprintf(ep + el, ENTRYSZ - el, "(%d)", mask);	/* mask of used bits */
 		}
-		if (tbc - el <= (opp+1 == sTend ? 2 : 0)) {	/* leave room for ",Z" at end */
+		if (tbc - el <= (opp+1 == sTend ? (iC_opt_b ? 4 : 2) : 0)) {	/* leave room for ",B,Z" at end */
 		    /********************************************************************
 		     * buffer is about to overflow
 		     *******************************************************************/
@@ -692,7 +754,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 #ifdef	RASPBERRYPI
       if (en || iC_opt_L) {			/* Do TCP/IP I/O only if needed */
 #endif	/* RASPBERRYPI */
-	strncpy(tbp + el, ",Z", tbc - el);	/* place termination in regBuf - 2 bytes are free */
+	strncpy(tbp + el, iC_opt_b ? ",B,Z" : ",Z", tbc - el);	/* request binary frames and termination - 4 or 2 bytes are free */
 #if YYDEBUG && !defined(_WINDOWS)
 	if (iC_micro & 06) iC_microPrint("last registration", 0);
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
@@ -940,6 +1002,12 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
     Out_init(iC_oList);
     olist1.gt_rptr = iC_oList = &olist0;	/* start with olist0 */
     Out_init(iC_oList);
+    if (iC_levTail) {				/* levelized scan -S */
+	alist0.gt_lev = 1;			/* select the set of level tails */
+	alist1.gt_lev = 2;			/* for each list in Lev_tail() */
+	olist0.gt_lev = 3;
+	olist1.gt_lev = LEV_LISTS;
+    }
 #ifdef	LOAD
     iC_cList = &iClock;				/* system clock list */
     Out_init(iC_cList);
@@ -982,6 +1050,11 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 	    }
 	}
     }
+#ifdef	LOAD
+    if (iC_bsGate) {
+	iC_bsInit();			/* members of bit parallel scan -X leave forward lists */
+    }
+#endif	/* LOAD */
     iC_osc_max = iC_osc_lim;		/* during Init oscillations were not checked */
 
 #if	YYDEBUG && !defined(_WINDOWS)
@@ -1058,6 +1131,11 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 	}
     }
+    if (iC_opt_y) {
+	i = index < 0x2000 ? index + 1 : 0x2000;	/* live indices are masked by 0x1fff */
+	liveQ = (LiveHold *)iC_emalloc(i * sizeof(LiveHold));
+	liveSlot = (unsigned short *)iC_emalloc(i * sizeof(unsigned short));
+    }
     /********************************************************************
      *  Generate a VCD file (Value Change Dump), an industry standard
      *  file format specified by IEEE-1364 (initially developed for Verilog).
@@ -1392,8 +1470,16 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
     }
     if (iC_argh > 0) iC_quit(-3);	/* in case --h does not quit in iCbegin() - no iCserver running */
+#ifndef	_WIN32
+    if (iC_opt_j && iC_sockFN > 0) {
+	iC_start_sender(iC_sockFN);	/* send to iCserver from a separate thread from now on */
+    }
+    if (iC_opt_r && iC_sockFN > 0) {
+	iC_start_receiver(iC_sockFN, D_channel);	/* receive and parse in a separate thread */
+    }
+#endif	/* _WIN32 */
     outPtr = iC_outBuf;			/* used in folowing initialisation and operational loop only */
-    outBufLen = REQUEST;
+    outBufLen = outSize;
 
 #ifdef	RASPBERRYPI
     if (iC_opt_P) {
@@ -1486,6 +1572,9 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 	 *                 bit actions to iC_oList
 	 *                 bits used in arithmetic to iC_aList (less common)
 	 *                 clocked actions to iC_cList via own clock list
+	 *  4a       { bit scan; goto Loop } if -X and members linked to iC_oList
+	 *                 words of AND OR members with changed inputs
+	 *                 evaluated lanewise in order of level (load only)
 	 ****** CLOCK PHASE *******
 	 * 5         { ++mark_stamp to control oscillations
 	 *             scan iC_cList; DO 5; goto Loop } unless iC_cList empty
@@ -1523,6 +1612,9 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 	    }
 	    if (iC_aList != iC_aList->gt_next) { iC_scan_ar (iC_aList);           }
 	    if (iC_oList != iC_oList->gt_next) { iC_scan    (iC_oList); continue; }
+#ifdef	LOAD
+	    if (iC_bsGate && iC_scan_bs())     {                        continue; }
+#endif	/* LOAD */
 	    if (iC_cList != iC_cList->gt_next) {
 		if (++iC_mark_stamp == 0) {	/* next generation for oscillator check */
 		    iC_mark_stamp++;		/* leave out zero */
@@ -1610,9 +1702,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 	    fprintf(iC_outFP, "== WAIT %5u ==========\n", waitCount);
 	    fflush(iC_outFP);
 #ifdef	RASPBERRYPI
-	    if ((slr &= ~0x07) == 0) {	/* stop 350 ms timeout - no 2nd wait message needed */
-		toCntp = toCoff;	/* slr also holds shift direction - not touched */
-	    }
+	    slr &= ~0x07;		/* stop 350 ms timeout - no 2nd wait message needed */
 #endif	/* RASPBERRYPI */
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
@@ -1634,7 +1724,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 	    virtualTime += 11;
 	    virtualTime -= (virtualTime%10 + 1);	/* next input is on 10's boundary */
 	}
-	for (cnt = 0; cnt == 0; ) {		/* stay in input loop if nothing linked */
+	for (cnt = winOpen = 0; cnt == 0 || winOpen; ) {	/* stay in input loop if nothing linked */
 	    /********************************************************************
 	     *  Turn TX0.1 lo in a cycle by itself before waiting for further I/O
 	     *******************************************************************/
@@ -1653,283 +1743,181 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 		stdinFlag = 0;			/* ready for next STDIN */
 		break;				/* do a scan - no need to increment cnt by using break */
 	    }
+	    /********************************************************************
+	     *  -y: send live data held back until the end of a refresh period
+	     *******************************************************************/
+	    if (liveN && usRest(&liveDue) <= 0) {
+		liveFlush();
+		iC_send_msg_to_server(iC_sockFN, msgBuf);
+		msgOffset = liveOffset;		/* msg = "C_channel:3" */
+	    }
 	    /********************************************************************
 	     *  Wait for input or timer interrupts in a select() statement
 	     *  most of the time
 	     *******************************************************************/
-	    retval = iC_wait_for_next_event(&infds, &ixfds, iC_osc_flag ? &toCnt : toCntp);
+	    tvp = txSchedule();		/* NULL unless select() times TX0 deadlines */
+	    if (iC_osc_flag &&
+		(tvp == NULL || tvp->tv_sec > iC_timeOut.tv_sec ||
+		(tvp->tv_sec == iC_timeOut.tv_sec && tvp->tv_usec > iC_timeOut.tv_usec))) {
+		toCnt = iC_timeOut;		/* do not wait long while oscillating */
+		tvp = &toCnt;
+	    }
+	    if (winOpen) {
+		long	us;
+
+		if ((us = usRest(&winEnd)) <= 0) {
+		    break;			/* -w window has closed - do the scan */
+		}
+		tvp = tvLimit(tvp, us);		/* wait no longer than the rest of the window */
+	    }
+	    if (liveN) {
+		tvp = tvLimit(tvp, usRest(&liveDue));	/* wake up to send held live data */
+	    }
+	    winCnt = cnt;
+	    tcpCnt = -1;
+	    retval = iC_wait_for_next_event(&infds, &ixfds, tvp);
 	    if (iC_osc_flag) {
 		cnt++;				/* gates have been linked to alternate list - do a scan */
 		iC_osc_flag = 0;		/* normal timer operation again */
 	    }
-	    if (retval == 0) {
+	    if (txExpired(retval)) {
 		/********************************************************************
-		 *  Timer interrupt
+		 *  Timer interrupt - deadline txUnit has been reached
+		 *
+		 *  Each TX0 timer, whose half period divides txUnit, is toggled.
+		 *  If deadlines were missed by an overrun, the next one has already
+		 *  expired when the loop returns here and is handled after this scan.
+		 *  So every edge of each TX0 timer is processed in its own scan.
+		 *
+		 *  txActive() blocks TX0 timers, which are connected directly to
+		 *  the slave input of a clock or timer Gate and that clock or timer
+		 *  has no Gates on the clock list it controls - ie nothing will happen.
+		 *  Such TX0 timers are not scheduled either - if there are no others
+		 *  the process does not wake up until there is other input.
+		 *  This also stops continuous output when tracing logic (-d100 or -t)
+		 *  and reduces the data traffic to iClive.
 		 *******************************************************************/
-		if (toCnt.tv_sec == 0 && toCnt.tv_usec == 0) {
-		    toCnt = iC_timeOut;		/* transfer timeout value */
-		    if (t5msFlag == 0) goto T50;		/* if no 10 ms timer iC_timeOut is 50ms */
-		    if ((gp = tim[3]) != 0) {			/* 10 millisecond timer */
+		for (i = 2; i < 8; i++) {
+		    if ((gp = tim[i]) != 0 && txUnit % txHalf[i] == 0 && txActive(gp)) {
 #if	YYDEBUG && !defined(_WINDOWS)
-			if (iC_debug & 01000) {
-			    Gate **	lp;
-			    Gate *	tp;
-			    int	cn1 = 2;
-			    lp = gp->gt_list;			/* test if any clock or timer is active */
-			    do {				/* for normal and inverted */
-				while ((tp = *lp++) != 0) {
-				    if (tp->gt_fni == CLCK || tp->gt_fni == TIMR) {
-					tp = tp->gt_funct;
-					if (tp->gt_next != tp) {
-					    goto linkT3;	/* found an active clock or timer */
-					}
-				    } else {
-					goto linkT3;	/* found a link to non clock or timer */
-				    }
-				}
-			    } while (--cn1);
-			    goto skipT3;			/* excuse spaghetti - faster without flag */
-			}
-		    linkT3:
-			if (iC_micro && !cnt) iC_microPrint("Timer TX0.3 received", 0);
+			if (iC_micro && !cnt) iC_microPrint(txMsg[i], 0);
 			if (iC_debug & 0100) fprintf(iC_outFP, "\n%s %+d ^=>", gp->gt_ids, gp->gt_val);
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-			gp->gt_val = - gp->gt_val;		/* complement input */
-			iC_link_ol(gp, iC_oList);		/* 5 ms on, 5 ms off is 10ms */
+			gp->gt_val = - gp->gt_val;	/* complement input */
+			iC_link_ol(gp, iC_oList);	/* 0.5 ms on, 0.5 ms off is 1 ms etc */
 #if	YYDEBUG && !defined(_WINDOWS)
 			if (iC_debug & 0100) fprintf(iC_outFP, " %+d", gp->gt_val);
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 			iC_liveData(gp, gp->gt_val < 0 ? 1 : 0);	/* VCD and/or iClive */
 			cnt++;
-#if	YYDEBUG && !defined(_WINDOWS)
-		    skipT3: ;
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
 		    }
-		    if (--t50m <= 0) {
-			t50m = 10;
-		      T50:
+		}
 #ifdef	RASPBERRYPI
-			if (slr) {			/* most of the time slr == 0, test only once */
+		if (slr && txUnit % 100 == 0) {	/* most of the time slr == 0, test only once */
 #if YYDEBUG && !defined(_WINDOWS)
-			    /********************************************************************
-			     *  Handle P: debug message timeout of 350 ms
-			     *******************************************************************/
-			    if ((slr & 0x07) != 0) {
-				if ((--slr & 0x07) == 0) {	/* 350 ms timer (7*50ms) */
-				    fprintf(iC_outFP, "\n======== WAIT ==========\n");
-				    fflush(iC_outFP);
-				    if (slr == 0) {		/* slr holds shift direction */
-					toCntp = toCoff;	/* stop 350 ms timeout unless iC TX0 uses it */
-				    }
-				}
-			    }
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-			    /********************************************************************
-			     *  Handle PiFaceCAD shift every 750 ms
-			     *******************************************************************/
-			    if ((slr & 0x18) && --tcnt_750 <= 0) {
-				tcnt_750 = 15;			/* 750 ms timer (15*50ms) */
-				if (slr & 0x08) {
-				    pifacecad_lcd_move_left();	/* move text left every 750 ms */
-				} else {
-				    pifacecad_lcd_move_right();	/* move text right every 750 ms */
-				}
-			    }
-			}
-#endif	/* RASPBERRYPI */
-			/********************************************************************
-			 *  TIMERS here every 100 milliseconds
-			 *
-			 *  The iC_debug facility -d1000 stops linking the 10 ms to 60 second
-			 *  TIMERS tim[3] to tim[7] when they are connected directly to
-			 *  the slave input of a clock or timer Gate and that clock or timer
-			 *  has no Gates on the clock list it controls - ie nothing will happen.
-			 *  This stops continuous output when tracing logic (-d100 or -t) when
-			 *  these internal TIMERS produce no change.
-			 *  It also reduces the data traffic to iClive and reduces flashing of
-			 *  clocks and timers controlled by internal TIMERS.
-			 *******************************************************************/
-			if ((gp = tim[4]) != 0) {		/* 100 millisecond timer */
-#if	YYDEBUG && !defined(_WINDOWS)
-			    if (iC_debug & 01000) {
-				Gate **	lp;
-				Gate *	tp;
-				int	cn1 = 2;
-				lp = gp->gt_list;		/* test if any clock or timer is active */
-				do {				/* for normal and inverted */
-				    while ((tp = *lp++) != 0) {
-					if (tp->gt_fni == CLCK || tp->gt_fni == TIMR) {
-					    tp = tp->gt_funct;
-					    if (tp->gt_next != tp) {
-						goto linkT4;	/* found an active clock or timer */
-					    }
-					} else {
-					    goto linkT4;	/* found a link to non clock or timer */
-					}
-				    }
-				} while (--cn1);
-				goto skipT4;			/* excuse spaghetti - faster without flag */
-			    }
-			linkT4:
-			    if (iC_micro && !cnt) iC_microPrint("Timer TX0.4 received", 0);
-			    if (iC_debug & 0100) fprintf(iC_outFP, "\n%s %+d ^=>", gp->gt_ids, gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-			    gp->gt_val = - gp->gt_val;		/* complement input */
-			    iC_link_ol(gp, iC_oList);		/* 50 ms on, 50 ms off is 100ms */
-#if	YYDEBUG && !defined(_WINDOWS)
-			    if (iC_debug & 0100) fprintf(iC_outFP, " %+d", gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-			    iC_liveData(gp, gp->gt_val < 0 ? 1 : 0);	/* VCD and/or iClive */
-			    cnt++;
-#if	YYDEBUG && !defined(_WINDOWS)
-			skipT4: ;
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
+		    /********************************************************************
+		     *  Handle P: debug message timeout of 350 ms
+		     *******************************************************************/
+		    if ((slr & 0x07) != 0) {
+			if ((--slr & 0x07) == 0) {	/* 350 ms timer (7*50ms) */
+			    fprintf(iC_outFP, "\n======== WAIT ==========\n");
+			    fflush(iC_outFP);
 			}
-			if (--t500m <= 0) {
-			    t500m = 10;
-			    if ((gp = tim[5]) != 0) {		/* 1 second timer */
-#if	YYDEBUG && !defined(_WINDOWS)
-				if (iC_debug & 01000) {
-				    Gate **	lp;
-				    Gate *	tp;
-				    int	cn1 = 2;
-				    lp = gp->gt_list;		/* test if any clock or timer is active */
-				    do {			/* for normal and inverted */
-					while ((tp = *lp++) != 0) {
-					    if (tp->gt_fni == CLCK || tp->gt_fni == TIMR) {
-						tp = tp->gt_funct;
-						if (tp->gt_next != tp) {
-						    goto linkT5;	/* found an active clock or timer */
-						}
-					    } else {
-						goto linkT5;	/* found a link to non clock or timer */
-					    }
-					}
-				    } while (--cn1);
-				    goto skipT5;		/* excuse spaghetti - faster without flag */
-				}
-			    linkT5:
-				if (iC_micro && !cnt) iC_microPrint("Timer TX0.5 received", 0);
-				if (iC_debug & 0100) fprintf(iC_outFP, "\n%s %+d ^=>", gp->gt_ids, gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-				gp->gt_val = - gp->gt_val;	/* complement input */
-				iC_link_ol(gp, iC_oList);	/* 500 ms on, 500 ms off is 1 second */
-#if	YYDEBUG && !defined(_WINDOWS)
-				if (iC_debug & 0100) fprintf(iC_outFP, " %+d", gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-				iC_liveData(gp, gp->gt_val < 0 ? 1 : 0);	/* VCD and/or iClive */
-				cnt++;
-#if	YYDEBUG && !defined(_WINDOWS)
-			    skipT5: ;
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-			    }
-			    if (--t5s <= 0) {
-				t5s = 10;
-				if ((gp = tim[6]) != 0) {	/* 10 second timer */
-#if	YYDEBUG && !defined(_WINDOWS)
-				    if (iC_debug & 01000) {
-					Gate **	lp;
-					Gate *	tp;
-					int	cn1 = 2;
-					lp = gp->gt_list;	/* test if any clock or timer is active */
-					do {			/* for normal and inverted */
-					    while ((tp = *lp++) != 0) {
-						if (tp->gt_fni == CLCK || tp->gt_fni == TIMR) {
-						    tp = tp->gt_funct;
-						    if (tp->gt_next != tp) {
-							goto linkT6;/* found an active clock or timer */
-						    }
-						} else {
-						    goto linkT6;/* found a link to non clock or timer */
-						}
-					    }
-					} while (--cn1);
-					goto skipT6;		/* excuse spaghetti - faster without flag */
-				    }
-				linkT6:
-				    if (iC_micro && !cnt) iC_microPrint("Timer TX0.6 received", 0);
-				    if (iC_debug & 0100) fprintf(iC_outFP, "\n%s %+d ^=>", gp->gt_ids, gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-				    gp->gt_val = - gp->gt_val;	/* complement input */
-				    iC_link_ol(gp, iC_oList);	/* 5 sec on, 5 sec off is 10 sec */
-#if	YYDEBUG && !defined(_WINDOWS)
-				    if (iC_debug & 0100) fprintf(iC_outFP, " %+d", gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-				    iC_liveData(gp, gp->gt_val < 0 ? 1 : 0);	/* VCD and/or iClive */
-				    cnt++;
-#if	YYDEBUG && !defined(_WINDOWS)
-				skipT6: ;
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-				}
-				if (--t30s <= 0) {
-				    t30s = 6;
-				    if ((gp = tim[7]) != 0) {	/* 60 second timer */
-#if	YYDEBUG && !defined(_WINDOWS)
-					if (iC_debug & 01000) {
-					    Gate **	lp;
-					    Gate *	tp;
-					    int	cn1 = 2;
-					    lp = gp->gt_list;	/* test if any clock or timer is active */
-					    do {		/* for normal and inverted */
-						while ((tp = *lp++) != 0) {
-						    if (tp->gt_fni == CLCK || tp->gt_fni == TIMR) {
-							tp = tp->gt_funct;
-							if (tp->gt_next != tp) {
-							    goto linkT7;/* found an active clock or timer */
-							}
-						    } else {
-							goto linkT7;/* found a link to non clock or timer */
-						    }
-						}
-					    } while (--cn1);
-					    goto skipT7;	/* excuse spaghetti - faster without flag */
-					}
-				    linkT7:
-					if (iC_micro && !cnt) iC_microPrint("Timer TX0.7 received", 0);
-					if (iC_debug & 0100) fprintf(iC_outFP, "\n%s %+d ^=>", gp->gt_ids, gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-					gp->gt_val = - gp->gt_val;	/* complement input */
-					iC_link_ol(gp, iC_oList);	/* 30 sec on, 30 sec off is 60 sec */
-#if	YYDEBUG && !defined(_WINDOWS)
-					if (iC_debug & 0100) fprintf(iC_outFP, " %+d", gp->gt_val);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-					iC_liveData(gp, gp->gt_val < 0 ? 1 : 0);	/* VCD and/or iClive */
-					cnt++;
-#if	YYDEBUG && !defined(_WINDOWS)
-				    skipT7: ;
+		    }
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-				    }
-				}
-			    }
+		    /********************************************************************
+		     *  Handle PiFaceCAD shift every 750 ms
+		     *******************************************************************/
+		    if ((slr & 0x18) && --tcnt_750 <= 0) {
+			tcnt_750 = 15;			/* 750 ms timer (15*50ms) */
+			if (slr & 0x08) {
+			    pifacecad_lcd_move_left();	/* move text left every 750 ms */
+			} else {
+			    pifacecad_lcd_move_right();	/* move text right every 750 ms */
 			}
 		    }
 		}
-	    } else if (retval > 0) {
+#endif	/* RASPBERRYPI */
+	    }
+	    if (retval > 0) {
 		/********************************************************************
 		 *  TCP/IP input from iCserver
 		 *******************************************************************/
 		if (iC_sockFN > 0 && FD_ISSET(iC_sockFN, &iC_rdfds)) {
+		    const ChannelValue *	vp = NULL;	/* next value parsed by receive thread */
+		    const ChannelValue *	vpe = NULL;
+		    tcpCnt = cnt;
 #if YYDEBUG && !defined(_WINDOWS)
 		    if (iC_debug & 04) fprintf(iC_outFP, "*** Main Loop TCP interrupt ");
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-		    if (iC_rcvd_msg_from_server(iC_sockFN, rpyBuf, REPLY) != 0) {
+#ifndef	_WIN32
+		    /********************************************************************
+		     *  With the receive thread (-r) take all values queued so far
+		     *  in one go - other messages are received as frames
+		     *******************************************************************/
+		    if ((len = iC_rcvd_values_from_server(&inVal, &inValSize)) != 0) {
+			vp = inVal;
+			vpe = inVal + len;
+		    } else
+#endif	/* _WIN32 */
+		    len = iC_rcvd_frame_from_server(iC_sockFN, &inBuf, &inSize);
+		    if (len != 0) {
+			const char *	bp = NULL;	/* next record if binary frame */
+			long		bval;
 #if YYDEBUG && !defined(_WINDOWS)
-			if (iC_debug & 04) { fprintf(iC_outFP, " << %s\n", rpyBuf); fflush(iC_outFP); }
+			if (iC_debug & 04) {
+			    if (vp) fprintf(iC_outFP, " << [%d values]\n", len);
+			    else    fprintf(iC_outFP, " << %s\n", inBuf);
+			    fflush(iC_outFP);
+			}
 			if (iC_micro && !cnt) iC_microPrint("Input received", 0);
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-			cp = rpyBuf - 1;	/* increment to first character in rpyBuf in first use of cp */
-			if (isdigit(rpyBuf[0])) {
+			cp = inBuf - 1;	/* increment to first character in inBuf in first use of cp */
+			if (vp == NULL && binFrames && inBuf[0] == BIN_FRAME) {
+			    bp = inBuf + 1;	/* first record of binary frame */
+			}
+			if (vp || bp || isdigit(inBuf[0])) {
 			    char *	cpe;
 			    char *	cps;
+			    char	vBuf[OSIZ];	/* binary value as text for pfCAD */
 
 			    assert(Channels);
+			  RcvValue:
 			    do {
-				if ((cpe = strchr(++cp, ',')) != NULL) { /* find next comma in input */
-				    *cpe = '\0';	/* split off leading comma separated token */
+				if (vp) {
+				    /********************************************************************
+				     *  value parsed by the receive thread
+				     *******************************************************************/
+				    channel = vp->channel;
+				    val = bval = vp->val;
+				    cps = vBuf;		/* only used as text for pfCAD */
+				    cpe = ++vp < vpe ? vBuf : NULL;	/* more values */
+				} else if (bp) {
+				    /********************************************************************
+				     *  binary record - channel and value need no conversion
+				     *******************************************************************/
+				    if ((bp = iC_get_record(bp, inBuf + len, &channel, &bval)) == NULL) {
+					goto RcvWarning;	/* truncated binary frame */
+				    }
+				    val = bval;
+				    cps = vBuf;		/* only used as text for pfCAD */
+				    cpe = bp < inBuf + len ? cp : NULL;	/* more records */
+				} else {
+				    if ((cpe = strchr(++cp, ',')) != NULL) { /* find next comma in input */
+					*cpe = '\0';	/* split off leading comma separated token */
+				    }
+				    if ((cps = strchr(cp, ':')) != NULL) {	/* strip only first ':' separating channel and data */
+					channel = (unsigned short)atoi(cp);
+#if	INT_MAX == 32767 && defined (LONG16)
+					val = atol(++cps);	/* val required for RQ ExtOut */
+#else	/* INT_MAX == 32767 && defined (LONG16) */
+					val = atoi(++cps);
+#endif	/* INT_MAX == 32767 && defined (LONG16) */
+				    }
 				}
 				if (
-				    (cps = strchr(cp, ':')) != NULL &&	/* strip only first ':' separating channel and data */
-				    (channel = (unsigned short)atoi(cp)) > 0 &&
+				    cps != NULL &&
+				    channel > 0 &&
 				    channel <= topChannel &&
 #ifdef	RASPBERRYPI
 				    ((gp = Channels[channel].g) != NULL ||
@@ -1938,14 +1926,12 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 				    (gp = Channels[channel]) != NULL
 #endif	/* RASPBERRYPI */
 				) {
-#if	INT_MAX == 32767 && defined (LONG16)
-				    val = atol(++cps);			/* val required for RQ ExtOut */
-#else	/* INT_MAX == 32767 && defined (LONG16) */
-				    val = atoi(++cps);
-#endif	/* INT_MAX == 32767 && defined (LONG16) */
 #ifdef	RASPBERRYPI
 				  if (gp) {				/* RI External */
 				    if (gp == &pfCADgate) {
+					if (bp || vp) {
+					    snprintf(vBuf, OSIZ, "%ld", bval);	/* numeric display string */
+					}
 					cp = cps - 1;			/* on : before display string */
 					while ((cp = strchr(cp+1 , '\036')) != NULL) {	/* ASCII RS */
 					    *cp = ',';			/* replace every RS by a comma */
@@ -2097,7 +2083,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 
 					    case 3:			/* RECEIVE_ACTIVE_SYMBOLS */
 					    case 4:			/* LAST_ACTIVE_SYMBOLS */
-						receiveActiveSymbols(rpyBuf);
+						receiveActiveSymbols(inBuf);
 						if (val == 4) {
 						    liveFlag = 1;	/* live inhibit bits are correct */
 						}
@@ -2144,7 +2130,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 						    }
 						    stepFlag &= ~stepMask;		/* do not set again until case 9 or 11 received */
 						}
-						cp1 = rpyBuf;
+						cp1 = inBuf;
 						while ((cp1 = strchr(cp1, ';')) != NULL) {
 						    index = atoi(++cp1);
 						    assert(index <= sTend - sTable);	/* check index is in range */
@@ -2165,7 +2151,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 
 					    case 12:			/* RECEIVE_WATCH_OR_RESTORE */
 						if (debugBlock != 0x1fff) break;	/* cannot set step and next debug */
-						receiveWatchOrRestore(rpyBuf);
+						receiveWatchOrRestore(inBuf);
 						break;
 
 						/********************************************************************
@@ -2258,7 +2244,11 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 			}
 			else {
 			  RcvWarning:
-			    fprintf(iC_errFP, "WARNING: %s: received '%s' from iCserver ???\n", iC_iccNM, rpyBuf);
+			    if (vp) {
+				fprintf(iC_errFP, "WARNING: %s: received '%hu:%ld' from iCserver ???\n", iC_iccNM, channel, bval);
+				if (vp < vpe) goto RcvValue;	/* values from other frames follow */
+			    } else
+			    fprintf(iC_errFP, "WARNING: %s: received '%s' from iCserver ???\n", iC_iccNM, inBuf);
 			}
 		    } else {
 			iC_quit(QUIT_SERVER);		/* quit normally with 0 length message from iCserver */
@@ -2373,7 +2363,7 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 #if YYDEBUG && !defined(_WINDOWS)
 		if ((iC_debug & 0100) && outPtr > iC_outBuf) {		/* any data for iCserver? */
 		    fprintf(iC_outFP, "\nP: %s:	%s	<%s", iC_iccNM, iC_outBuf+1, buffer);
-		    toCntp = &toCnt; slr |= 0x07;	/* activate 350 ms debug message timeout */
+		    slr |= 0x07;	/* activate 350 ms debug message timeout */
 		}					/* must output debug message before sendOutput() */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 		sendOutput();				/* send possible TCP/IP data now - may not effect loop scan */
@@ -2419,10 +2409,28 @@ iC_icc(void)				/* Gate ** sTable, Gate ** sTend are global */
 			fprintf(iC_errFP, "no action coded for '%c'\n", c);
 		    }					/* ignore the rest of STDIN */
 		}   /*  end of STDIN interrupt */
-	    } else {				/* retval -1 */
+	    } else if (retval < 0) {		/* retval -1 */
 		perror("ERROR: select failed");
 		iC_quit(SIGUSR1);
 	    }
+	    /********************************************************************
+	     *  -w <window>: input from iCserver, which linked gates, opens a
+	     *  window in which further input already on its way is absorbed
+	     *  into the same scan. A timeout, a timer edge, STDIN or an
+	     *  oscillation closes the window, so these keep their own scans.
+	     *******************************************************************/
+	    if (iC_opt_w) {
+		if (tcpCnt < 0 || tcpCnt != winCnt || stdinFlag) {
+		    winOpen = 0;			/* scan now */
+		} else if (winOpen) {
+		    iC_winSaved++;			/* input absorbed instead of its own scan */
+		} else if (cnt > 0) {
+		    monoNow(&winEnd);
+		    usAdd(&winEnd, iC_opt_w);
+		    winOpen = 1;
+		    iC_winScans++;
+		}
+	    }
 	    /* if many inputs change simultaneously increase oscillator limit */
 	    iC_osc_lim = (cnt << 1) + 1;	/* (cnt * 2) + 1 */
 	    if (iC_osc_lim < iC_osc_max) {
@@ -2468,7 +2476,7 @@ iC_output(int val, unsigned short channel)
 	if (iC_debug & 0100) {
 	    fprintf(iC_outFP, "\nP: %s:	%hu:%d P%d	> %s",
 		iC_iccNM, channel, (int)val, pfp->pfa, pfp->Qgate->gt_ids);
-	    toCntp = &toCnt; slr |= 0x07;		/* activate 350 ms debug message timeout */
+	    slr |= 0x07;		/* activate 350 ms debug message timeout */
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 	writePiFace(pfp, val & X_MASK, channelSp->iqs);	/* Q Internal */
@@ -2487,7 +2495,7 @@ iC_output(int val, unsigned short channel)
 	if (iC_debug & 0100) {
 	    fprintf(iC_outFP, "\nP: %s:	%hu:%d G	> %s",
 		iC_iccNM, channel, (int)val, gep->Ggate->gt_ids);
-	    toCntp = &toCnt; slr |= 0x07;		/* activate 350 ms debug message timeout */
+	    slr |= 0x07;		/* activate 350 ms debug message timeout */
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 	val0 = val ^ gep->Ginv; /* normally write non-inverted data to GPIO output - invert data for -I */
@@ -2515,6 +2523,14 @@ iC_output(int val, unsigned short channel)
     /********************************************************************
      *  TCP/IP output
      *******************************************************************/
+    if (binFrames) {
+	if (outPtr == iC_outBuf) {
+	    *outPtr++ = ',';				/* skipped by sendOutput() */
+	    *outPtr++ = BIN_FRAME;			/* start binary frame */
+	    outBufLen -= 2;
+	}
+	len = iC_put_record(outPtr, channel, val) - outPtr;	/* 3 to BSIZ bytes */
+    } else
     len = snprintf(outPtr, outBufLen,
 #if	INT_MAX == 32767 && defined (LONG16)
 	",%hu:%ld",					/* signed long to output for QXx QBx QWx QLx */
@@ -2562,15 +2578,15 @@ sendOutput(void)
 #ifdef	RASPBERRYPI
 	if (iC_sockFN > 0)				/* may be called when no iCserver for direct output */
 #endif	/* RASPBERRYPI */
-	iC_send_msg_to_server(iC_sockFN, iC_outBuf+1);	/* send block - usually the only one */
+	iC_send_data_to_server(iC_sockFN, iC_outBuf+1, outPtr - iC_outBuf - 1);	/* send block - usually the only one */
 #if YYDEBUG && !defined(_WINDOWS)
-	if (iC_debug & 04) {
+	if ((iC_debug & 04) && ! binFrames) {
 	    fprintf(iC_outFP, "iC_outBuf[%d] \"%s\"\n", (int)(outPtr - iC_outBuf-1), iC_outBuf+1);
 	    *(iC_outBuf+1) = '\0';			/* clean debug output next time */
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 	outPtr = iC_outBuf;				/* ready for next Operational loop */
-	outBufLen = REQUEST;
+	outBufLen = outSize;
     }
 } /* sendOutput */
 #ifdef	RASPBERRYPI
@@ -2686,10 +2702,7 @@ writePiFace(piFaceIO * pfp, int val, int iq)
 	    if ((v18 = val & 0x18) != 0) {
 		slr |= v18;				/* set shift left 0x08 or shift right 0x10 */
 		tcnt_750 = 1;				/* first character shift immediately */
-		toCntp = &toCnt;			/* start 750 ms timeout */
-	    } else if (slr == 0) {			/* slr also holds debug message timeout counter */
-		toCntp = toCoff;			/* stop 750 ms timeout unless iC TX0 uses it */
-	    }						/* for both off */
+	    }						/* slr != 0 schedules 750 ms shift */
 	}
 	if ((m & 0x20) && (val & 0x20)) {
 	    switch (cbc = (cbc + 1) & 0x03) {		/* cbc holds cursor and blink state */
@@ -2982,6 +2995,11 @@ regAck(Gate ** oStart, Gate ** oEnd)
 	  }
 #endif	/* RASPBERRYPI */
 	}
+	if (cp && strcmp(cp, ",B") == 0) {	/* iCserver accepts binary channel data frames */
+	    binFrames = 1;
+	    outSize = FRAME;			/* and frames of any size */
+	    cp = NULL;
+	}
 	assert(cp == NULL);			/* Ack string matches Registration */
 #if YYDEBUG && !defined(_WINDOWS)
 	if (iC_debug & 0224) fprintf(iC_outFP, "reply: Channels %hu\n", topChannel);
@@ -3107,12 +3125,17 @@ debugWait(void)
     int			val;
     int			retval;
     unsigned short	channel;
-    char		debugBuf[REPLY];	/* needs local buffer */
+    int			len;
+    static char *	debugBuf = NULL;	/* needs own buffer - called while inBuf is scanned */
+    static int		debugSize = 0;
+    static char *	textBuf = NULL;		/* binary frame converted to text */
+    static int		textSize = 0;
 
     /********************************************************************
      *  For debug messages wait for TCP inputs only
      *  Ignore stdin, extra and timer inerrupts
      *******************************************************************/
+    txDue = 0;				/* TX0 timers stand still at a break */
     retval = iC_wait_for_next_event(&idfds, 0, 0);
     if (retval > 0) {
 	/********************************************************************
@@ -3122,7 +3145,37 @@ debugWait(void)
 #if YYDEBUG && !defined(_WINDOWS)
 	    if (iC_debug & 04) fprintf(iC_outFP, "*** Debug Wait TCP interrupt" );
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-	    if (iC_rcvd_msg_from_server(iC_sockFN, debugBuf, REPLY) != 0) {
+	    if ((len = iC_rcvd_frame_from_server(iC_sockFN, &debugBuf, &debugSize)) != 0) {
+		if (binFrames && debugBuf[0] == BIN_FRAME) {
+		    /********************************************************************
+		     *  Convert a binary frame to text - rare while stopped at a break
+		     *  I.. inputs are re-transmitted to iCserver as text
+		     *  Each record of 3 to 12 bytes needs less than 4 times as much text
+		     *******************************************************************/
+		    const char *	bp = debugBuf + 1;
+		    long	bval;
+		    int		tl = 0;
+
+		    if (textSize < 4 * len) {
+			textBuf = (char*)realloc(textBuf, textSize = 4 * len);	/* initially NULL */
+			assert(textBuf);
+		    }
+		    textBuf[0] = '\0';
+		    while (bp < debugBuf + len) {
+			if ((bp = iC_get_record(bp, debugBuf + len, &channel, &bval)) == NULL) {
+			    fprintf(iC_errFP, "WARNING: %s: truncated binary frame of %d bytes in debugWait\n",
+				iC_iccNM, len);
+			    return;
+			}
+			tl += snprintf(textBuf + tl, textSize - tl, "%s%hu:%ld", tl ? "," : "", channel, bval);
+		    }
+		    cp = debugBuf;			/* swap buffers */
+		    debugBuf = textBuf;
+		    textBuf = cp;
+		    len = debugSize;
+		    debugSize = textSize;
+		    textSize = len;
+		}
 #if YYDEBUG && !defined(_WINDOWS)
 		if (iC_debug & 04) { fprintf(iC_outFP, " << %s\n", debugBuf); fflush(iC_outFP); }
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
@@ -3248,6 +3301,293 @@ debugWait(void)
     }
 } /* debugWait */
 
+/********************************************************************
+ *
+ *	Read CLOCK_MONOTONIC - unaffected by changes of the date
+ *
+ *******************************************************************/
+
+static void
+monoNow(struct timespec * tp)
+{
+#ifdef	CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, tp);
+#else	/* CLOCK_MONOTONIC */
+    struct timeval	tv;
+
+    gettimeofday(&tv, 0);		/* best effort without a monotonic clock */
+    tp->tv_sec  = tv.tv_sec;
+    tp->tv_nsec = tv.tv_usec * 1000;
+#endif	/* CLOCK_MONOTONIC */
+} /* monoNow */
+
+/********************************************************************
+ *
+ *	Test if TX0 timer gp will cause any action when it is toggled
+ *
+ *	A TX0 timer connected directly to the slave input of a clock or
+ *	timer Gate is only active if that clock or timer has Gates on
+ *	its clock list or timing wheel. A TX0 timer with any other
+ *	connection is always active.
+ *
+ *******************************************************************/
+
+static int
+txActive(Gate * gp)
+{
+    Gate **	lp;
+    Gate *	tp;
+    int		cn1 = 2;
+
+    lp = gp->gt_list;
+    do {				/* for normal and inverted */
+	while ((tp = *lp++) != 0) {
+	    if (tp->gt_fni == CLCK) {
+		tp = tp->gt_funct;
+		if (tp->gt_next != tp) {
+		    return 1;		/* found an active clock */
+		}
+	    } else if (tp->gt_fni == TIMR) {
+		tp = tp->gt_funct;
+		if (tp->gt_wheel->wh_on) {
+		    return 1;		/* found an active timer */
+		}
+	    } else {
+		return 1;		/* found a link to non clock or timer */
+	    }
+	}
+    } while (--cn1);
+    return 0;
+} /* txActive */
+
+/********************************************************************
+ *
+ *	Schedule the next TX0 deadline after txUnit
+ *
+ *	Only TX0 timers which are active now are taken into account.
+ *	If there are none, TX0 timing is disarmed. When it is armed again,
+ *	txUnit is re-synchronised to the current time, so that no time
+ *	spent while disarmed is caught up.
+ *
+ *	With TFD the deadline is programmed into timerFN, which select()
+ *	watches, and NULL is returned. Otherwise the select() timeout to
+ *	the deadline is returned, or NULL if disarmed.
+ *
+ *******************************************************************/
+
+static long
+txNext(void)
+{
+    int		i;
+    long	h;
+    long	u;
+    long	due = 0;
+
+    for (i = 2; i < 8; i++) {
+	if (tim[i] != NULL && txActive(tim[i])) {
+	    h = txHalf[i];
+	    u = (txUnit / h + 1) * h;	/* next multiple of the half period */
+	    if (due == 0 || u < due) {
+		due = u;
+	    }
+	}
+    }
+#ifdef	RASPBERRYPI
+    if (slr) {				/* 50 ms debug message and PiFaceCAD shift */
+	u = (txUnit / 100 + 1) * 100;
+	if (due == 0 || u < due) {
+	    due = u;
+	}
+    }
+#endif	/* RASPBERRYPI */
+    return due;
+} /* txNext */
+
+static struct timeval *
+txSchedule(void)
+{
+    long		due;
+    long long		ns;
+    struct timespec	now;
+
+    if ((due = txNext()) == 0) {
+#ifdef	TFD
+	if (txSet) {
+	    struct itimerspec	its;
+
+	    memset(&its, 0, sizeof its);
+	    timerfd_settime(timerFN, 0, &its, 0);	/* disarm */
+	    txSet = 0;
+	}
+#endif	/* TFD */
+	txDue = 0;
+	return NULL;			/* no TX0 timer is active - wait for input only */
+    }
+    if (txDue == 0) {
+	monoNow(&now);			/* re-synchronise after being disarmed */
+	ns = (long long)(now.tv_sec - txEpoch.tv_sec) * 1000000000LL + (now.tv_nsec - txEpoch.tv_nsec);
+	while (ns >= (long long)TX_FRAME * TX_UNIT) {
+	    txEpoch.tv_sec += TX_FRSEC;	/* move epoch on by whole frames */
+	    ns -= (long long)TX_FRAME * TX_UNIT;
+	}
+	txUnit = ns / TX_UNIT;
+	due = txNext();
+    }
+    if (due != txDue) {
+	txDue = due;
+	ns = (long long)due * TX_UNIT + txEpoch.tv_nsec;
+	txDl.tv_sec  = txEpoch.tv_sec + ns / 1000000000LL;
+	txDl.tv_nsec = ns % 1000000000LL;
+    }
+#ifdef	TFD
+    if (txSet != txDue) {
+	struct itimerspec	its;
+
+	memset(&its, 0, sizeof its);
+	its.it_value = txDl;		/* one shot at absolute deadline */
+	if (timerfd_settime(timerFN, TFD_TIMER_ABSTIME, &its, 0) < 0) {
+	    perror("ERROR: timerfd_settime failed");
+	    iC_quit(SIGUSR1);
+	}
+	txSet = txDue;
+    }
+    return NULL;			/* timerFN is watched by select() */
+#else	/* TFD */
+    monoNow(&now);
+    ns = (long long)(txDl.tv_sec - now.tv_sec) * 1000000000LL + (txDl.tv_nsec - now.tv_nsec);
+    if (ns < 0) {
+	ns = 0;				/* overrun - deadline has passed already */
+    }
+    ns = (ns + 999) / 1000;		/* us - never wake up early */
+    toCnt.tv_sec  = ns / 1000000;
+    toCnt.tv_usec = ns % 1000000;
+    return &toCnt;
+#endif	/* TFD */
+} /* txSchedule */
+
+/********************************************************************
+ *
+ *	Microseconds from now until *endp - negative when it has passed
+ *
+ *******************************************************************/
+
+static long
+usRest(struct timespec * endp)
+{
+    struct timespec	now;
+
+    monoNow(&now);
+    return (endp->tv_sec - now.tv_sec) * 1000000L + (endp->tv_nsec - now.tv_nsec) / 1000;
+} /* usRest */
+
+/********************************************************************
+ *
+ *	Add us microseconds to *tp
+ *
+ *******************************************************************/
+
+static void
+usAdd(struct timespec * tp, long us)
+{
+    tp->tv_sec  += us / 1000000L;
+    tp->tv_nsec += (us % 1000000L) * 1000L;
+    if (tp->tv_nsec >= 1000000000L) {
+	tp->tv_sec++;
+	tp->tv_nsec -= 1000000000L;
+    }
+} /* usAdd */
+
+/********************************************************************
+ *
+ *	Limit the select() timeout tvp (NULL waits for ever) to us
+ *	microseconds - returns tvp or &toCnt
+ *
+ *******************************************************************/
+
+static struct timeval *
+tvLimit(struct timeval * tvp, long us)
+{
+    if (us < 0) {
+	us = 0;
+    }
+    if (tvp == NULL || tvp->tv_sec > us / 1000000L ||
+	(tvp->tv_sec == us / 1000000L && tvp->tv_usec > us % 1000000L)) {
+	toCnt.tv_sec  = us / 1000000L;
+	toCnt.tv_usec = us % 1000000L;
+	tvp = &toCnt;
+    }
+    return tvp;
+} /* tvLimit */
+
+/********************************************************************
+ *
+ *	Test if the TX0 deadline txDue has been reached after select()
+ *	If so txUnit is advanced to txDue.
+ *
+ *	If the deadline is more than TX_LATE units (1 second) late, the
+ *	remaining missed deadlines are not caught up.
+ *
+ *	With -m the minimum, average and maximum latency of waking up
+ *	after each deadline is reported every second.
+ *
+ *******************************************************************/
+
+static int
+txExpired(int retval)
+{
+    long long		ns;
+    struct timespec	now;
+
+#ifdef	TFD
+    if (retval > 0 && FD_ISSET(timerFN, &iC_rdfds)) {
+	uint64_t	exp;
+
+	if (read(timerFN, &exp, sizeof exp) < 0 && errno != EAGAIN) {
+	    perror("ERROR: read timerfd failed");
+	    iC_quit(SIGUSR1);
+	}				/* count not used - deadlines are absolute */
+    }
+#endif	/* TFD */
+    if (retval < 0 || txDue == 0) {
+	return 0;
+    }
+    monoNow(&now);
+    ns = (long long)(now.tv_sec - txDl.tv_sec) * 1000000000LL + (now.tv_nsec - txDl.tv_nsec);
+    if (ns < 0) {
+	return 0;			/* not yet */
+    }
+#ifdef	TFD
+    txSet = 0;				/* one shot has expired */
+#endif	/* TFD */
+    txUnit = txDue;
+    if (txUnit >= TX_FRAME) {
+	txUnit -= TX_FRAME;		/* start a new frame */
+	txEpoch.tv_sec += TX_FRSEC;
+    }
+    txDue = ns > (long long)TX_LATE * TX_UNIT ? 0 : -1;	/* -1 forces new deadline */
+#if	YYDEBUG && !defined(_WINDOWS)
+    if (iC_micro) {
+	long	us = ns / 1000;		/* wake up latency in us */
+
+	if (txJn == 0 || us < txJmin) txJmin = us;
+	if (txJn == 0 || us > txJmax) txJmax = us;
+	txJsum += us;
+	txJn++;
+	if (txUnit / TX_SEC != txJsec) {
+	    char	jBuf[80];
+
+	    txJsec = txUnit / TX_SEC;
+	    snprintf(jBuf, sizeof jBuf, "TX0 latency %ld: min %ld avg %ld max %ld us",
+		txJn, txJmin, (long)(txJsum / txJn), txJmax);
+	    iC_microPrint(jBuf, 0);
+	    txJn = 0;
+	    txJsum = 0;
+	}
+    }
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+    return 1;
+} /* txExpired */
+
 /********************************************************************
  *
  *	Output VCD data and/or a live data message during scans
@@ -3301,6 +3641,25 @@ iC_liveData(Gate * gp, int value)
 	     *******************************************************************/
 	  noBreak:
 	    if (gp->gt_live & 0x8000) {			/* is variable in window for iClive */
+		if (liveQ && debugMask == 0x0000) {
+		    /********************************************************************
+		     *  -y: hold only the latest value of each live gate until the
+		     *  end of the refresh period - sent by liveFlush()
+		     *******************************************************************/
+		    if ((len = liveSlot[index]) == 0) {
+			if (liveN == 0) {
+			    liveDue = liveLast;		/* period starts at the last send */
+			    usAdd(&liveDue, iC_opt_y);
+			}
+			liveSlot[index] = len = ++liveN;
+			liveQ[len-1].index = index;
+		    } else {
+			iC_liveSaved++;			/* earlier value is suppressed */
+		    }
+		    liveQ[len-1].value = value;
+		    goto liveEnd;
+		}
+		if (liveN) liveFlush();			/* keep the order of live data */
 		while ((len =
 #if	INT_MAX == 32767 && defined (LONG16)
 			snprintf(&msgBuf[msgOffset], rest = REQUEST - msgOffset,
@@ -3356,6 +3715,7 @@ iC_liveData(Gate * gp, int value)
 #if YYDEBUG && !defined(_WINDOWS)
 	    if (iC_debug & 0100) fflush(iC_outFP);	/* in case dangling text debug messages without CR */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
+	    if (liveN) liveFlush();			/* held live data before the break */
 	    while ((len =				/* repeat code for speed */
 #if	INT_MAX == 32767 && defined (LONG16)
 		    snprintf(&msgBuf[msgOffset], rest = REQUEST - msgOffset,
@@ -3397,10 +3757,39 @@ iC_liveData(Gate * gp, int value)
 		 *******************************************************************/
 	    }
 	}
+      liveEnd:
 	iC_linked = 0;
     }
 } /* iC_liveData */
 
+/********************************************************************
+ *
+ *	-y: append the live data held in the current refresh period to
+ *	msgBuf, which is sent by the caller
+ *
+ *******************************************************************/
+
+static void
+liveFlush(void)
+{
+    int			len;
+    int			rest;
+    LiveHold *		lp;
+
+    for (lp = liveQ; lp < &liveQ[liveN]; lp++) {
+	while ((len = snprintf(&msgBuf[msgOffset], rest = REQUEST - msgOffset,
+		";%hu %ld", lp->index, lp->value)) < 0 || len >= rest) {
+	    msgBuf[msgOffset] = '\0';		/* terminate */
+	    iC_send_msg_to_server(iC_sockFN, msgBuf);
+	    msgOffset = liveOffset;		/* msg = "C_channel:3" */
+	}
+	msgOffset += len;
+	liveSlot[lp->index] = 0;
+    }
+    liveN = 0;
+    monoNow(&liveLast);
+} /* liveFlush */
+
 /********************************************************************
  *
  *	Receive active symbols to set up Live bits and send initial data
@@ -3413,7 +3802,6 @@ receiveActiveSymbols(char * cp1)
     Gate **		opp;
     unsigned short	debugMaskSave;
     Gate *		gp;
-    Gate *		np;
     int			index;
     long		value;
     int			fni;
@@ -3428,6 +3816,7 @@ receiveActiveSymbols(char * cp1)
      *  Send live data just in case there was also an input in this loop
      *  (should go straight to scan())
      *******************************************************************/
+    if (liveN) liveFlush();
     if (msgOffset > liveOffset) {
 	iC_send_msg_to_server(iC_sockFN, msgBuf);
     }
@@ -3446,7 +3835,7 @@ receiveActiveSymbols(char * cp1)
 	    fni == CH_AR ||
 	    fni == F_SW  ||
 	    fni == TRAB  )    ? gp->gt_new
-	    : fni == TIMRL    ? ((np = gp->gt_next) ? np->gt_mark : 0)
+	    : fni == TIMRL    ? Wh_count(gp->gt_wheel)
 	    : fni == OUTW     ? gp->gt_out
 	    : gp->gt_val < 0  ? 1
 			      : 0;
@@ -3460,6 +3849,7 @@ receiveActiveSymbols(char * cp1)
 	}
     }
     debugMask = debugMaskSave;
+    if (liveN) liveFlush();		/* initial values are not held back */
     /********************************************************************
      *  Send live data collected in msgBuf during RECEIVE_ACTIVE_SYMBOLS
      *  because scan() is only executed when another input occurs.
@@ -27,6 +27,12 @@ static const char link_c[] =
 unsigned short	iC_mark_stamp = 1;		/* incremented every combinatorial scan */
 Gate *		iC_osc_gp = NULL;		/* report oscillations */
 static short	warn_cnt = OSC_WARN_CNT;	/* limit the number of oscillator warnings */
+unsigned short	iC_levMax = 0;			/* highest logic level for levelized scan */
+Gate **		iC_levTail = NULL;		/* allocated in load.c only for levelized scan */
+#ifdef BLX
+static Gate *	blx0;				/* dummy back link until load.c allocates iC_blx */
+Gate **		iC_blx = &blx0;
+#endif	/* BLX */
 
 /* link a gate block into the output list */
 
@@ -37,11 +43,10 @@ iC_link_ol(
 {
     Gate *		tp;
     Gate *		np;
-#ifndef DEQ
     Gate *		ap;
-#endif	/* DEQ */
-    unsigned short	diff;
+    Gate **		ltp;
     int			tc;
+    int			lev;
 
 #ifdef TCP
     iC_linked++;
@@ -50,14 +55,36 @@ iC_link_ol(
 #if YYDEBUG && (!defined(_WINDOWS) || defined(LOAD))
 	iC_glit_cnt++;				/* count glitches */
 #endif	/* YYDEBUG && (!defined(_WINDOWS) || defined(LOAD)) */
+	if (out_list->gt_fni == TIMRL) {
+	    iC_wheelUnlink(gp, out_list);	/* timed action in wheel or on iC_cList */
+#if YYDEBUG && !defined(_WINDOWS)
+	    if (iC_debug & 0100) fprintf(iC_outFP, "g<");
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+	    return;
+	}
 #ifndef DEQ
+#ifdef BLX
+	if (gp->gt_idx) {
+	    /********************************************************************
+	     * constant time unlink with the back link kept in iC_blx[]
+	     * np is the head of the list gp was in if gp was last - which
+	     * is either out_list or its alternate list in gt_rptr.
+	     *******************************************************************/
+	    tp = Blx(gp);			/* glitch - previous */
+	    tp->gt_next = np = gp->gt_next;	/* previous ==> next */
+	    Blx(np) = tp;			/* previous <== next */
+	    gp->gt_next = 0;			/* unlink Gate */
+	    if (np == out_list || np == out_list->gt_rptr) {	/* last entry ? */
+		np->gt_ptr = tp;		/* adjust pointer */
+	    }
+	} else
+#endif	/* BLX */
+	{
 	ap = tp = out_list;			/* glitch */
-	diff = 0;				/* save time remaining */
 	while (tp->gt_next != gp) {		/* find previous entry */
 #if YYDEBUG && (!defined(_WINDOWS) || defined(LOAD))
 	    iC_glit_nxt++;			/* count glitch scan */
 #endif	/* YYDEBUG && (!defined(_WINDOWS) || defined(LOAD)) */
-	    diff += tp->gt_mark;		/* makes sense for TIMRL */
 	    if ((tp = tp->gt_next) == ap) {	/* end of one list */
 		/********************************************************************
 		 * find glitch in alternate list - rare
@@ -87,22 +114,30 @@ iC_link_ol(
 	}
 	np = tp->gt_next = gp->gt_next;		/* unlink from */
 	gp->gt_next = 0;			/* activity list */
+#ifdef BLX
+	Blx(np) = tp;				/* previous <== next */
+#endif	/* BLX */
 	if (np == ap) {				/* last entry ? */
 	    ap->gt_ptr = tp;			/* adjust pointer */
-	} else if (ap->gt_fni == TIMRL) {	/* correct timer list ? */
-	    np->gt_mark += gp->gt_mark;		/* adjust diff prev to old */
-	    gp->gt_mark += diff;		/* time remaining */
+	}
 	}
 #else	/* DEQ */
 	tp = gp->gt_prev;			/* glitch - previous */
 	tp->gt_next = np = gp->gt_next;		/* previous ==> next */
 	np->gt_prev = tp;			/* previous <== next */
 	gp->gt_next = gp->gt_prev = 0;		/* unlink Gate */
-	if (out_list->gt_fni == TIMRL) {	/* correct timer list ? */
-	    np->gt_mark += gp->gt_mark;		/* adjust diff prev to next */
-	    /* ignore time remaining in gp */
-	}
 #endif	/* DEQ */
+	if (out_list->gt_lev) {			/* levelized iC_aList or iC_oList */
+#if defined(DEQ) || defined(BLX)
+	    ap = out_list;
+	    if (Lev_tail(ap, gp->gt_lev) != gp) {
+		ap = ap->gt_rptr;		/* gp can only be last in alternate list */
+	    }
+#endif	/* DEQ || BLX */
+	    if (*(ltp = &Lev_tail(ap, gp->gt_lev)) == gp) {	/* gp was last of its level */
+		*ltp = (tp != ap && tp->gt_lev == gp->gt_lev) ? tp : 0;
+	    }
+	}
 #if YYDEBUG && !defined(_WINDOWS)
 	if (iC_debug & 0100) fprintf(iC_outFP, "g<");
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
@@ -165,64 +200,67 @@ iC_link_ol(
 		 * 'HI' action gate clocked by timer,delay (delay >= 1)
 		 * or alternate 'LO' action if preset time is 1 (TIMER1)
 		 * which is equivalent to normal clocking or SH, CHANGE or 'switch'.
-		 * Link action gate gp into list sorted by time order and then return.
-		 * For every tick of the timer the head of the sorted list will be
-		 * counted down until the head reaches 0, when that entry is unlinked
+		 * Link action gate gp into the timing wheel of the timer in constant
+		 * time and then return. Every tick of the timer advances the wheel.
+		 * When the delay of an entry has elapsed, that entry is unlinked
 		 * and put on iC_clist (iClock list). That is the timer clock event.
+		 * Entries due in the same tick keep the order in which they were linked.
 		 * Negative delays are treated like a 0 delay.
 		 *******************************************************************/
 #if YYDEBUG && !defined(_WINDOWS)
 		if (iC_debug & 0100) fprintf(iC_outFP, "!(%d)", tc);	/* delay time or preset time 1 */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-		tp = out_list;
-		diff = 0;
-		while ((np = tp->gt_next) != out_list &&
-		    (int)(diff += np->gt_mark) <= tc) {
-		    tp = np;				/* scan along time sorted list */
+		if (tc > 0xffff) {
+		    tc = 0xffff;			/* longest delay the wheel can time */
 		}
-#ifndef DEQ
-		tp->gt_next = gp;			/* old => new */
-		gp->gt_next = np;			/* new => next */
-		diff -= np->gt_mark;			/* full time to previous */
-		gp->gt_mark = tc - diff;		/* diff previous to new */
-		if (np != out_list) {
-		    np->gt_mark -= gp->gt_mark;		/* adjust diff new to old */
-		} else {
-		    out_list->gt_ptr = gp;		/* list => new */
-#ifndef NOCHECK
-		    /* check that algorithm is correct */
-		    if (out_list->gt_mark != 0) {
-			fprintf(iC_errFP,
-		    "\n%s: line %d: TIMER %s gt_mark is %d, should be 0)\n",
-			__FILE__, __LINE__, out_list->gt_ids, out_list->gt_mark);
-			iC_quit(SIGUSR1);
-		    }
-#endif	/* NOCHECK */
-		}
-#else	/* DEQ */
-		np->gt_prev = tp->gt_next = gp;		/* next, previous ==> new */
-		gp->gt_next = np;			/* new ==> next */
-		gp->gt_prev = tp;			/* previous <== new */
-		if (np != out_list) {
-		    diff -= np->gt_mark;		/* full time to previous */
-		}
-		gp->gt_mark = tc - diff;		/* diff previous to new */
-		np->gt_mark -= gp->gt_mark;		/* adjust diff new to old */
-		/* if np == out_list, out_list->gt_mark gets -diff */
-#endif	/* DEQ */
-#if defined(TCP) || defined(LOAD)
-		if (np == out_list) {
-		    iC_liveData(out_list, tc);		/* timer starting count to VCD and/or iClive (clears iC_linked) */
-		    iC_linked++;			/* iC_liveData() for timed Master Gate linked to timer */
-		}
-#endif /* defined(TCP) || defined(LOAD) */
-		return;					/* sorted link action complete */
+		iC_wheelLink(gp, out_list, tc);		/* link into timing wheel of timer */
+		return;					/* timed link action complete */
 	    }
 	}
 #if YYDEBUG && !defined(_WINDOWS)
 	if (iC_debug & 0100) putc('>', iC_outFP);
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
+	if (out_list->gt_lev) {
+	    /********************************************************************
+	     * levelized scan (-S option)
+	     * iC_aList and iC_oList and their alternates are kept sorted by the
+	     * logic level gt_lev, which load.c computed for each ARITH and GATE.
+	     * Gates of one level form a contiguous run whose last entry is held
+	     * in Lev_tail(). Link gp after the last Gate of its own level or of
+	     * the nearest lower level, else at the head of the list. The scan
+	     * removes entries from the head, so all inputs of a Gate have settled
+	     * before it is scanned, which avoids most glitches and relinks.
+	     *******************************************************************/
+	    lev = gp->gt_lev;
+	    ltp = &Lev_tail(out_list, 0);
+	    do {
+		if ((tp = ltp[lev]) != 0) break;	/* last of this or a lower level */
+	    } while (lev-- > 0);
+	    if (tp == 0) {
+		tp = out_list;				/* no lower level - link at head */
+	    }
+	    ltp[gp->gt_lev] = gp;			/* gp is now last of its level */
+	    np = tp->gt_next;
+#ifndef DEQ
+	    if (np == out_list) {
+		out_list->gt_ptr = gp;			/* list => new */
+	    }
+#ifdef BLX
+	    Blx(np) = gp;				/* new <== next */
+	    Blx(gp) = tp;				/* previous <== new */
+#endif	/* BLX */
+#else	/* DEQ */
+	    np->gt_prev = gp;				/* new <== next */
+	    gp->gt_prev = tp;				/* previous <== new */
+#endif	/* DEQ */
+	    tp->gt_next = gp;				/* previous => new */
+	    gp->gt_next = np;				/* new => next */
+	    return;
+	}
 #ifndef DEQ
+#ifdef BLX
+	Blx(gp) = out_list->gt_ptr;			/* old <== new */
+#endif	/* BLX */
 	out_list->gt_ptr->gt_next = gp;			/* old => new */
 	gp->gt_next = out_list;				/* new => list */
 	out_list->gt_ptr = gp;				/* list => new */
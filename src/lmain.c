@@ -243,6 +243,7 @@ main(
 	Symbol *	sp;
 	Symbol **	hsp;
 
+	sort_symlist();			/* list the symbol table in sorted order */
 #if YYDEBUG
 	if (iC_debug & 020) {
 	    fprintf(iC_outFP, "\nSYMBOL TABLE\n\n");
@@ -72,6 +72,9 @@ static int	termQuit(int sig);		/* clear and unexport RASPBERRYPI stuff */
 int		(*iC_term)(int) = &termQuit;	/* function pointer to clear and unexport RASPBERRYPI stuff */
 #endif	/* RASPBERRYPI */
 static short	errorFlag = 0;
+static short	levFlag = 0;		/* -S levelized scan */
+static short	arFlag = 0;		/* -A arithmetic dirty list */
+static short	bsFlag = 0;		/* -X bit parallel scan */
 
 static const char *	usage =
 "Usage: %s\n          [-"
@@ -82,9 +85,9 @@ static const char *	usage =
 "PGEBLIf"
 #endif	/* RASPBERRYPI */
 #ifdef	TCP
-"lqz"
+"bjlqrz"
 #endif	/* TCP */
-"h]"
+"ASh]"
 #ifdef	TCP
 #if	YYDEBUG && !defined(_WINDOWS)
 "[ -m[m]]"
@@ -93,7 +96,7 @@ static const char *	usage =
 #endif	/* TCP */
 "\n          "
 #ifdef	TCP
-"[ -e I|<equivalence>][ -v <file.vcd>]"
+"[ -e I|<equivalence>][ -v <file.vcd>][ -w <time>][ -y <time>]"
 #endif	/* TCP */
 "[ -n <count>][ -d <debug>]\n"
 #ifdef	RASPBERRYPI
@@ -108,6 +111,7 @@ static const char *	usage =
 "\n"
 #ifdef	TCP
 "    -s <host> IP address of iCserver   (default '%s')\n"
+"              or unix:<path> of a local iCserver's Unix domain socket\n"
 "    -p <port> service port of iCserver (default '%s')\n"
 "    -i <inst> instance of this client  (default '') or 1 to %d digits\n"
 "    -e <equivalence> eg: IX0=IX0-1     (can be used more than once)\n"
@@ -116,9 +120,29 @@ static const char *	usage =
 "              only IEC inputs can be equivalenced (see iCserver)\n"
 "    -e I      equivalence all IEC input names to the same names-<inst>\n"
 "    -v <file.vcd> output a .vcd and a .sav file for gtkwave\n"
+"    -b      exchange channel data with iCserver in binary frames\n"
+"            (negotiated at registration - ASCII with an older iCserver)\n"
+"    -j      send to iCserver from a separate sender thread, so a slow\n"
+"            iCserver does not hold up the scan - output values of the\n"
+"            same channel are combined while the sender is backed up\n"
+"    -r      receive and parse input from iCserver in a separate thread\n"
+"            all input values received since the last scan are handled\n"
+"            before the next scan\n"
+"    -w <time> input coalescing window eg: 200us 1ms (default 0 - off)\n"
+"            after input from iCserver, which changes inputs, further\n"
+"            input arriving within <time> is handled in the same scan\n"
+"    -y <time> live data refresh period for iClive eg: 20ms (default 0)\n"
+"            only the latest value of each live variable is sent once\n"
+"            per period - no limit in debug (step, next, breakpoint) mode\n"
 #endif	/* TCP */
 "    -n <count> maximum oscillator count (default is %d, limit 15)\n"
 "               0 allows unlimited oscillations\n"
+"    -S      levelized scan - scan arithmetic and logic gates in order of\n"
+"            their logic level, so most gates are only evaluated once\n"
+"    -A      evaluate each arithmetic expression only once after all\n"
+"            its changed inputs in an arithmetic scan have been handled\n"
+"    -X      bit parallel scan - evaluate AND and OR gates of pure logic\n"
+"            from words holding the values of all their inputs\n"
 #ifdef	TCP
 #ifdef	RASPBERRYPI
 "                      PIFACE and GPIO options\n"
@@ -244,7 +268,7 @@ static const char *	usage =
 #if	YYDEBUG && !defined(_WINDOWS)
 "    -o <debug_out>  debug output file (default stdout)\n"
 "    -d <debug>2000  display scan_cnt and link_cnt\n"
-"             +1000  do not trace non-active timers TX0.n\n"
+"             +1000  do not trace non-active timers TX0.n (always so now)\n"
 "              +400  exit after initialisation\n"
 "              +200  display oscillator info\n"
 "              +100  initialisation and run time trace\n"
@@ -262,7 +286,7 @@ static const char *	usage =
 "    -t      trace gate activity (equivalent to -d 1100)\n"
 "         t  at run time toggles gate activity trace\n"
 #ifdef	TCP
-"    -m      microsecond timing info\n"
+"    -m      microsecond timing info and TX0 timer latency\n"
 "    -mm     more microsecond timing (internal time base)\n"
 "         m  at run time toggles microsecond timing trace\n"
 #endif	/* TCP */
@@ -323,6 +347,28 @@ inError(int line, Gate * op, Gate * gp, const char* errMsg)
     errCount++;
 } /* inError */
 
+/********************************************************************
+ *
+ *  Sort one segment of an activity list
+ *
+ *  PASS 3 and PASS 5 store each entry by pre-decrement while going up
+ *  the sorted sTable, so every segment is in exactly reverse gt_ids
+ *  order. Reversing it sorts it without any compares.
+ *
+ *******************************************************************/
+
+static void
+sortList(Gate ** lp, Gate ** le)
+{
+    Gate *	gp;
+
+    while (lp < --le) {
+	gp = *lp;
+	*lp++ = *le;
+	*le = gp;
+    }
+} /* sortList */
+
 /********************************************************************
  *
  *  Main for the whole application
@@ -535,6 +581,31 @@ main(
 		    iC_micro++;		/* microsecond info */
 		    break;
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
+		case 'b':
+		    iC_opt_b = 1;	/* request binary channel data frames */
+		    break;
+		case 'j':
+		    iC_opt_j = 1;	/* separate sender thread */
+		    break;
+		case 'r':
+		    iC_opt_r = 1;	/* separate receive thread */
+		    break;
+		case 'w':
+		    if (! *++*argv) { --argc; if(! *++argv) goto missing; }
+		    if ((iC_opt_w = iC_usecs(*argv)) < 0) {
+			fprintf(iC_errFP, "ERROR: %s: '-w %s' is not a time up to 1s (eg 200us)\n",
+			    iC_progname, *argv);
+			errorFlag++;
+		    }
+		    goto break2;	/* input coalescing window */
+		case 'y':
+		    if (! *++*argv) { --argc; if(! *++argv) goto missing; }
+		    if ((iC_opt_y = iC_usecs(*argv)) < 0) {
+			fprintf(iC_errFP, "ERROR: %s: '-y %s' is not a time up to 1s (eg 20ms)\n",
+			    iC_progname, *argv);
+			errorFlag++;
+		    }
+		    goto break2;	/* live data refresh period */
 		case 'l':
 		    iC_opt_l = 1;	/* start iClive with correct source */
 #ifdef	RASPBERRYPI
@@ -616,6 +687,15 @@ main(
 		case 'q':
 		    iC_debug |= DQ;	/* -q    quiet operation of all apps and iCserver */
 		    break;
+		case 'A':
+		    arFlag = 1;		/* -A    evaluate arithmetic once per pass */
+		    break;
+		case 'S':
+		    levFlag = 1;	/* -S    levelized scan */
+		    break;
+		case 'X':
+		    bsFlag = 1;		/* -X    bit parallel scan */
+		    break;
 		case 'z':
 		    iC_debug |= DZ;	/* -z    block all STDIN interrupts for this app */
 		    break;
@@ -1749,7 +1829,36 @@ main(
 	exit(2);
     }
 
-    qsort(sTable, val, sizeof(Gate*), (iC_fptr)iC_cmp_gt_ids);	/* sort the whole symbol table */
+    /********************************************************************
+     *  A single module compiled with immcc -G links its Gates in gt_ids
+     *  order. They were entered after iClock and the I/O Gates generated
+     *  in PASS 0 (e_list). If they are in order, only these e_cnt + 1
+     *  leading entries are sorted and then merged with them in O(n)
+     *  compares. Any other symbol table is sorted with qsort(). Either
+     *  way the activity lists are placed in the same sorted order - the
+     *  fan-out order of -G only affects where the Gates are in memory.
+     *******************************************************************/
+    for (opp = sTable + e_cnt + 1; opp < sTend - 1; opp++) {
+	if (iC_cmp_gt_ids((const Gate**)opp, (const Gate**)opp + 1) >= 0) {
+	    break;					/* not sorted */
+	}
+    }
+    if (opp >= sTend - 1) {
+	qsort(sTable, e_cnt + 1, sizeof(Gate*), (iC_fptr)iC_cmp_gt_ids);	/* sort iClock and e_list only */
+	slp = tlp = (Gate **)iC_emalloc((e_cnt + 1) * sizeof(Gate *));
+	memcpy(slp, sTable, (e_cnt + 1) * sizeof(Gate *));
+	fp = sTable + e_cnt + 1;			/* compiled Gates in order */
+	for (opp = sTable; tlp < slp + e_cnt + 1; opp++) {
+	    if (fp < sTend && iC_cmp_gt_ids((const Gate**)fp, (const Gate**)tlp) < 0) {
+		*opp = *fp++;
+	    } else {
+		*opp = *tlp++;
+	    }
+	}					/* rest of compiled Gates is in place */
+	free(slp);
+    } else {
+	qsort(sTable, val, sizeof(Gate*), (iC_fptr)iC_cmp_gt_ids);	/* sort the whole symbol table */
+    }
 
 /********************************************************************
  *
@@ -2292,8 +2401,7 @@ main(
 		if (op->gt_fni < MIN_ACT) {
 		    tlp = lp = op->gt_list;		/* ARITH or GATE */
 		    while (*tlp++ != 0);		/* skip inputs */
-		    /* sort gate list */
-		    qsort(lp, tlp - lp - 1, sizeof(Gate*), (iC_fptr)iC_cmp_gt_ids);
+		    sortList(lp, tlp - 1);		/* sort gate list */
 		    if (df) {
 			while ((gp = *lp++) != 0) {
 			    if (gp->gt_ini == -ALIAS) {	/* resolve bit/int alias */
@@ -2307,8 +2415,7 @@ main(
 		    if (op->gt_fni == GATE || op->gt_fni == GATEX) {
 			lp = tlp;
 			while (*tlp++ != 0);		/* skip inputs */
-			/* sort gate list */
-			qsort(lp, tlp - lp - 1, sizeof(Gate*), (iC_fptr)iC_cmp_gt_ids);
+			sortList(lp, tlp - 1);		/* sort gate list */
 			if (df) {
 			    while ((gp = *lp++) != 0) {
 				if (gp->gt_ini == -ALIAS) {	/* resolve inverted bit alias */
@@ -2486,6 +2593,534 @@ main(
     if (errCount) {
 	exit(6);					/* pass 6 failed */
     }
+
+/********************************************************************
+ *
+ *  PASS 7 (only for levelized scan -S)
+ *
+ *  Determine the logic level of every ARITH and GATE node, which is
+ *  the longest combinatorial path to it from a node without ARITH or
+ *  GATE inputs. All forward lists gt_list are complete now.
+ *
+ *  First count the combinatorial inputs of each node in gt_lev.
+ *  Then take nodes with a count of 0 from a queue in breadth first
+ *  order and decrement the count of each of their targets. When the
+ *  count of a target reaches 0 it is queued with level source + 1.
+ *  gt_next, which is no longer needed for linking the nodes of each
+ *  module, marks the nodes which have been queued.
+ *
+ *  Nodes in a combinatorial feedback loop never reach a count of 0.
+ *  Such a loop is broken by queueing the first unqueued node in sTable
+ *  with a level one higher than any level so far. Self feedback of
+ *  LATCH nodes is not counted.
+ *
+ *  Levels are limited to LEV_MAX, the size of gt_lev. Deeper nodes share
+ *  the last level, which only affects the order in which they are
+ *  scanned, not the result.
+ *
+ *  Finally allocate one tail pointer per level for each levelized list.
+ *
+ *******************************************************************/
+
+#define Comb(gp) ((gp)->gt_ini != -ALIAS && (gp)->gt_list &&\
+	(gp)->gt_fni >= ARITH && (gp)->gt_fni < MIN_ACT)
+
+    if (levFlag) {
+	Gate **		qp;
+	Gate **		qe;
+	Gate **		queue;
+
+	if (df) { fprintf(iC_outFP, "PASS 7 - name level\n"); fflush(iC_outFP); }
+	for (opp = sTable; opp < sTend; opp++) {
+	    if (Comb(op = *opp)) {
+		op->gt_next = 0;			/* not queued */
+	    }
+	}
+	for (opp = sTable; opp < sTend; opp++) {
+	    if (Comb(op = *opp)) {
+		lp = op->gt_list;
+		i = op->gt_fni != ARITH;		/* GATE has normal and inverted lists */
+		do {
+		    while ((gp = *lp++) != 0) {
+			if (gp != op && Comb(gp)) {
+			    gp->gt_lev++;		/* count combinatorial inputs */
+			}
+		    }
+		} while (i-- > 0);
+	    }
+	}
+	if ((qp = qe = queue = (Gate **)calloc((unsigned)(sTend - sTable), sizeof(Gate *))) == NULL) {
+	    perror("calloc");
+	    iC_quit(SIGUSR1);			/* error quit */
+	}
+	for (opp = sTable; opp < sTend; opp++) {
+	    if (Comb(op = *opp) && op->gt_lev == 0) {
+		op->gt_next = op;			/* queued with level 0 */
+		*qe++ = op;
+	    }
+	}
+	opp = sTable;
+	for (;;) {
+	    while (qp < qe) {
+		op = *qp++;
+		if (op->gt_lev > iC_levMax) {
+		    iC_levMax = op->gt_lev;
+		}
+		lp = op->gt_list;
+		i = op->gt_fni != ARITH;
+		do {
+		    while ((gp = *lp++) != 0) {
+			if (gp != op && Comb(gp) && gp->gt_next == 0 &&
+			    --gp->gt_lev == 0) {
+			    gp->gt_lev = op->gt_lev < LEV_MAX ?	/* all inputs have a level */
+				op->gt_lev + 1 : LEV_MAX;
+			    gp->gt_next = gp;
+			    *qe++ = gp;
+			}
+		    }
+		} while (i-- > 0);
+	    }
+	    while (opp < sTend && (!Comb(*opp) || (*opp)->gt_next)) {
+		opp++;
+	    }
+	    if (opp >= sTend) {
+		break;					/* all nodes have a level */
+	    }
+	    op = *opp;					/* break feedback loop */
+	    op->gt_lev = iC_levMax < LEV_MAX ? iC_levMax + 1 : LEV_MAX;
+	    op->gt_next = op;
+	    *qe++ = op;
+	}
+	free(queue);
+	for (opp = sTable; opp < sTend; opp++) {
+	    if (Comb(op = *opp)) {
+		op->gt_next = 0;			/* clear queue marks */
+		if (df) fprintf(iC_outFP, " %-8s %3u\n", op->gt_ids, op->gt_lev);
+	    }
+	}
+	if (df) fprintf(iC_outFP, " %hu levels\n", iC_levMax + 1);
+	if ((iC_levTail = (Gate **)calloc(LEV_LISTS * (iC_levMax + 1), sizeof(Gate *))) == NULL) {
+	    perror("calloc");
+	    iC_quit(SIGUSR1);			/* error quit */
+	}
+    }
+    if (arFlag) {
+	/********************************************************************
+	 *  -A  allocate the dirty list for iC_scan_ar() - large enough to
+	 *  hold every node once, because gt_dirty stops duplicate entries
+	 *******************************************************************/
+	iC_arDirty = (Gate **)iC_emalloc(((sTend - sTable) + 1) * sizeof(Gate *));
+    }
+
+/********************************************************************
+ *
+ *  PASS 8 (only for bit parallel scan -X)
+ *
+ *  Select AND and OR nodes of ftype GATE, whose inputs all come from
+ *  logic, as members of the bit parallel scan. iC_scan_bs() evaluates
+ *  BS_BITS members at a time in one word of iC_bsVal[], rather than
+ *  counting each changed input of each member separately in iC_scan().
+ *
+ *  Kahn's algorithm orders the candidates, so that members which feed
+ *  other members come first. Candidates in a feedback loop never reach
+ *  a count of 0. Such a loop is broken by leaving out the first waiting
+ *  candidate, which then feeds the rest as an input. Candidates with
+ *  arithmetic input or without inputs are left out at the start.
+ *
+ *  Each member gets the level 1 higher than the highest member feeding
+ *  it. The members of one level are packed in sTable order into lanes
+ *  of words, which hold no other level. So no member in a word feeds
+ *  another member in the same word, and words are evaluated in order.
+ *  The member words are followed by a word which is always ONE and the
+ *  bits of all other nodes feeding members.
+ *
+ *  Input slot s of a word holds input s of every lane. Lanes with fewer
+ *  inputs and unused lanes take ONE. A slot is gathered from BitTerms,
+ *  each rotating one word of iC_bsVal[], so that the inputs of some
+ *  lanes line up with those lanes. Nets built from regular arrays need
+ *  few BitTerms per slot. The word of new values is the AND of all
+ *  slots, each with its inverted lanes flipped. An OR is evaluated as
+ *  an inverted AND of inverted inputs. Unused lanes evaluate to ONE and
+ *  start as ONE, so they never change.
+ *
+ *  The candidate number, then the member number and finally the bit of
+ *  each member is kept in gt_new, which AND and OR of ftype GATE do not
+ *  use. iC_bsInit() clears it, after removing members from the forward
+ *  lists once the 4 Passes in iC_icc() have initialised all Gates.
+ *
+ *******************************************************************/
+
+#define BsCand(gp) ((gp)->gt_fni == GATE && (gp)->gt_mcnt == 0 && (gp)->gt_list &&\
+	((gp)->gt_ini == -AND || (gp)->gt_ini == -OR))
+#define BsMem(gp) (BsCand(gp) && (gp)->gt_new > 0)
+#define BsOut(gp) ((gp)->gt_ini != -ALIAS && (gp)->gt_list &&\
+	((gp)->gt_fni == GATE || (gp)->gt_fni == GATEX))
+
+    if (bsFlag) {
+	Gate **		cg;		/* candidates in sTable order */
+	int *		cnt;		/* count of inputs of each candidate */
+	char *		st;		/* 0 waiting, 1 queued, 2 left out */
+	Gate **		qp;
+	Gate **		qe;
+	Gate **		queue;
+	int *		lev;		/* level of each member */
+	int *		lx;		/* first member of each level */
+	int *		eIx;		/* first input of each member bit in eNode */
+	int *		eNode;		/* input bit * 2 + inversion */
+	BitTerm *	tp;
+	BitTerm *	tb;
+	int		nc = 0;
+	int		nm;
+	int		nl;
+	int		nw;
+	int		nb;
+	int		ne;
+	int		ns;
+	int		one;
+	int		b;
+	int		j;
+	int		k;
+	int		m;
+	int		s;
+	int		w;
+
+	if (df) { fprintf(iC_outFP, "PASS 8 - bit scan\n"); fflush(iC_outFP); }
+	for (opp = sTable; opp < sTend; opp++) {
+	    if (BsCand(op = *opp)) {
+		op->gt_new = ++nc;			/* candidate number */
+	    }
+	}
+	cg = (Gate **)iC_emalloc((nc + 1) * sizeof(Gate *));
+	cnt = (int *)iC_emalloc((nc + 1) * sizeof(int));
+	st = (char *)iC_emalloc((nc + 1) * sizeof(char));
+	for (opp = sTable; opp < sTend; opp++) {
+	    if (BsCand(op = *opp)) {
+		cg[op->gt_new - 1] = op;
+	    } else if (op->gt_ini != -ALIAS && op->gt_list && op->gt_fni == ARITH) {
+		for (lp = op->gt_list; (gp = *lp++) != 0; ) {
+		    if (BsCand(gp)) {
+			st[gp->gt_new - 1] = 2;		/* arithmetic input - left out */
+		    }
+		}
+	    } else if (BsOut(op)) {
+		lp = op->gt_list;
+		i = 1;					/* GATE has normal and inverted lists */
+		do {
+		    while ((gp = *lp++) != 0) {
+			if (BsCand(gp)) {
+			    cnt[gp->gt_new - 1]++;	/* count inputs from logic */
+			}
+		    }
+		} while (i-- > 0);
+	    }
+	}
+	for (k = 0; k < nc; k++) {
+	    op = cg[k];
+	    lp = op->gt_list;
+	    i = 1;
+	    do {
+		while ((gp = *lp++) != 0) {
+		    if (BsCand(gp)) {
+			cnt[gp->gt_new - 1]++;		/* count inputs from candidates */
+		    }
+		}
+	    } while (i-- > 0);
+	}
+	for (k = 0; k < nc; k++) {
+	    if (cnt[k] == 0) {
+		st[k] = 2;				/* no inputs - left out */
+	    }
+	    cnt[k] = 0;
+	}
+	for (k = 0; k < nc; k++) {
+	    if (st[k] == 0) {
+		lp = cg[k]->gt_list;
+		i = 1;
+		do {
+		    while ((gp = *lp++) != 0) {
+			if (BsCand(gp) && st[gp->gt_new - 1] == 0) {
+			    cnt[gp->gt_new - 1]++;	/* count inputs from waiting candidates */
+			}
+		    }
+		} while (i-- > 0);
+	    }
+	}
+	qp = qe = queue = (Gate **)iC_emalloc((nc + 1) * sizeof(Gate *));
+	for (k = 0; k < nc; k++) {
+	    if (st[k] == 0 && cnt[k] == 0) {
+		st[k] = 1;				/* queued */
+		*qe++ = cg[k];
+	    }
+	}
+	k = 0;
+	for (;;) {
+	    if (qp < qe) {
+		op = *qp++;				/* all candidate inputs queued before */
+	    } else {
+		while (k < nc && st[k] != 0) {
+		    k++;
+		}
+		if (k >= nc) {
+		    break;				/* all candidates queued or left out */
+		}
+		st[k] = 2;				/* break feedback loop */
+		op = cg[k];
+	    }
+	    lp = op->gt_list;
+	    i = 1;
+	    do {
+		while ((gp = *lp++) != 0) {
+		    if (BsCand(gp) && st[gp->gt_new - 1] == 0 &&
+			--cnt[gp->gt_new - 1] == 0) {
+			st[gp->gt_new - 1] = 1;
+			*qe++ = gp;
+		    }
+		}
+	    } while (i-- > 0);
+	}
+	nm = qe - queue;
+	for (k = 0; k < nc; k++) {
+	    cg[k]->gt_new = 0;				/* left out unless member */
+	}
+	for (m = 0; m < nm; m++) {
+	    queue[m]->gt_new = m + 1;			/* member in topological order */
+	}
+	free(st);
+	free(cnt);
+	free(cg);
+	if (nm) {
+	    /********************************************************************
+	     *  level of each member - members are in topological order
+	     *******************************************************************/
+	    lev = (int *)iC_emalloc(nm * sizeof(int));
+	    nl = 0;
+	    for (m = 0; m < nm; m++) {
+		lp = queue[m]->gt_list;
+		i = 1;
+		do {
+		    while ((gp = *lp++) != 0) {
+			if (BsMem(gp) && lev[gp->gt_new - 1] <= lev[m]) {
+			    lev[gp->gt_new - 1] = lev[m] + 1;
+			}
+		    }
+		} while (i-- > 0);
+		if (lev[m] >= nl) {
+		    nl = lev[m] + 1;
+		}
+	    }
+	    /********************************************************************
+	     *  sort members by level, keeping sTable order in each level
+	     *******************************************************************/
+	    lx = (int *)iC_emalloc((nl + 1) * sizeof(int));
+	    for (m = 0; m < nm; m++) {
+		lx[lev[m] + 1]++;
+	    }
+	    for (k = 0; k < nl; k++) {
+		lx[k + 1] += lx[k];
+	    }
+	    qp = queue;
+	    queue = (Gate **)iC_emalloc(nm * sizeof(Gate *));
+	    for (opp = sTable; opp < sTend; opp++) {
+		if (BsMem(op = *opp)) {
+		    queue[lx[lev[op->gt_new - 1]]++] = op;
+		}
+	    }
+	    free(qp);
+	    /********************************************************************
+	     *  pack each level into words - lx[k] is now the end of level k
+	     *******************************************************************/
+	    for (nw = k = m = 0; k < nl; k++) {
+		b = 0;
+		for ( ; m < lx[k]; m++) {
+		    if (b % BS_BITS == 0) {
+			nw++;				/* new word for this level */
+		    }
+		    queue[m]->gt_new = (nw - 1) * BS_BITS + b % BS_BITS + 1;	/* bit + 1 */
+		    b++;
+		}
+	    }
+	    free(lx);
+	    free(lev);
+	    one = nw * BS_BITS;				/* word which is always ONE */
+	    iC_bsGate = (Gate **)iC_emalloc((one + BS_BITS + (sTend - sTable)) * sizeof(Gate *));
+	    for (m = 0; m < nm; m++) {
+		iC_bsGate[queue[m]->gt_new - 1] = queue[m];
+	    }
+	    nb = one + BS_BITS;
+	    for (opp = sTable; opp < sTend; opp++) {
+		if (BsOut(op = *opp) && !BsMem(op)) {
+		    lp = op->gt_list;
+		    i = 1;
+		    j = 0;
+		    do {
+			while ((gp = *lp++) != 0) {
+			    if (BsMem(gp)) {
+				j = 1;			/* feeds a member */
+			    }
+			}
+		    } while (i-- > 0);
+		    if (j) {
+			iC_bsGate[nb++] = op;
+		    }
+		}
+	    }
+	    iC_bsWords = nw;
+	    iC_bsBits = nb;
+	    /********************************************************************
+	     *  collect the inputs of each member and the member words fed by
+	     *  each bit - inputs of a member are in bit order
+	     *******************************************************************/
+	    eIx = (int *)iC_emalloc((one + 1) * sizeof(int));
+	    for (ne = j = 0; j < nb; j++) {
+		if ((op = iC_bsGate[j]) != 0) {
+		    lp = op->gt_list;
+		    i = 1;
+		    do {
+			while ((gp = *lp++) != 0) {
+			    if (BsMem(gp)) {
+				eIx[gp->gt_new]++;	/* count in next entry */
+				ne++;
+			    }
+			}
+		    } while (i-- > 0);
+		}
+	    }
+	    for (b = 0; b < one; b++) {
+		eIx[b + 1] += eIx[b];
+	    }
+	    eNode = (int *)iC_emalloc((ne + 1) * sizeof(int));
+	    iC_bsFanIx = (int *)iC_emalloc((nb + 1) * sizeof(int));
+	    iC_bsFan = (int *)iC_emalloc((ne + 1) * sizeof(int));
+	    for (k = j = 0; j < nb; j++) {
+		iC_bsFanIx[j] = k;
+		if ((op = iC_bsGate[j]) != 0) {
+		    lp = op->gt_list;
+		    inversion = 0;
+		    do {
+			while ((gp = *lp++) != 0) {
+			    if (BsMem(gp)) {
+				b = gp->gt_new - 1;
+				eNode[eIx[b]++] = j << 1 | inversion;
+				w = b / BS_BITS;
+				for (m = iC_bsFanIx[j]; m < k; m++) {
+				    if (iC_bsFan[m] == w) {
+					break;		/* member word already fed */
+				    }
+				}
+				if (m == k) {
+				    iC_bsFan[k++] = w;
+				}
+			    }
+			}
+		    } while (inversion++ == 0);
+		}
+	    }
+	    iC_bsFanIx[nb] = k;
+	    for (b = one; b > 0; b--) {
+		eIx[b] = eIx[b - 1];			/* restore first input */
+	    }
+	    eIx[0] = 0;
+	    /********************************************************************
+	     *  input slots of each word - a slot has at most one BitTerm for
+	     *  each lane with an input and one for all lanes taking ONE
+	     *******************************************************************/
+	    iC_bsSlotIx = (int *)iC_emalloc((nw + 1) * sizeof(int));
+	    for (w = 0; w < nw; w++) {
+		for (ns = 0, b = w * BS_BITS; b < (w + 1) * BS_BITS; b++) {
+		    if (eIx[b + 1] - eIx[b] > ns) {
+			ns = eIx[b + 1] - eIx[b];
+		    }
+		}
+		iC_bsSlotIx[w + 1] = iC_bsSlotIx[w] + ns;
+	    }
+	    ns = iC_bsSlotIx[nw];
+	    iC_bsInv = (unsigned long *)iC_emalloc((ns + 1) * sizeof(unsigned long));
+	    iC_bsOr = (unsigned long *)iC_emalloc((nw + 1) * sizeof(unsigned long));
+	    iC_bsTermIx = (int *)iC_emalloc((ns + 1) * sizeof(int));
+	    iC_bsTerm = (BitTerm *)iC_emalloc((ne + ns + 1) * sizeof(BitTerm));
+	    tp = iC_bsTerm;
+	    for (w = 0; w < nw; w++) {
+		for (b = w * BS_BITS; b < (w + 1) * BS_BITS; b++) {
+		    if ((op = iC_bsGate[b]) != 0 && op->gt_ini == -OR) {
+			iC_bsOr[w] |= 1UL << (b % BS_BITS);
+		    }
+		}
+		for (s = iC_bsSlotIx[w]; s < iC_bsSlotIx[w + 1]; s++) {
+		    iC_bsTermIx[s] = tp - iC_bsTerm;
+		    for (b = w * BS_BITS; b < (w + 1) * BS_BITS; b++) {
+			k = s - iC_bsSlotIx[w] + eIx[b];	/* input of this lane */
+			if (k < eIx[b + 1]) {
+			    j = eNode[k] >> 1;
+			    if ((eNode[k] & 1) ^ ((iC_bsOr[w] >> (b % BS_BITS)) & 1)) {
+				iC_bsInv[s] |= 1UL << (b % BS_BITS);
+			    }
+			} else {
+			    j = one + b % BS_BITS;	/* no input or unused lane */
+			}
+			m = (b % BS_BITS - j % BS_BITS + BS_BITS) % BS_BITS;	/* rotation */
+			for (tb = &iC_bsTerm[iC_bsTermIx[s]]; tb < tp; tb++) {
+			    if (tb->bt_word == j / BS_BITS && tb->bt_rot == m) {
+				break;			/* lines up with earlier lanes */
+			    }
+			}
+			if (tb == tp) {
+			    tp->bt_word = j / BS_BITS;	/* new BitTerm */
+			    tp++->bt_rot = m;
+			}
+			tb->bt_mask |= 1UL << (b % BS_BITS);
+		    }
+		}
+	    }
+	    iC_bsTermIx[ns] = tp - iC_bsTerm;
+	    iC_bsVal = (unsigned long *)iC_emalloc(((nb + BS_BITS - 1) / BS_BITS) * sizeof(unsigned long));
+	    iC_bsDirty = (unsigned long *)iC_emalloc(((nw + BS_BITS - 1) / BS_BITS) * sizeof(unsigned long));
+	    if (df) {
+		for (b = 0; b < one; b++) {
+		    if ((op = iC_bsGate[b]) != 0) {
+			fprintf(iC_outFP, " %-8s %3d.%-2d %c", op->gt_ids,
+			    b / BS_BITS, b % BS_BITS, iC_os[-op->gt_ini]);
+			for (k = eIx[b]; k < eIx[b + 1]; k++) {
+			    fprintf(iC_outFP, " %s%s", eNode[k] & 1 ? "~" : "",
+				iC_bsGate[eNode[k] >> 1]->gt_ids);
+			}
+			fprintf(iC_outFP, "\n");
+		    }
+		}
+		fprintf(iC_outFP, " %d members in %d words, %d inputs, %d slots, %d terms\n",
+		    nm, nw, nb - one - BS_BITS, ns, iC_bsTermIx[ns]);
+	    }
+	    free(eNode);
+	    free(eIx);
+	}
+	free(queue);
+    }
+#ifdef BLX
+
+/********************************************************************
+ *
+ *  Index every node in sTable for its back link in iC_blx[], which
+ *  iC_link_ol() uses to unlink a glitch in constant time. Index 0 is
+ *  shared by the list heads alist0 ... olist1, iC_fList and iC_sList,
+ *  which are not in sTable and are never unlinked. Nodes beyond BLX_MAX,
+ *  the size of gt_idx, also keep index 0 and find a glitch by walking
+ *  the list as without BLX. This is reported, because the unlink time
+ *  for those nodes grows with the length of their list.
+ *
+ *******************************************************************/
+
+    if ((i = sTend - sTable) > BLX_MAX) {
+	fprintf(iC_errFP, "WARNING: %s: %d nodes - only the first %d have a BLX back link index,\n"
+	    "         the rest are unlinked by walking their list\n", iC_progname, i, BLX_MAX);
+	i = BLX_MAX;
+    }
+    if ((iC_blx = (Gate **)calloc((unsigned)i + 1, sizeof(Gate *))) == NULL) {
+	perror("calloc");
+	iC_quit(SIGUSR1);			/* error quit */
+    }
+    for (opp = sTable; opp < sTable + i; opp++) {
+	(*opp)->gt_idx = opp - sTable + 1;
+    }
+#endif	/* BLX */
 #ifdef	RASPBERRYPI
     if (iC_opt_P) {
 	/********************************************************************
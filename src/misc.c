@@ -92,6 +92,14 @@ char *		rpyBuf;
 
 #ifndef	PWM
 int		iC_opt_l;
+int		iC_opt_b;		/* request binary channel data frames */
+int		iC_opt_j;		/* send to iCserver from a separate sender thread */
+int		iC_opt_r;		/* receive from iCserver in a separate receive thread */
+long		iC_opt_w;		/* input coalescing window in microseconds */
+unsigned long	iC_winScans;		/* scans which opened a -w window */
+unsigned long	iC_winSaved;		/* scans saved by absorbing input in a -w window */
+long		iC_opt_y;		/* live data refresh period in microseconds */
+unsigned long	iC_liveSaved;		/* live data updates suppressed by -y */
 #ifdef	RASPBERRYPI
 int		iC_opt_P;
 int		iC_opt_G;
@@ -109,6 +117,34 @@ gpioIO *	iC_gpL[2];		/* GPIO names/gates and channels */
 #include	<time.h>
 static struct timespec	ms200 = { 0, 200000000, };
 #endif	/* defined(LOAD) && ! defined(_WIN32) */
+
+/********************************************************************
+ *
+ *	Convert a time with an optional unit us, ms or s to microseconds
+ *	    str		eg: "200us", "0.5ms" or "200" (default unit us)
+ *
+ *	Returns -1 for a malformed time or one longer than 1 second
+ *
+ *******************************************************************/
+
+long
+iC_usecs(const char * str)
+{
+    char *	ep;
+    double	t;
+
+    t = strtod(str, &ep);
+    if (ep == str || t < 0.0) return -1;
+    if (strcmp(ep, "ms") == 0) {
+	t *= 1000.0;
+    } else if (strcmp(ep, "s") == 0) {
+	t *= 1000000.0;
+    } else if (*ep != '\0' && strcmp(ep, "us") != 0) {
+	return -1;			/* unknown unit */
+    }
+    if (t > 1000000.0) return -1;
+    return (long)(t + 0.5);
+} /* iC_usecs */
 #ifdef	RASPBERRYPI
 
 /********************************************************************
@@ -342,9 +378,12 @@ iC_fork_and_exec(char ** argv)
     /* continue parent process with extended privileges */
 } /* iC_fork_and_exec */
 
+#endif /* defined(RUN) || defined (TCP) || defined(LOAD) */
+
 /********************************************************************
  *
  *  Compare gt_ids in two Gates support of qsort()
+ *  also used by immcc -G to link Gates in the same order
  *
  *  change the collating position of '_' before digits ('.' '/')
  *  change all '_' to '/' to get correct ordering (/ never occurs in C variable)
@@ -393,6 +432,7 @@ iC_cmp_gt_ids( const Gate ** a, const Gate ** b)
     }
     return( strverscmp(ap, bp) );
 } /* iC_cmp_gt_ids */
+#if defined(RUN) || defined (TCP) || defined(LOAD)
 
 /********************************************************************
  *
@@ -435,6 +475,19 @@ iC_quit(int sig)
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
     }
 #ifdef	TCP
+#ifndef	_WIN32
+    iC_stop_sender();				/* send queued messages before the following */
+#endif	/* _WIN32 */
+#ifndef	PWM
+    if (iC_opt_w && ((iC_debug & 04) || (iC_winSaved && (iC_debug & DQ) == 0))) {
+	fprintf(iC_errFP, "%s: -w %ld us: %lu windows, %lu scans saved\n",
+	    iC_iccNM, iC_opt_w, iC_winScans, iC_winSaved);
+    }
+    if (iC_opt_y && ((iC_debug & 04) || (iC_liveSaved && (iC_debug & DQ) == 0))) {
+	fprintf(iC_errFP, "%s: -y %ld us: %lu live data updates suppressed\n",
+	    iC_iccNM, iC_opt_y, iC_liveSaved);
+    }
+#endif	/* PWM */
     if (iC_sockFN > 0) {
 	if (sig <= SIGUSR2 || sig == QUIT_TERMINAL || sig == QUIT_DEBUGGER) {	/* but not QUIT_SERVER */
 #ifdef	LOAD
@@ -46,6 +46,23 @@ typedef struct OverFlow {		/* allow alternate storage of Symbol or List_e pointe
 } OverFlow;
 static OverFlow *	szList = NULL;		/* dynamic auxiliary input gate list for iC_listNet */
 static int		szSize = 0;		/* allocated size of szList */
+
+typedef struct Term {			/* one input of an AND or OR gate for collectGates() */
+    int		c;			/* index of the gate in cdList */
+    Symbol *	sp;			/* input gate */
+    unsigned int	val;			/* NOT if input is inverted */
+} Term;
+typedef struct Cand {			/* AND or OR gate which may be merged or removed */
+    Symbol *	sp;			/* the gate */
+    int		start;			/* first input in tmList */
+    int		cnt;			/* number of inputs */
+    int		bad;			/* input from other than a simple bit gate */
+    int		ref;			/* referenced by ALIAS, C fragment or function */
+} Cand;
+static Term *		tmList = NULL;		/* inputs of candidate gates for collectGates() */
+static int		tmSize = 0;		/* allocated size of tmList */
+static Cand *		cdList = NULL;		/* candidate gates for collectGates() */
+static int		cdSize = 0;		/* allocated size of cdList */
 static char *		iC_ext_type[]  = { iC_EXT_TYPE };
 static char *		iC_ext_ftype[] = { iC_EXT_FTYPE };
 
@@ -320,8 +337,7 @@ out_link(List_e * lp, int * picnt, int * pbcnt, int * pvcnt, int vflag, int pass
 		assert(vflag == 0 && headNM);
 		snprintf(auxName, TSIZE, "&%sa_%d", headNM, acnt);
 		acnt++;
-		sp->name = iC_emalloc(strlen(auxName));	/* already 1 byte longer */
-		strcpy(sp->name, auxName+1);	/* pass name without leading '&' */
+		sp->name = new_name(auxName+1);	/* pass name without leading '&' */
 		for (i = 0; i < *pvcnt; i++) {
 		    if (sp == vsp[i]) {		/* find var list entry among possibly several */
 			snprintf(auxTlnk, TSIZE, "(char*)&l[%d]", vlink[i]);	/* transfer to t_first */
@@ -460,6 +476,549 @@ out_builtin(List_e * lp, int * picnt)
 } /* out_builtin */
 
 #endif	/* BOOT_COMPILE */
+/********************************************************************
+ *
+ *	Compare functions for mergeGates()
+ *
+ *	cmp_term() sorts the inputs of each candidate gate by name and
+ *	inversion, so that the input sets of two gates can be compared.
+ *	cmp_cand() sorts candidate gates by type and input set. Gates with
+ *	the same signature are adjacent and in Symbol Table order.
+ *
+ *******************************************************************/
+
+static int
+cmp_term(const void * a, const void * b)
+{
+    const Term *	ta = (const Term *)a;
+    const Term *	tb = (const Term *)b;
+    int			r;
+
+    if (ta->c != tb->c) {
+	return ta->c < tb->c ? -1 : 1;
+    }
+    if ((r = strcmp(ta->sp->name, tb->sp->name)) != 0) {
+	return r;
+    }
+    return ta->val < tb->val ? -1 : ta->val > tb->val ? 1 : 0;
+} /* cmp_term */
+
+static int
+cmp_sig(const Cand * ca, const Cand * cb)
+{
+    int		i;
+    Term *	ta;
+    Term *	tb;
+
+    if (ca->sp->type != cb->sp->type) {
+	return ca->sp->type < cb->sp->type ? -1 : 1;
+    }
+    if (ca->cnt != cb->cnt) {
+	return ca->cnt < cb->cnt ? -1 : 1;
+    }
+    ta = &tmList[ca->start];
+    tb = &tmList[cb->start];
+    for (i = 0; i < ca->cnt; i++, ta++, tb++) {
+	if (ta->sp != tb->sp) {
+	    return strcmp(ta->sp->name, tb->sp->name);
+	}
+	if (ta->val != tb->val) {
+	    return ta->val < tb->val ? -1 : 1;
+	}
+    }
+    return 0;
+} /* cmp_sig */
+
+static int
+cmp_cand(const void * a, const void * b)
+{
+    const Cand *	ca = *(const Cand **)a;
+    const Cand *	cb = *(const Cand **)b;
+    int			r;
+
+    if ((r = cmp_sig(ca, cb)) != 0) {
+	return r;
+    }
+    return ca < cb ? -1 : ca > cb ? 1 : 0;	/* Symbol Table order */
+} /* cmp_cand */
+
+/********************************************************************
+ *
+ *	Test if a gate name is compiler generated like QX0.0_1 or a_12
+ *
+ *******************************************************************/
+
+static int
+isTemp(char * name)
+{
+    char *	cp;
+
+    if ((cp = strrchr(name, '_')) == 0 || cp == name || *++cp == '\0') {
+	return 0;
+    }
+    while (isdigit((unsigned char)*cp)) cp++;
+    return *cp == '\0';
+} /* isTemp */
+
+/********************************************************************
+ *
+ *	Collect all simple AND and OR bit gates as candidates for merging,
+ *	constant folding and dead gate removal in cdList and their inputs
+ *	in tmList sorted by candidate. The index + 1 of each candidate is
+ *	left in u_val (cleared in iC_listNet()) - to be cleared by the caller.
+ *
+ *	bad is set for a gate with inputs other than simple bit gates,
+ *	which includes references from C fragments and function blocks.
+ *	ref is set for bad gates and for the original of an ALIAS.
+ *
+ *	Return the number of candidates - the number of inputs in *tmCntp.
+ *
+ *******************************************************************/
+
+static int
+collectGates(int * tmCntp)
+{
+    Symbol **	hsp;
+    Symbol *	sp;
+    Symbol *	tsp;
+    List_e *	lp;
+    Cand *	cp;
+    Term *	tp;
+    int		cdCnt = 0;
+    int		tmCnt = 0;
+    int		i;
+
+    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
+	for (sp = *hsp; sp; sp = sp->next) {
+	    if ((sp->type == AND || sp->type == OR) && sp->ftype == GATE &&
+		(sp->fm & FM) == 0 && (sp->em & EM) == 0) {
+		if (cdCnt >= cdSize) {
+		    cdList = (Cand*)realloc(cdList,	/* initially NULL */
+			(cdSize + SZSIZE) * sizeof(Cand));
+		    assert(cdList);
+		    cdSize += SZSIZE;
+		}
+		cp = &cdList[cdCnt];
+		cp->sp = sp;
+		cp->start = cp->cnt = cp->bad = cp->ref = 0;
+		sp->u_val = ++cdCnt;		/* index + 1 of candidate */
+	    }
+	}
+    }
+    /********************************************************************
+     *  Collect the inputs of all candidate gates from the forward lists
+     *  ALIAS only points to its original - not an input
+     *******************************************************************/
+    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
+	for (sp = *hsp; sp; sp = sp->next) {
+	    for (lp = sp->list; lp; lp = lp->le_next) {
+		if ((tsp = lp->le_sym) == 0 || tsp->type >= MAX_LS || tsp->u_val == 0) {
+		    continue;			/* not a candidate */
+		}
+		cp = &cdList[tsp->u_val - 1];
+		if (sp->type == ALIAS) {
+		    cp->ref = 1;		/* original of an ALIAS */
+		    continue;
+		}
+		if (sp->ftype != GATE || sp->type >= MAX_LS || (sp->fm & FM) != 0) {
+		    cp->bad = cp->ref = 1;	/* not a simple bit input */
+		    continue;
+		}
+		if (tmCnt >= tmSize) {
+		    tmList = (Term*)realloc(tmList,	/* initially NULL */
+			(tmSize + SZSIZE * 4) * sizeof(Term));
+		    assert(tmList);
+		    tmSize += SZSIZE * 4;
+		}
+		tp = &tmList[tmCnt++];
+		tp->c = tsp->u_val - 1;
+		tp->sp = sp;
+		tp->val = lp->le_val;
+	    }
+	}
+    }
+    qsort(tmList, tmCnt, sizeof(Term), cmp_term);
+    for (i = 0; i < tmCnt; i++) {
+	cp = &cdList[tmList[i].c];
+	if (cp->cnt++ == 0) {
+	    cp->start = i;
+	}
+    }
+    *tmCntp = tmCnt;
+    return cdCnt;
+} /* collectGates */
+
+/********************************************************************
+ *
+ *	Merge identical AND and OR gates (structural hashing) for -O10
+ *
+ *	Two bit gates are identical if they have the same type and the
+ *	same set of inputs with the same inversion pattern. The second
+ *	gate is changed to an ALIAS of the first, as if it had been
+ *	written 'imm bit b = a;', and its outputs are moved to the first.
+ *	This is often the case for terms repeated in FOR expanded iCa code.
+ *
+ *	Gates in function definitions and extern gates are not candidates.
+ *	Gates with an input which is not a simple bit gate (bad in
+ *	collectGates()), gates without inputs and unused gates are not
+ *	merged at all. A gate with EX, EA or EU set in em (extern or immC)
+ *	is never changed to an ALIAS - it is kept and identical gates are
+ *	merged into it.
+ *
+ *	Merging changes the inputs of the gates driven by a merged gate,
+ *	which may now be identical too - so repeat until nothing changes.
+ *
+ *	Return the number of gates merged.
+ *
+ *******************************************************************/
+
+static int
+mergeGates(void)
+{
+    Symbol *	sp;
+    Symbol *	tsp;
+    Symbol *	gsp;
+    List_e *	lp;
+    List_e *	nlp;
+    List_e *	tlp;
+    List_e **	lpp;
+    Cand **	order;
+    Cand *	cp;
+    Cand *	rp;
+    Term *	tp;
+    int		cdCnt;
+    int		tmCnt;
+    int		i, j, k, m;
+    int		merged = 0;
+    int		pass;
+
+    do {
+	pass = 0;
+	cdCnt = collectGates(&tmCnt);
+	/********************************************************************
+	 *  Sort the candidates with inputs - identical gates are adjacent
+	 *******************************************************************/
+	order = (Cand**)iC_emalloc((cdCnt + 1) * sizeof(Cand*));
+	for (i = j = 0; i < cdCnt; i++) {
+	    cdList[i].sp->u_val = 0;	/* restore u_val */
+	    if (cdList[i].bad == 0 && cdList[i].cnt > 0 &&
+		cdList[i].sp->list != 0) {	/* keep unused gate for warning */
+		order[j++] = &cdList[i];
+	    }
+	}
+	qsort(order, j, sizeof(Cand*), cmp_cand);
+	for (i = 0; i < j; i = k) {
+	    for (k = i + 1; k < j && cmp_sig(order[i], order[k]) == 0; k++);
+	    if (k - i < 2) continue;	/* no identical gate */
+	    /********************************************************************
+	     *  A gate which is one of its own inputs is not merged (feedback)
+	     *******************************************************************/
+	    for (tp = &tmList[order[i]->start]; tp < &tmList[order[i]->start + order[i]->cnt]; tp++) {
+		for (m = i; m < k && order[m]->sp != tp->sp; m++);
+		if (m < k) break;
+	    }
+	    if (tp < &tmList[order[i]->start + order[i]->cnt]) continue;
+	    /********************************************************************
+	     *  Keep the first gate used in C code or extern immC - else the
+	     *  first gate with a name which is not compiler generated like
+	     *  QX0.0_1 - else the first gate
+	     *******************************************************************/
+	    for (m = i; m < k && (order[m]->sp->em & (EX|EA|EU)) == 0; m++);
+	    if (m >= k) {
+		for (m = i; m < k && isTemp(order[m]->sp->name); m++);
+	    }
+	    rp = order[m < k ? m : i];
+	    gsp = rp->sp;
+	    for (m = i; m < k; m++) {
+		cp = order[m];
+		if (cp == rp || (cp->sp->em & (EX|EA|EU)) != 0) continue;
+		sp = cp->sp;			/* gate to be merged into gsp */
+		/********************************************************************
+		 *  Remove the links from the inputs to the merged gate
+		 *******************************************************************/
+		for (tp = &tmList[cp->start]; tp < &tmList[cp->start + cp->cnt]; tp++) {
+		    for (lpp = &tp->sp->list; (lp = *lpp) != 0; ) {
+			if (lp->le_sym == sp) {
+			    *lpp = lp->le_next;
+			    free_le(lp);
+			} else {
+			    lpp = &lp->le_next;
+			}
+		    }
+		}
+		/********************************************************************
+		 *  Move the outputs to the gate kept - drop a repeated input to
+		 *  an AND or OR gate as the compiler does for 'a & a'
+		 *******************************************************************/
+		for (lpp = &gsp->list; *lpp; lpp = &(*lpp)->le_next);
+		for (lp = sp->list; lp; lp = nlp) {
+		    nlp = lp->le_next;
+		    tsp = lp->le_sym;
+		    if (tsp && (tsp->type == AND || tsp->type == OR)) {
+			for (tlp = gsp->list; tlp; tlp = tlp->le_next) {
+			    if (tlp->le_sym == tsp && tlp->le_val == lp->le_val) {
+				break;
+			    }
+			}
+			if (tlp) {
+			    free_le(lp);	/* repeated input */
+			    continue;
+			}
+		    }
+		    lp->le_next = 0;
+		    *lpp = lp;
+		    lpp = &lp->le_next;
+		}
+		sp->type = ALIAS;		/* merged gate is now an ALIAS */
+		sp->list = sy_push(gsp);
+		if (merged == 0 && (iC_debug & 010)) {
+		    fprintf(iC_outFP, "\n******* Identical AND or OR gates merged *******\n");
+		}
+		if (iC_debug & 04) {
+		    fprintf(iC_outFP, "\n\t%s\t  ---@\t%s\t// identical %s gate merged",
+			sp->name, gsp->name, gsp->type == AND ? "AND" : "OR");
+		}
+		merged++;
+		pass++;
+	    }
+	}
+	free(order);
+    } while (pass);
+    if (merged && (iC_debug & 04)) {
+	fprintf(iC_outFP, "\n\n");
+    }
+    return merged;
+} /* mergeGates */
+
+/********************************************************************
+ *
+ *	Remove the links from all inputs of candidate cp to its gate
+ *
+ *******************************************************************/
+
+static void
+unlinkInputs(Cand * cp)
+{
+    Term *	tp;
+    List_e *	lp;
+    List_e **	lpp;
+
+    for (tp = &tmList[cp->start]; tp < &tmList[cp->start + cp->cnt]; tp++) {
+	for (lpp = &tp->sp->list; (lp = *lpp) != 0; ) {
+	    if (lp->le_sym == cp->sp) {
+		*lpp = lp->le_next;
+		free_le(lp);
+	    } else {
+		lpp = &lp->le_next;
+	    }
+	}
+    }
+} /* unlinkInputs */
+
+/********************************************************************
+ *
+ *	Fold constant bit gates and remove dead gates for -O20
+ *
+ *	Bit constants are inputs from the permanent gate LO (0) or ~LO (1).
+ *	An AND gate with a 0 input or an OR gate with a 1 input is constant
+ *	and so is a gate whose inputs are all 1 for AND or all 0 for OR.
+ *	Such a gate is changed to an ALIAS of LO or ~LO, as if it had been
+ *	written 'imm bit b = 0;' and its outputs are moved to LO, which
+ *	may make the gates driven by it constant in the next pass. Other
+ *	constant inputs do not change the gate and are removed.
+ *
+ *	A dead gate has no path to an output, an action gate, a clock or
+ *	timer, an arithmetic node or an immC variable, is not used in C code
+ *	and is not the original of an ALIAS. Dead gates are removed from the
+ *	net and from the Symbol Table with a warning.
+ *
+ *	Return the number of gates with constant inputs folded - the number
+ *	of dead gates removed in *deadp.
+ *
+ *******************************************************************/
+
+static int
+foldGates(int * deadp)
+{
+    Symbol *	sp;
+    Symbol *	tsp;
+    Symbol *	lo;
+    List_e *	lp;
+    List_e *	nlp;
+    List_e *	tlp;
+    List_e **	lpp;
+    Cand *	cp;
+    Cand **	stack;
+    Term *	tp;
+    int		cdCnt;
+    int		tmCnt;
+    int		i, sn;
+    int		dom, neu, res;
+    int		folded = 0;
+    int		dead = 0;
+    int		pass;
+
+    do {
+	pass = 0;
+	if ((lo = lookup("LO")) == 0) {
+	    break;				/* no bit constants in this module */
+	}
+	cdCnt = collectGates(&tmCnt);
+	for (i = 0; i < cdCnt; i++) {
+	    cdList[i].sp->u_val = 0;		/* restore u_val */
+	}
+	for (i = 0; i < cdCnt; i++) {
+	    cp = &cdList[i];
+	    sp = cp->sp;
+	    if (cp->bad || sp == lo || (sp->em & (EX|EA|EU)) != 0) continue;
+	    dom = sp->type == AND ? 0 : 1;	/* dominant constant input */
+	    neu = dom ^ 1;			/* neutral constant input */
+	    res = -1;
+	    sn = 0;				/* count neutral constant inputs */
+	    for (tp = &tmList[cp->start]; tp < &tmList[cp->start + cp->cnt]; tp++) {
+		if (tp->sp == lo) {
+		    if ((tp->val != 0) == dom) {
+			res = dom;		/* gate is constant */
+			break;
+		    }
+		    sn++;
+		}
+	    }
+	    if (sn == 0 && res < 0) continue;	/* no constant inputs */
+	    if (res < 0 && sn == cp->cnt) {
+		res = neu;			/* only neutral constant inputs */
+	    }
+	    if (res < 0) {
+		/********************************************************************
+		 *  Remove neutral constant inputs - gate has other inputs
+		 *******************************************************************/
+		for (lpp = &lo->list; (lp = *lpp) != 0; ) {
+		    if (lp->le_sym == sp) {
+			*lpp = lp->le_next;
+			free_le(lp);
+		    } else {
+			lpp = &lp->le_next;
+		    }
+		}
+		if (folded++ == 0 && (iC_debug & 010)) {
+		    fprintf(iC_outFP, "\n******* Constant AND or OR gates folded *******\n");
+		}
+		if (iC_debug & 04) {
+		    fprintf(iC_outFP, "\n\t%s\t%c ---%c\t%s\t// constant input removed",
+			lo->name, neu ? '~' : ' ', iC_os[sp->type], sp->name);
+		}
+		continue;
+	    }
+	    /********************************************************************
+	     *  Constant gate - move its outputs to LO inverted for 1
+	     *******************************************************************/
+	    unlinkInputs(cp);
+	    for (lpp = &lo->list; *lpp; lpp = &(*lpp)->le_next);
+	    for (lp = sp->list; lp; lp = nlp) {
+		nlp = lp->le_next;
+		tsp = lp->le_sym;
+		lp->le_val ^= res ? NOT : 0;
+		if (tsp && (tsp->type == AND || tsp->type == OR)) {
+		    for (tlp = lo->list; tlp; tlp = tlp->le_next) {
+			if (tlp->le_sym == tsp && tlp->le_val == lp->le_val) {
+			    break;
+			}
+		    }
+		    if (tlp) {
+			free_le(lp);		/* repeated input */
+			continue;
+		    }
+		}
+		lp->le_next = 0;
+		*lpp = lp;
+		lpp = &lp->le_next;
+	    }
+	    sp->type = ALIAS;			/* constant gate is now an ALIAS */
+	    sp->list = lp = sy_push(lo);
+	    lp->le_val = res ? NOT : 0;
+	    if (folded++ == 0 && (iC_debug & 010)) {
+		fprintf(iC_outFP, "\n******* Constant AND or OR gates folded *******\n");
+	    }
+	    if (iC_debug & 04) {
+		fprintf(iC_outFP, "\n\t%s\t%c ---@\t%s\t// constant %s gate folded",
+		    lo->name, res ? '~' : ' ', sp->name, dom ? "OR" : "AND");
+	    }
+	    pass++;
+	}
+    } while (pass);
+    if (folded && (iC_debug & 04)) {
+	fprintf(iC_outFP, "\n\n");
+    }
+    /********************************************************************
+     *  Mark all gates live, which drive anything other than a candidate
+     *  or which are referenced otherwise - then mark their inputs live
+     *  Use bad to mark live gates
+     *******************************************************************/
+    cdCnt = collectGates(&tmCnt);
+    stack = (Cand**)iC_emalloc((cdCnt + 1) * sizeof(Cand*));
+    sn = 0;
+    for (i = 0; i < cdCnt; i++) {
+	cp = &cdList[i];
+	sp = cp->sp;
+	cp->bad = cp->ref || sp == lo || (sp->em & (EX|EA|EU)) != 0;
+	for (lp = sp->list; cp->bad == 0 && lp; lp = lp->le_next) {
+	    if ((tsp = lp->le_sym) == 0 || tsp->type >= MAX_LS || tsp->u_val == 0) {
+		cp->bad = 1;			/* drives other than a candidate */
+	    }
+	}
+	if (cp->bad) {
+	    stack[sn++] = cp;
+	}
+    }
+    while (sn > 0) {
+	cp = stack[--sn];
+	for (tp = &tmList[cp->start]; tp < &tmList[cp->start + cp->cnt]; tp++) {
+	    tsp = tp->sp;
+	    if (tsp->type < MAX_LS && tsp->u_val != 0 && cdList[tsp->u_val - 1].bad == 0) {
+		cdList[tsp->u_val - 1].bad = 1;	/* input of a live gate is live */
+		stack[sn++] = &cdList[tsp->u_val - 1];
+	    }
+	}
+    }
+    free(stack);
+    for (i = 0; i < cdCnt; i++) {
+	cdList[i].sp->u_val = 0;		/* restore u_val */
+    }
+    /********************************************************************
+     *  Remove dead gates - first all links from their inputs
+     *******************************************************************/
+    for (i = 0; i < cdCnt; i++) {
+	if (cdList[i].bad == 0) {
+	    unlinkInputs(&cdList[i]);
+	}
+    }
+    for (i = 0; i < cdCnt; i++) {
+	cp = &cdList[i];
+	if (cp->bad == 0) {
+	    sp = cp->sp;
+	    for (lp = sp->list; lp; lp = nlp) {
+		nlp = lp->le_next;
+		free_le(lp);			/* links to other dead gates */
+	    }
+	    sp->list = 0;
+	    if (dead == 0 && (iC_debug & 010)) {
+		fprintf(iC_outFP, "\n******* Dead AND or OR gates removed **********\n\n");
+	    }
+	    if (iC_debug & 04) {
+		fprintf(iC_outFP, "\t%s\t  ---%c\t\t// dead gate removed\n",
+		    sp->name, iC_os[sp->type]);
+	    }
+	    if (iC_Wflag & W_UNUSED) {
+		warning("dead gate removed:", sp->name);
+	    }
+	    uninstall(sp);
+	    dead++;
+	}
+    }
+    *deadp = dead;
+    return folded;
+} /* foldGates */
+
 /********************************************************************
  *
  *	Output the forward network as NET TOPOLOGY in the listing file.
@@ -500,8 +1059,12 @@ iC_listNet(void)
     int		szFlag;
     int		szCount;
     int		icerrFlag;
+    int		merged = 0;
+    int		folded = 0;
+    int		dead = 0;
 
     link_count = revl_count = block_total = undefined = unused = iClockAlias = 0;	/* init each time */
+    sort_symlist();				/* listings depend on sorted symlists */
     for (typ = 0; typ < MAX_LS; typ++) {
 	gate_count[typ] = 0;
     }
@@ -1020,6 +1583,12 @@ iC_listNet(void)
 	    }
 	}
     }
+    if (iC_optimise & 020) {
+	folded = foldGates(&dead);	/* before merging and counting */
+    }
+    if (iC_optimise & 010) {
+	merged = mergeGates();		/* before counting inputs of large gates */
+    }
     szFlag = szCount = 0;
     /********************************************************************
      *  Detect large AND or OR gates > PPGATESIZE in this pass. (LATCH always small)
@@ -1196,12 +1765,11 @@ iC_listNet(void)
 		}
 	    }
 	    for (j = 0; j < div; j++) {
-		spAux = (Symbol *) iC_emalloc(sizeof(Symbol));
+		spAux = new_sym();
 		do {
 		    snprintf(temp1, TSIZE, "%s_%d", temp, ++atn);
 		} while (lookup(temp1) != 0);
-		spAux->name = iC_emalloc(strlen(temp1)+1);
-		strcpy(spAux->name, temp1);
+		spAux->name = new_name(temp1);
 		spAux->type = tsp->type;
 		spAux->ftype = GATE;		/* remaining fields are 0 */
 		spAux->list = lp1 = sy_push(spAux);
@@ -1482,6 +2050,8 @@ iC_listNet(void)
 			     *  iClock used as ERR indicator not used any more	JW 20150603
 			     *
 			     *  type ERR - ignore
+			     *
+			     *  LO may have lost all its outputs in foldGates() with -O20 - ignore
 			     *******************************************************************/
 			    sp->list == 0 &&
 			    (sp->em & (EU|EX)) == 0 &&	/* not used and not extern immC */
@@ -1489,7 +2059,8 @@ iC_listNet(void)
 			    sp->ftype != OUTW &&
 			    sp->ftype != OUTX &&
 			    typ != ERR &&
-			    sp != iclock
+			    sp != iclock &&
+			    ((iC_optimise & 020) == 0 || strcmp(sp->name, "LO") != 0)
 			) {
 			    unused++;		/* report total unused only if W_UNUSED */
 			    switch (sp->ftype) {
@@ -1579,6 +2150,15 @@ iC_listNet(void)
 	}
 	fprintf(iC_outFP, "\nTOTAL\t%8u blocks\n", block_total);
 	fprintf(iC_outFP, "\t%8u links\n", link_count + revl_count);
+	if (folded) {
+	    fprintf(iC_outFP, "\t%8d gate%s with constant inputs folded\n", folded, folded > 1 ? "s" : "");
+	}
+	if (dead) {
+	    fprintf(iC_outFP, "\t%8d dead gate%s removed\n", dead, dead > 1 ? "s" : "");
+	}
+	if (merged) {
+	    fprintf(iC_outFP, "\t%8d gate%s merged\n", merged, merged > 1 ? "s" : "");
+	}
     }
     if (iClockHidden) {
 	block_total++;				/* iClock is generated anyway in buildNet() */
@@ -2175,6 +2755,201 @@ iC_buildNet(void)				/* Gate ** sTable, Gate ** sTend are global */
 } /* iC_buildNet */
 #endif /* defined(RUN) || defined(TCP) && ! defined(LOAD) */
 
+/********************************************************************
+ *
+ *	Select the Symbols which iC_outNet() generates as Gates
+ *	ALIAS Gates are only generated with the -A option
+ *
+ *******************************************************************/
+
+static int
+isGate(Symbol * sp)
+{
+    int		ftyp;
+
+    if (sp->type < MAX_OP) {		/* include UDF and all types except ALIAS */
+	return (sp->fm & FM) == 0 &&	/* leave out function variables */
+	    (sp->em & EM) == 0 &&	/* leave out extern variables */
+	    sp != iclock &&		/* leave out iClock */
+	    (sp->type != NCONST || sp->u_val != 0);	/* and unused constants */
+    }
+    return sp->type == ALIAS &&
+	(sp->em & EM) == 0 &&
+	sp->fm == 0 &&
+	sp->list != 0 &&
+	iC_Aflag &&
+	((ftyp = sp->ftype) == GATE || ftyp == ARITH || ftyp == CLCKL || ftyp == TIMRL);
+} /* isGate */
+
+/********************************************************************
+ *
+ *	Order the Gates for a single static table iC_g_[] (-G option)
+ *
+ *	Each Gate follows the Gates on its input list (depth first post
+ *	order) and the slave Gate of an action Gate follows its master.
+ *	Gates which fire together are then mostly neighbours in memory.
+ *	ALIAS Gates are placed last, since the loader resolves them last.
+ *
+ *	v_cnt of each Symbol in the table is used as a visited mark;
+ *	it is no longer needed in the output phase.
+ *
+ *	Returns an array of Symbol pointers terminated by 0.
+ *	*gcntp receives the number of Gates which are not ALIAS Gates.
+ *
+ *******************************************************************/
+
+static Symbol **
+gateTable(int * gcntp)
+{
+    Symbol **	hsp;
+    Symbol *	sp;
+    Symbol *	tsp;
+    List_e *	lp;
+    Symbol **	gTable;
+    Symbol **	gtp;
+    Symbol **	stack;				/* Symbols whose inputs are being ordered */
+    List_e **	next;				/* next input link of each Symbol on stack */
+    int		n = 0;				/* number of Gates and stack depth */
+
+    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
+	for (sp = *hsp; sp; sp = sp->next) {
+	    if (isGate(sp)) {
+		sp->v_cnt = 0;			/* not yet in table */
+		n++;
+	    }
+	}
+    }
+    gtp = gTable = (Symbol **)iC_emalloc((n + 1) * sizeof(Symbol *));
+    stack = (Symbol **)iC_emalloc(n * sizeof(Symbol *));
+    next = (List_e **)iC_emalloc(n * sizeof(List_e *));
+    n = 0;
+    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
+	for (sp = *hsp; sp; sp = sp->next) {
+	    if (sp->type < MAX_OP && isGate(sp) && sp->v_cnt == 0) {
+		tsp = sp;
+		do {
+		    /* push tsp - only the input list of logic and arithmetic Gates */
+		    /* is ordered; the dummy input list of _f0_1 is left out */
+		    tsp->v_cnt = 1;
+		    stack[n] = tsp;
+		    next[n++] = (tsp->type == ARN || (tsp->type >= MIN_GT && tsp->type < MAX_GT)) &&
+			((lp = tsp->list) == 0 || lp->le_sym != tsp) ? tsp->u_blist : 0;
+		    tsp = 0;
+		    while (tsp == 0 && n > 0) {
+			if ((lp = next[n-1]) != 0) {
+			    next[n-1] = lp->le_next;
+			    if ((tsp = lp->le_sym) == 0 ||
+				tsp->type >= MAX_OP || !isGate(tsp) || tsp->v_cnt) {
+				tsp = 0;	/* input not in table or already placed */
+			    }
+			} else {
+			    *gtp++ = tsp = stack[--n];	/* all inputs are placed */
+			    if (tsp->ftype >= MIN_ACT && tsp->ftype < MAX_ACT &&
+				(lp = tsp->list) != 0 &&
+				(tsp = lp->le_sym) != 0 &&
+				tsp->type < MAX_OP && isGate(tsp) && tsp->v_cnt == 0) {
+				;		/* slave Gate follows its master */
+			    } else {
+				tsp = 0;
+			    }
+			}
+		    }
+		} while (tsp);
+	    }
+	}
+    }
+    *gcntp = gtp - gTable;
+    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
+	for (sp = *hsp; sp; sp = sp->next) {
+	    if (sp->type == ALIAS && isGate(sp)) {
+		*gtp++ = sp;			/* ALIAS Gates last */
+	    }
+	}
+    }
+    *gtp = 0;
+    free(stack);
+    free(next);
+    return gTable;
+} /* gateTable */
+
+/********************************************************************
+ *
+ *	Compare the names of two Symbols in the order in which
+ *	iC_cmp_gt_ids() sorts the corresponding gt_ids in load.c
+ *
+ *******************************************************************/
+
+static int
+cmp_names(const Symbol ** a, const Symbol ** b)
+{
+    Gate	ga;
+    Gate	gb;
+    const Gate *	gap = &ga;
+    const Gate *	gbp = &gb;
+
+    ga.gt_ids = (*a)->name;
+    gb.gt_ids = (*b)->name;
+    return iC_cmp_gt_ids(&gap, &gbp);
+} /* cmp_names */
+
+/********************************************************************
+ *
+ *	Link the Gates of the static table iC_g_[] in gt_ids order (-G)
+ *
+ *	gt_next of each table entry is generated from the returned array
+ *	of table indices (-1 terminates). The linked gate list is then
+ *	already sorted, and load.c adopts it without calling qsort().
+ *
+ *	The fan-out order of the table only decides where the Gates are in
+ *	memory. The gate list and the activity lists built by load.c are
+ *	in gt_ids order, the same as for a net compiled without -G.
+ *
+ *	*headp receives the table index of the head of the gate list.
+ *
+ *******************************************************************/
+
+static int *
+linkTable(Symbol ** gTable, int n, int * headp)
+{
+    Symbol **	sorted;
+    int *	gNext;
+    int		k;
+
+    sorted = (Symbol **)iC_emalloc(n * sizeof(Symbol *));
+    gNext = (int *)iC_emalloc(n * sizeof(int));
+    for (k = 0; k < n; k++) {
+	gTable[k]->v_cnt = k;		/* table index */
+	sorted[k] = gTable[k];
+    }
+    qsort(sorted, n, sizeof(Symbol *), (iC_fptr)cmp_names);
+    *headp = sorted[0]->v_cnt;
+    for (k = 0; k < n - 1; k++) {
+	gNext[sorted[k]->v_cnt] = sorted[k+1]->v_cnt;
+    }
+    gNext[sorted[k]->v_cnt] = -1;	/* last Gate terminates the gate list */
+    free(sorted);
+    return gNext;
+} /* linkTable */
+
+/********************************************************************
+ *
+ *	Set sam and nxs to generate gt_next as a table entry (-G)
+ *
+ *******************************************************************/
+
+static void
+nxtEntry(char * buf, size_t size, int gi, char ** samp, char ** nxsp)
+{
+    if (gi < 0) {
+	*samp = "";			/* 0 terminator for linked gate list */
+	*nxsp = "0";
+    } else {
+	snprintf(buf, size, "iC_g_[%d]", gi);
+	*samp = "&";
+	*nxsp = buf;
+    }
+} /* nxtEntry */
+
 /********************************************************************
  *
  *	Generate network as C file
@@ -2211,6 +2986,12 @@ iC_outNet(FILE * iFP, char * outfile)
     int		idx;
     int		ext;
     char	tail2[8];			/* compiler generated suffix _123456 max */
+    Symbol **	gTable = 0;			/* -G Gates in table order */
+    Symbol **	gEnd = 0;			/* end of Gates and ALIAS in gTable */
+    int		gcnt = 0;			/* Gates in gTable without ALIAS */
+    int *	gNext = 0;			/* -G gt_next table index of each Gate */
+    int		gHead = 0;			/* -G table index of gate list head */
+    char	gBuf[24];			/* -G gt_next as table entry */
 
     /********************************************************************
      *
@@ -2600,11 +3381,36 @@ iC_outNet(FILE * iFP, char * outfile)
 "\n"
     ); linecnt += 7;
 
+    /********************************************************************
+     *  With -G all Gates are generated as members of one static table
+     *  iC_g_[] in fan-out order. Each Gate name is a macro for its table
+     *  entry, so the gate list, connection lists and C code are unchanged.
+     *  Only the memory placement of the Gates changes - gt_next is
+     *  linked in gt_ids order by linkTable().
+     *  The loops below then run over gTable instead of symlist.
+     *******************************************************************/
+    if (iC_Gflag && !iC_Lflag && *(gTable = gateTable(&gcnt)) != 0) {
+	for (hsp = gTable; (sp = *hsp) != 0; hsp++) {
+	    fprintf(Fp, "#define %-8s iC_g_[%d]\n", mN(sp), (int)(hsp - gTable));
+	    linecnt++;
+	}
+	gEnd = hsp;
+	gNext = linkTable(gTable, gEnd - gTable, &gHead);
+	fprintf(Fp,
+"\n"
+"static iC_Gt	iC_g_[%d] = {\n"
+	, (int)(gEnd - gTable)); linecnt += 2;
+    } else {
+	if (gTable) free(gTable);
+	gTable = 0;
+    }
+
     li = 0;
     nxs = "0";					/* 0 terminator for linked gate list */
     sam = "";					/* no & for terminator in linked gate list */
-    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
-	for (sp = *hsp; sp; sp = sp->next) {
+    for (hsp = gTable ? gTable : symlist;
+	hsp < (gTable ? gTable + gcnt : &symlist[HASHSIZ]); hsp++) {
+	for (sp = *hsp; sp; sp = gTable ? 0 : sp->next) {
 	    if ((typ = sp->type) < MAX_OP &&	/* include UDF and all types except ALIAS here */
 		(sp->fm & FM) == 0 &&		/* leave out function variables */
 		(sp->em & EM) == 0 &&		/* leave out extern variables */
@@ -2614,6 +3420,10 @@ iC_outNet(FILE * iFP, char * outfile)
 		 * mN() sets cnt, iqt, xbwl, byte, bit and tail via IEC1131() as side effect
 		 *******************************************************************/
 		modName = mN(sp);		/* modified string, bit is used in block */
+		if (gTable) {
+		    /* unused constants are not in gTable */
+		    fprintf(Fp, "/* %-8s */", modName);
+		} else
 		if (typ == NCONST) {
 		    if (sp->u_val == 0) {
 			continue;		/* do not include unused constants */
@@ -2629,7 +3439,7 @@ iC_outNet(FILE * iFP, char * outfile)
 		    fprintf(Fp, "iC_Gt %-8s", modName);
 		}
 		/* open Gate initialiser */
-		fprintf(Fp, " = { 1, -%s,", iC_ext_type[typ]);	/* gt_val, -gt_ini */
+		fprintf(Fp, "%s{ 1, -%s,", gTable ? " " : " = ", iC_ext_type[typ]);	/* gt_val, -gt_ini */
 		ftyp = sp->ftype;
 		if ((lp = sp->list) != 0 && lp->le_sym == sp && typ != NCONST) {
 		    fflag = 1;			/* leave out _f0_1 */
@@ -2746,6 +3556,10 @@ iC_outNet(FILE * iFP, char * outfile)
 		    fprintf(Fp, " {0},");	/* no gt_rlist */
 		}
 		/* generate gt_next, which points to previous gate */
+		/* or with -G to the next Gate in gt_ids order */
+		if (gTable) {
+		    nxtEntry(gBuf, sizeof gBuf, gNext[hsp - gTable], &sam, &nxs);
+		}
 		fprintf(Fp, " %s%s", sam, nxs);
 		/********************************************************************
 		 * optionally generate non-zero timer preset value in gt_mark
@@ -2770,9 +3584,6 @@ iC_outNet(FILE * iFP, char * outfile)
 		    (sp->em & EI)) {			/* and marked as initialised */
 		    Valp	v;
 		    fprintf(Fp, ", 0, 0");		/* fillers for gt_mark, gt_live */
-#ifdef DEQ
-		    fprintf(Fp, ", 0");			/* filler for gt_prev */
-#endif
 		    v = extractConstIni(sp);		/* obtain numerical value */
 #if INT_MAX == 32767 && defined (LONG16)
 		    fprintf(Fp, ", %ld", (long)v.nuv);	/* gt_new = immC initialiser */
@@ -2781,7 +3592,7 @@ iC_outNet(FILE * iFP, char * outfile)
 #endif
 		}
 		/* close Gate initialiser */
-		fprintf(Fp, " };\n");
+		fprintf(Fp, gTable ? " },\n" : " };\n");
 		linecnt++;
 		nxs = modName;			/* previous Symbol name */
 		sam = "&";
@@ -2794,8 +3605,9 @@ iC_outNet(FILE * iFP, char * outfile)
      *  Resolve multiple ALIASes here for the same reason.
      *  Generate code for ARITH ALIAS only if iC_Aflag is set (-A option)
      *******************************************************************/
-    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
-	for (sp = *hsp; sp; sp = sp->next) {
+    for (hsp = gTable ? gTable + gcnt : symlist;
+	hsp < (gTable ? gEnd : &symlist[HASHSIZ]); hsp++) {
+	for (sp = *hsp; sp; sp = gTable ? 0 : sp->next) {
 	    if ((typ = sp->type) == ALIAS &&
 		(sp->em & EM) == 0 &&
 		sp->fm == 0 &&
@@ -2805,16 +3617,20 @@ iC_outNet(FILE * iFP, char * outfile)
 	    ) {
 		modName = mN(sp);		/* modified string, byte and bit */
 		ix++;
-		fprintf(Fp, "iC_Gt %-8s", modName);
+		fprintf(Fp, gTable ? "/* %-8s */" : "iC_Gt %-8s", modName);
 		val = sp->list->le_val;
 		tsp = sp->list->le_sym;
 		while (tsp->type == ALIAS && (tsp->em & EM) == 0 && tsp->fm == 0) {
 		    val ^= tsp->list->le_val;	/* negate if necessary */
 		    tsp = tsp->list->le_sym;	/* point to original */
 		}
+		if (gTable) {
+		    nxtEntry(gBuf, sizeof gBuf, gNext[hsp - gTable], &sam, &nxs);
+		}
 		fprintf(Fp,
-		    " = { 1, -%s, %s, 0, \"%s\", {0}, {(iC_Gt**)&%s}, %s%s, %d };\n",
-		    iC_ext_type[typ], iC_ext_ftype[ftyp], sp->name, mN(tsp), sam, nxs, val);
+		    "%s{ 1, -%s, %s, 0, \"%s\", {0}, {(iC_Gt**)&%s}, %s%s, %d }%s\n",
+		    gTable ? " " : " = ", iC_ext_type[typ], iC_ext_ftype[ftyp], sp->name,
+		    mN(tsp), sam, nxs, val, gTable ? "," : ";");
 		ix++;
 		linecnt++;
 		nxs = modName;			/* previous Symbol name */
@@ -2822,6 +3638,13 @@ iC_outNet(FILE * iFP, char * outfile)
 	    }
 	}
     }
+    if (gTable) {
+	fprintf(Fp, "};\n");			/* close static table iC_g_[] */
+	linecnt++;
+	snprintf(gBuf, sizeof gBuf, "iC_g_[%d]", gHead);
+	sam = "&";				/* head of gate list in gt_ids order */
+	nxs = gBuf;
+    }
     /********************************************************************
      *  Link counting in outNet() counts all reverse links and is thus very
      *  different to listNet() therefore cannot compare link_count and li
@@ -2907,8 +3730,9 @@ iC_outNet(FILE * iFP, char * outfile)
 "static iC_Gt *	iC_l_[] = {\n"
     ); linecnt += 1;
     lc = 0;					/* count links in connection lists */
-    for (hsp = symlist; hsp < &symlist[HASHSIZ]; hsp++) {
-	for (sp = *hsp; sp; sp = sp->next) {
+    for (hsp = gTable ? gTable : symlist;
+	hsp < (gTable ? gTable + gcnt : &symlist[HASHSIZ]); hsp++) {
+	for (sp = *hsp; sp; sp = gTable ? 0 : sp->next) {
 	    if (
 		(
 		    (typ = sp->type) == ARN ||		/* arithmetic gates */
@@ -3242,6 +4066,8 @@ iC_outNet(FILE * iFP, char * outfile)
     }
 
 endm:
+    if (gTable) free(gTable);
+    if (gNext) free(gNext);
     if (iC_debug & 010) {
 	fprintf(iC_outFP, "\nC OUTPUT: %s  (%d lines)\n", outfile, linecnt-1);
     }
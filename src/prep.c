@@ -0,0 +1,750 @@
+static const char prep_c[] =
+"@(#)$Id: prep.c 1.1 $";
+/********************************************************************
+ *
+ *	Copyright (C) 2026  John E. Wulff
+ *
+ *  You may distribute under the terms of either the GNU General Public
+ *  License or the Artistic License, as specified in the README file.
+ *
+ *  For more information about this program, or for information on how
+ *  to contact the author, see the README file
+ *
+ *	prep.c
+ *	in-process pre-processor for iC files
+ *
+ *	Resolves %define %undef %ifdef %ifndef %else %endif and %include
+ *	directives and object like macros directly into a memory buffer,
+ *	which is read by the iC lexer. The output is identical to the output
+ *	of 'immac -M' - which produces blank lines for directives, replaces
+ *	8 or more blank lines by # line "file" and marks %include files
+ *	with # 1 "file" 1 and # line "file" 2.
+ *
+ *	Anything which needs the full power of immac - function like macros,
+ *	%if and %elif expressions, %error %warning %line, continuation lines,
+ *	redefinitions or anything immac would warn about - is not handled.
+ *	iC_prep() returns 1 in that case and the caller falls back to immac.
+ *
+ *******************************************************************/
+
+#ifndef	_WIN32
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<ctype.h>
+#include	<assert.h>
+#include	<sys/stat.h>
+#include	"comp.h"
+
+#define	PDEPTH	32			/* maximum nesting of %include files */
+#define	BLANKS	8			/* replace 8 or more blank lines by # line "file" */
+#define	USED	64			/* maximum nesting of macro translations */
+
+typedef struct Macro {
+    struct Macro *	next;
+    char *		name;
+    char *		translate;
+    int			cl;		/* defined with -D on the command line */
+} Macro;
+
+typedef struct PBuf {
+    char *		buf;		/* output buffer - initially NULL */
+    size_t		len;
+    size_t		size;
+} PBuf;
+
+typedef struct PFile {
+    FILE *		fp;
+    char *		name;		/* file name for # line "file" */
+    int			line;		/* lines read so far */
+} PFile;
+
+static Macro *		macros;		/* defined macros */
+static PFile		pFile[PDEPTH];	/* nested %include files */
+static int		pTop;		/* current file is pFile[pTop-1] */
+static int		blankLines;	/* blank lines not output yet */
+static const char *	used[USED];	/* macro translations being resolved */
+static int		usedCnt;
+
+static const char *	keyword[] = {	/* as in perl test for directives in iC_compile() */
+    "define", "undef", "include", "ifdef", "ifndef", "if", "elif", "else", "endif", "error", 0,
+};
+
+static const char *	allKeyword[] = {	/* as in immac */
+    "define", "undef", "include", "ifdef", "ifndef", "if", "elif", "else", "endif", "error",
+    "warning", "line", 0,
+};
+
+/********************************************************************
+ *
+ *	Output to growing buffer
+ *
+ *******************************************************************/
+
+static void
+pPut(PBuf * bp, const char * s, size_t n)
+{
+    if (bp->len + n + 1 > bp->size) {
+	while (bp->len + n + 1 > bp->size) {
+	    bp->size = bp->size ? bp->size << 1 : 4096;
+	}
+	bp->buf = (char *)realloc(bp->buf, bp->size);	/* initially NULL */
+	assert(bp->buf);
+    }
+    memcpy(bp->buf + bp->len, s, n);
+    bp->len += n;
+    bp->buf[bp->len] = '\0';
+} /* pPut */
+
+/********************************************************************
+ *
+ *	Character classes of Perl regular expressions \s and \w
+ *
+ *******************************************************************/
+
+static int
+isS(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+} /* isS */
+
+static int
+isW(int c)
+{
+    return isascii(c) && (isalnum(c) || c == '_');
+} /* isW */
+
+static int
+isW1(int c)				/* first character of a word [A-Z_a-z] */
+{
+    return isascii(c) && (isalpha(c) || c == '_');
+} /* isW1 */
+
+/********************************************************************
+ *
+ *	Length of keyword at s if it is one of table followed by \b
+ *
+ *******************************************************************/
+
+static int
+isKeyword(const char * s, const char ** table)
+{
+    const char **	kp;
+    int			n;
+
+    for (n = 0; isW(s[n]); n++);
+    for (kp = table; *kp; kp++) {
+	if ((int)strlen(*kp) == n && strncmp(s, *kp, n) == 0) {
+	    return n;
+	}
+    }
+    return 0;
+} /* isKeyword */
+
+/********************************************************************
+ *
+ *	Test if an iC file has any %define %include %if etc directives
+ *	Returns 0 if it does, 1 if not or if it cannot be read
+ *
+ *******************************************************************/
+
+int
+iC_prepTest(char * path)
+{
+    FILE *	fp;
+    char *	line = NULL;
+    size_t	size = 0;
+    char *	cp;
+    int		r = 1;
+
+    if ((fp = fopen(path, "r")) != NULL) {
+	while (r && getline(&line, &size, fp) > 0) {
+	    for (cp = line; isS(*cp); cp++);
+	    if (*cp++ == '%') {
+		while (isS(*cp)) cp++;
+		if (isKeyword(cp, keyword)) {
+		    r = 0;			/* ^\s*%\s*(define|...)\b */
+		}
+	    }
+	}
+	free(line);
+	fclose(fp);
+    }
+    return r;
+} /* iC_prepTest */
+
+/********************************************************************
+ *
+ *	Macro table
+ *
+ *******************************************************************/
+
+static Macro *
+findMacro(const char * name, size_t n)
+{
+    Macro *	mp;
+
+    for (mp = macros; mp; mp = mp->next) {
+	if (strlen(mp->name) == n && strncmp(mp->name, name, n) == 0) {
+	    break;
+	}
+    }
+    return mp;
+} /* findMacro */
+
+static void
+deleteMacro(const char * name)
+{
+    Macro **	mpp;
+    Macro *	mp;
+
+    for (mpp = &macros; (mp = *mpp) != 0; mpp = &mp->next) {
+	if (strcmp(mp->name, name) == 0) {
+	    *mpp = mp->next;
+	    free(mp->name);
+	    free(mp->translate);
+	    free(mp);
+	    return;
+	}
+    }
+} /* deleteMacro */
+
+/********************************************************************
+ *
+ *	Resolve object like macros in s[0..n) and append to bp
+ *	Same scan as resolve() in immac: a word may be preceded by
+ *	%% % or # and spaces, in which case it is not a macro; the word
+ *	directly after %define %%define or #define is not resolved.
+ *	A translation is not resolved again while it is being resolved.
+ *
+ *******************************************************************/
+
+static void
+resolve(PBuf * bp, const char * s, size_t n)
+{
+    size_t	i, j, k, w, e;
+    size_t	pa = 0;				/* previous atom */
+    size_t	pl = 0;
+    int		pos = 0;			/* macro found not at start of line */
+    Macro *	mp;
+    int		u;
+
+    for (i = 0; i < n; i = e) {
+	for (j = i; j < n; j++) {
+	    if (s[j] == '%' && j + 1 < n && s[j+1] == '%') {
+		for (k = j + 2; k < n && isS(s[k]); k++);
+		if (k < n && isW1(s[k])) break;	/* %% word */
+	    }
+	    if (s[j] == '%' || s[j] == '#') {
+		for (k = j + 1; k < n && isS(s[k]); k++);
+		if (k < n && isW1(s[k])) break;	/* % word or # word */
+	    }
+	    if (isW1(s[k = j])) break;		/* word */
+	}
+	pPut(bp, s + i, j - i);
+	if (j >= n) {
+	    return;
+	}
+	for (w = k + 1; w < n && isW(s[w]); w++);	/* end of word */
+	for (e = w; e < n && isS(s[e]); e++);
+	e = (e < n && s[e] == '(') ? e + 1 : w;	/* scan continues after optional ( */
+	if (pos == 0 &&
+	    ((pl == 8 && strncmp(s + pa, "%%define", 8) == 0) ||
+	    (pl == 7 && (strncmp(s + pa, "%define", 7) == 0 || strncmp(s + pa, "#define", 7) == 0)))) {
+	    pPut(bp, s + j, w - j);		/* name of macro being defined */
+	} else if (k == j && (mp = findMacro(s + j, w - j)) != 0) {
+	    if (j != 0) pos = 1;
+	    for (u = 0; u < usedCnt && strcmp(used[u], mp->translate) != 0; u++);
+	    if (u < usedCnt || usedCnt >= USED) {
+		pPut(bp, s + j, w - j);		/* translation is already being resolved */
+	    } else {
+		used[usedCnt++] = mp->translate;
+		resolve(bp, mp->translate, strlen(mp->translate));
+		usedCnt--;
+	    }
+	} else {
+	    pPut(bp, s + j, w - j);
+	}
+	pPut(bp, s + w, e - w);
+	pa = j;
+	pl = w - j;
+    }
+} /* resolve */
+
+/********************************************************************
+ *
+ *	Scan a macro definition 'NAME translate' as scan_define() in immac
+ *	Returns 1 for anything immac would treat differently or warn about
+ *
+ *******************************************************************/
+
+static int
+define(char * macro, int cl)
+{
+    char *	cp;
+    char *	tp;
+    Macro *	mp;
+    size_t	n;
+
+    if (! isW1(*macro)) {
+	return 1;				/* bad characters */
+    }
+    for (cp = macro + 1; isW(*cp); cp++);
+    n = cp - macro;
+    if (*cp == '\0') {
+	tp = "1";				/* default translation */
+    } else if (isS(*cp)) {
+	for (tp = cp; isS(*tp); tp++);
+	if (*tp == '\0') {
+	    return 1;
+	}
+    } else {
+	return 1;				/* function like macro or bad characters */
+    }
+    if (strchr(tp, '#') || strstr(tp, "/*")) {
+	return 1;				/* # and comments in translation need immac */
+    }
+    if ((mp = findMacro(macro, n)) != 0) {
+	if (mp->cl) {
+	    return 0;				/* command line definition has precedence */
+	}
+	return strcmp(mp->translate, tp) != 0;	/* re-definition is a warning */
+    }
+    if (cl && n == strlen(tp) && strncmp(macro, tp, n) == 0) {
+	return 1;				/* -D X=X does not change anything */
+    }
+    mp = (Macro *)iC_emalloc(sizeof(Macro));
+    mp->name = iC_emalloc(n + 1);
+    strncpy(mp->name, macro, n);
+    mp->translate = iC_emalloc(strlen(tp) + 1);
+    strcpy(mp->translate, tp);
+    for (cp = mp->translate + strlen(mp->translate); cp > mp->translate && isS(cp[-1]); *--cp = '\0');
+    mp->cl = cl;
+    mp->next = macros;
+    macros = mp;
+    return 0;
+} /* define */
+
+/********************************************************************
+ *
+ *	-D and -U definitions from the command line in the form
+ *	" -D X=1 -U Y" - only simple ones which need no shell quoting
+ *	All -D definitions are processed before -U as in immac
+ *
+ *******************************************************************/
+
+static int
+cmdDefines(char * defines, int arg)
+{
+    char	buf[BUFS];
+    char *	cp;
+    char *	vp;
+    int		d;
+
+    strncpy(buf, defines, BUFS - 1);
+    buf[BUFS - 1] = '\0';
+    for (cp = strtok(buf, " "); cp; cp = strtok(NULL, " ")) {
+	if (cp[0] != '-' || (d = cp[1]) == '\0' || (vp = strtok(NULL, " ")) == NULL ||
+	    vp[strspn(vp, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_.=+-")] != '\0') {
+	    return 1;
+	}
+	if (d != arg) {
+	    continue;
+	}
+	if (d == 'D') {
+	    if ((cp = strchr(vp, '=')) != NULL) {
+		*cp = ' ';			/* split /\s*=\s*\/, $_, 2 */
+	    }
+	    if (define(vp, 1)) {
+		return 1;
+	    }
+	} else {
+	    if (! isW1(*vp) || vp[strspn(vp, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_")]) {
+		return 1;
+	    }
+	    deleteMacro(vp);
+	}
+    }
+    return 0;
+} /* cmdDefines */
+
+/********************************************************************
+ *
+ *	Perl eof() - also makes fp the file for $. in blanks()
+ *
+ *******************************************************************/
+
+static int
+pEof(FILE * fp)
+{
+    int		c;
+
+    if ((c = getc(fp)) == EOF) {
+	return 1;
+    }
+    ungetc(c, fp);
+    return 0;
+} /* pEof */
+
+/********************************************************************
+ *
+ *	Output outstanding blank lines as blanks() in immac
+ *
+ *******************************************************************/
+
+static void
+blanks(PBuf * bp)
+{
+    PFile *	pf = &pFile[pTop-1];
+    char	lineBuf[BUFS];
+
+    if (blankLines < BLANKS) {
+	while (blankLines--) {
+	    pPut(bp, "\n", 1);
+	}
+    } else if (! pEof(pf->fp)) {
+	snprintf(lineBuf, BUFS, "# %d \"%s\"\n", pf->line, pf->name);
+	pPut(bp, lineBuf, strlen(lineBuf));
+    }
+    blankLines = 0;
+} /* blanks */
+
+/********************************************************************
+ *
+ *	Open a file from %include "file" on the immac search path
+ *	$INCLUDE or /usr/local/include, then -I/usr/local/include and .
+ *
+ *******************************************************************/
+
+static FILE *
+openInclude(const char * f)
+{
+    char	path[BUFS];
+    char	file[BUFS];
+    char *	cp;
+    char *	ep;
+    int		len;
+    struct stat	st;
+
+    if (f[0] == '/' || f[0] == '\\' || (isalpha((unsigned char)f[0]) && f[1] == ':')) {
+	return (stat(f, &st) == 0 && S_ISREG(st.st_mode)) ? fopen(f, "r") : NULL;
+    }
+    if ((len = snprintf(path, BUFS, "%s:/usr/local/include:.",
+	(cp = getenv("INCLUDE")) != NULL ? cp : "/usr/local/include")) < 0 || len >= BUFS) {
+	return NULL;				/* $INCLUDE too long - leave it to immac */
+    }
+    for (cp = path; cp; cp = ep) {
+	if ((ep = strchr(cp, ':')) != NULL) {
+	    *ep++ = '\0';
+	}
+	if ((len = snprintf(file, BUFS, "%s/%s", cp, f)) < 0 || len >= BUFS) {
+	    return NULL;			/* path does not fit - leave it to immac */
+	}
+	if (stat(file, &st) == 0 && S_ISREG(st.st_mode)) {
+	    return fopen(file, "r");
+	}
+    }
+    return NULL;
+} /* openInclude */
+
+/********************************************************************
+ *
+ *	Split directive line at the first space and return the rest
+ *	without C++ comment and trailing blanks or NULL if none
+ *
+ *******************************************************************/
+
+static char *
+splitDef(char * line)
+{
+    char *	macro;
+    char *	cp;
+
+    if ((macro = strchr(line, ' ')) != NULL) {
+	*macro++ = '\0';			/* split " ", $_, 2 */
+	for (cp = macro; *cp && strncmp(cp, "//", 2) != 0; cp++);
+	while (cp > macro && isS(cp[-1])) cp--;
+	*cp = '\0';				/* s!\s*(//.*)?$!! */
+    }
+    return macro;
+} /* splitDef */
+
+/********************************************************************
+ *
+ *	Handle one directive line (already compressed) in true and
+ *	false blocks - returns 1 if immac must be used instead
+ *
+ *******************************************************************/
+
+static int
+directive(PBuf * bp, char * line, int * sip, int ** stkp, int * stkSizep, int * stkCntp)
+{
+    char *	macro;
+    char *	cp;
+    char *	ep;
+    PBuf	rb = { NULL, 0, 0 };
+    FILE *	fp;
+    char	lineBuf[BUFS];
+    int		si = *sip;
+    int		r = 0;
+
+    macro = splitDef(line);
+    if (strcmp(line, "%ifdef") == 0 || strcmp(line, "%ifndef") == 0) {
+	if (*stkCntp >= *stkSizep) {
+	    *stkp = (int *)realloc(*stkp,	/* initially NULL */
+		(*stkSizep += 16) * sizeof(int));
+	    assert(*stkp);
+	}
+	(*stkp)[(*stkCntp)++] = si;
+	if (si > 0) {
+	    if (macro == NULL || ! isW1(*macro)) {
+		return 1;			/* bad directive */
+	    }
+	    for (cp = macro; isW(*cp); cp++);
+	    si = (findMacro(macro, cp - macro) != 0) == (line[3] == 'd') ? 2 : -1;
+	} else {
+	    si = -1;
+	}
+    } else if (strcmp(line, "%else") == 0) {
+	if (*stkCntp == 0 || (si & ~0x1) == 0) {
+	    return 1;				/* extra %else */
+	}
+	si = ((*stkp)[*stkCntp - 1] <= 0 || si > 0 || si == -2) ? 0 : 1;
+    } else if (strcmp(line, "%endif") == 0) {
+	if (*stkCntp == 0) {
+	    return 1;				/* extra %endif */
+	}
+	si = (*stkp)[--(*stkCntp)];
+    } else if (si > 0) {
+	if (strcmp(line, "%define") == 0) {
+	    if (macro == NULL) {
+		return 1;
+	    }
+	    macro[-1] = ' ';
+	    resolve(&rb, line, strlen(line));	/* resolve embedded macros */
+	    r = (macro = splitDef(rb.buf)) == NULL || define(macro, 0);
+	    free(rb.buf);
+	} else if (strcmp(line, "%undef") == 0) {
+	    if (macro == NULL || ! isW1(*macro)) {
+		return 1;
+	    }
+	    for (cp = macro; isW(*cp); cp++);
+	    if (*cp) {
+		return 1;			/* bad characters */
+	    }
+	    deleteMacro(macro);
+	} else if (strcmp(line, "%include") == 0) {
+	    if (macro == NULL || pTop >= PDEPTH) {
+		return 1;
+	    }
+	    for (cp = ep = macro; *cp; cp++) {
+		if (! isS(*cp)) *ep++ = *cp;	/* s/\s+//g */
+	    }
+	    *ep = '\0';
+	    while (ep > macro && ep[-1] == ';') *--ep = '\0';	/* allow trailing ';' */
+	    cp = macro + 1;
+	    if ((*macro != '"' && *macro != '<') || ep - cp < 2 ||
+		(ep[-1] != '"' && ep[-1] != '>')) {
+		return 1;
+	    }
+	    *--ep = '\0';
+	    if (isalpha((unsigned char)cp[0]) && cp[1] == ':') cp += 2;
+	    if (*cp == '/' || *cp == '\\') cp++;
+	    if (! isW1(*cp) && *cp != '.') {
+		return 1;			/* bad characters */
+	    }
+	    for (cp++; isW(*cp) || *cp == '/' || *cp == '\\' || *cp == '.'; cp++);
+	    if (*cp || (fp = openInclude(macro + 1)) == NULL) {
+		return 1;			/* bad characters or not found */
+	    }
+	    pFile[pTop].fp = fp;
+	    pFile[pTop].name = iC_emalloc(strlen(macro + 1) + 1);
+	    strcpy(pFile[pTop].name, macro + 1);
+	    pFile[pTop++].line = 0;
+	    blanks(bp);				/* $. and "file" already refer to %include file */
+	    snprintf(lineBuf, BUFS, "# 1 \"%s\" 1\n", pFile[pTop-1].name);
+	    pPut(bp, lineBuf, strlen(lineBuf));
+	} else {
+	    return 1;				/* %if %elif %error %warning %line etc */
+	}
+    } else if (strcmp(line, "%if") == 0 || strcmp(line, "%elif") == 0) {
+	return 1;
+    }
+    *sip = si;
+    return r;
+} /* directive */
+
+/********************************************************************
+ *
+ *	Pre-process iC file path with command line defines into *bufp
+ *	(allocated - to be freed by the caller) and its length into *lenp
+ *	Returns 0 if done, 1 if immac must be used instead
+ *
+ *******************************************************************/
+
+int
+iC_prep(char * path, char * defines, char ** bufp, size_t * lenp)
+{
+    PBuf	ob = { NULL, 0, 0 };		/* output */
+    PBuf	rb;
+    char *	line = NULL;
+    size_t	size = 0;
+    ssize_t	len;
+    char *	cp;
+    char *	ep;
+    int *	stk = NULL;			/* %ifdef nesting */
+    int		stkSize = 0;
+    int		stkCnt = 0;
+    int		si = 1;				/* sense indicator as in immac */
+    int		cDirective = 0;
+    int		n;
+    int		r = 0;
+    Macro *	mp;
+    char	lineBuf[BUFS];
+
+    macros = NULL;
+    blankLines = usedCnt = pTop = 0;
+    if (cmdDefines(defines, 'D') || cmdDefines(defines, 'U') ||
+	(pFile[0].fp = fopen(path, "r")) == NULL) {
+	r = 1;
+	goto end;
+    }
+    pFile[0].name = iC_emalloc(strlen(path) + 1);
+    strcpy(pFile[0].name, path);
+    pFile[0].line = 0;
+    pTop = 1;
+    while (pTop) {
+	PFile *	pf = &pFile[pTop-1];
+
+	if ((len = getline(&line, &size, pf->fp)) <= 0) {
+	    if (blankLines) {
+		blanks(&ob);			/* blank lines at end of file */
+	    }
+	    if (pTop > 1) {
+		fclose(pf->fp);
+		free(pf->name);
+		pTop--;
+		pf = &pFile[pTop-1];
+		snprintf(lineBuf, BUFS, "# %d \"%s\" 2\n", pf->line + (pEof(pf->fp) ? 0 : 1), pf->name);
+		pPut(&ob, lineBuf, strlen(lineBuf));
+		continue;
+	    }
+	    break;				/* end of main file */
+	}
+	pf->line++;
+	if (strlen(line) != (size_t)len) {
+	    r = 1;				/* NUL in input */
+	    goto end;
+	}
+	/********************************************************************
+	 *  #directives, %#directives and %%directives are output unchanged
+	 *******************************************************************/
+	for (cp = line; isS(*cp); cp++);
+	n = 0;
+	if (cp[0] == '%' && (cp[1] == '%' || cp[1] == '#')) n = 2;
+	else if (cp[0] == '#') n = 1;
+	if (cDirective || n) {
+	    if (! cDirective) {
+		for (ep = cp + n; isS(*ep); ep++);
+		if (! isKeyword(ep, allKeyword)) {
+		    goto notCdirective;
+		}
+	    }
+	    ep = line + len;
+	    if (ep > line && ep[-1] == '\n') ep--;
+	    cDirective = ep > line && ep[-1] == '\\';
+	    if (si <= 0) {
+		blankLines++;
+		continue;
+	    }
+	    if (blankLines) {
+		blanks(&ob);
+	    }
+	    pPut(&ob, line, len);
+	    continue;
+	}
+      notCdirective:
+	/********************************************************************
+	 *  %directives
+	 *******************************************************************/
+	if (*cp == '%') {
+	    for (ep = cp + 1; isS(*ep); ep++);
+	    if ((n = isKeyword(ep, allKeyword)) != 0) {
+		blankLines++;			/* directive is output as a blank line */
+		*cp++ = '%';
+		memmove(cp, ep, strlen(ep) + 1);	/* s/^\s*%\s*(define...)\b/%$1/ */
+		memmove(line, cp - 1, strlen(cp - 1) + 1);
+		for (ep = line + strlen(line); ep > line && isS(ep[-1]); ep--);
+		if (ep > line && ep[-1] == '\\') {
+		    r = 1;			/* continuation line */
+		    goto end;
+		}
+		for (cp = line; *cp && *cp != '\n' &&
+		    ! (cp[0] == '/' && (cp[1] == '*' || cp[1] == '/')); cp++);
+		if (*cp == '/') {		/* s!(\s*(/[*\/]).*)$! ! */
+		    while (cp > line && isS(cp[-1])) cp--;
+		    *cp = '\0';
+		}
+		for (ep = line + strlen(line); ep > line && isS(ep[-1]); ep--);
+		*ep = '\0';			/* s/\s+$// */
+		for (cp = ep = line; *cp; ) {	/* s/\s+/ /g */
+		    if (isS(*cp)) {
+			*ep++ = ' ';
+			while (isS(*cp)) cp++;
+		    } else {
+			*ep++ = *cp++;
+		    }
+		}
+		*ep = '\0';
+		if (directive(&ob, line, &si, &stk, &stkSize, &stkCnt)) {
+		    r = 1;
+		    goto end;
+		}
+		continue;
+	    }
+	}
+	/********************************************************************
+	 *  iC code
+	 *******************************************************************/
+	if (si <= 0 || strcmp(line, "\n") == 0) {
+	    blankLines++;			/* lines in false blocks and blank lines */
+	    continue;
+	}
+	if (blankLines) {
+	    blanks(&ob);
+	}
+	if (macros) {
+	    rb.buf = NULL;
+	    rb.len = rb.size = 0;
+	    resolve(&rb, line, len);
+	    pPut(&ob, rb.buf, rb.len);
+	    free(rb.buf);
+	} else {
+	    pPut(&ob, line, len);
+	}
+    }
+    if (stkCnt || si != 1 || ob.len == 0) {
+	r = 1;					/* missing %endif or no output */
+    }
+  end:
+    while (pTop) {
+	fclose(pFile[--pTop].fp);
+	free(pFile[pTop].name);
+    }
+    while ((mp = macros) != NULL) {
+	macros = mp->next;
+	free(mp->name);
+	free(mp->translate);
+	free(mp);
+    }
+    free(line);
+    free(stk);
+    if (r) {
+	free(ob.buf);
+	return 1;
+    }
+    *bufp = ob.buf;
+    *lenp = ob.len;
+    return 0;
+} /* iC_prep */
+#endif	/* _WIN32 */
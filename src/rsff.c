@@ -566,6 +566,20 @@ i_ff3(Gate * gm, int typ)			/* Pass3 init on FF etc. */
 	if (gm != iC_cList) {
 	    gm->gt_rptr = iC_cList;		/* iC_cList is alternate for link */
 	}					/* except iC_cList which has 0 */
+	if (gm->gt_fni == TIMRL) {
+	    /********************************************************************
+	     * a timer links its timed actions into a timing wheel - its own
+	     * list remains empty, but it is still a list head for iC_link_ol()
+	     *******************************************************************/
+	    Wheel *	wh;
+	    Gate *	hp;
+
+	    gm->gt_wheel = wh = (Wheel *)iC_emalloc(sizeof(Wheel));	/* cleared */
+	    for (hp = wh->wh_slot; hp < &wh->wh_slot[2 * WHL_SIZE]; hp++) {
+		hp->gt_ids = gm->gt_ids;	/* for debug and error messages */
+		Out_init(hp);			/* empty slot */
+	    }
+	}
     }
     if (gm->gt_fni != OUTW && gm->gt_fni != OUTX) {
 	gm->gt_mark = 0;			/* clear for stamp and diff in actions */
@@ -1431,6 +1445,9 @@ iC_clockSfn(					/* Clock function */
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 #ifndef DEQ
+#ifdef BLX
+	Blx(gs->gt_next) = iC_cList->gt_ptr;	/* iC_cList.last <== new */
+#endif	/* BLX */
 	iC_cList->gt_ptr->gt_next = gs->gt_next;
 	iC_cList->gt_ptr = gs->gt_ptr; 	/* link gs */
 	iC_cList->gt_ptr->gt_next = iC_cList;	/* to iC_cList */
@@ -1453,6 +1470,210 @@ iC_clockSfn(					/* Clock function */
 
 iC_Functp	iC_clock_i[] = {iC_pass1, iC_null1, i_ff3, iC_null1};	/* no output lists */
 
+/********************************************************************
+ *
+ *	Hierarchical timing wheel of a timer.
+ *
+ *	Each timed action is linked to one of the list heads in the two
+ *	levels of WHL_SIZE slots in the Wheel of its timer. gt_mark of
+ *	the action holds the tick of wh_now at which it is due. Actions
+ *	due within WHL_SIZE ticks are in the level 0 slot of that tick.
+ *	All others are in the level 1 slot of the block of WHL_SIZE ticks
+ *	in which they are due. When wh_now enters a new block, the level 1
+ *	slot of that block is cascaded into level 0.
+ *
+ *	Linking, unlinking after a glitch and the tick are constant time
+ *	operations no matter how many actions are being timed. Searching
+ *	for the next head entry after the head has been unlinked is
+ *	bounded by WHL_SIZE slots.
+ *
+ *******************************************************************/
+
+static Gate *
+wheelSlot(Wheel * wh, unsigned short due)
+{
+    if ((unsigned short)(due - wh->wh_now) < WHL_SIZE) {
+	return &wh->wh_slot[due & WHL_MASK];			/* level 0 */
+    }
+    return &wh->wh_slot[WHL_SIZE + ((due >> WHL_BITS) & WHL_MASK)];	/* level 1 */
+} /* wheelSlot */
+
+/********************************************************************
+ *
+ *	Link gp at the end of slot list hp or at its front if front != 0
+ *
+ *******************************************************************/
+
+static void
+wheelIns(Gate * gp, Gate * hp, int front)
+{
+    Gate *	tp;
+    Gate *	np;
+
+#ifndef DEQ
+    tp = front ? hp : hp->gt_ptr;		/* previous */
+    np = tp->gt_next;
+    tp->gt_next = gp;				/* previous => new */
+    gp->gt_next = np;				/* new => next */
+    if (np == hp) {
+	hp->gt_ptr = gp;			/* list => new */
+    }
+#ifdef BLX
+    Blx(gp) = tp;				/* previous <== new */
+    Blx(np) = gp;				/* new <== next */
+#endif	/* BLX */
+#else	/* DEQ */
+    tp = front ? hp : hp->gt_prev;		/* previous */
+    np = tp->gt_next;
+    np->gt_prev = tp->gt_next = gp;		/* next, previous ==> new */
+    gp->gt_next = np;				/* new ==> next */
+    gp->gt_prev = tp;				/* previous <== new */
+#endif	/* DEQ */
+} /* wheelIns */
+
+/********************************************************************
+ *
+ *	Find the head entry, which is the timed action due next
+ *
+ *	The first occupied level 0 slot holds it, unless that slot is
+ *	in a later block, when an entry in the first occupied level 1
+ *	slot may be due earlier.
+ *
+ *******************************************************************/
+
+static void
+wheelNext(Wheel * wh)
+{
+    Gate *		hp;
+    Gate *		gp;
+    unsigned short	now = wh->wh_now;
+    unsigned short	d;
+    unsigned short	dmin = 0;		/* 0 - no entry found */
+    int			i;
+
+    for (i = 1; i < WHL_SIZE; i++) {
+	hp = &wh->wh_slot[(now + i) & WHL_MASK];
+	if (hp->gt_next != hp) {
+	    dmin = i;				/* first occupied level 0 slot */
+	    break;
+	}
+    }
+    if (dmin == 0 || dmin >= WHL_SIZE - (now & WHL_MASK)) {
+	for (i = 1; i <= WHL_SIZE; i++) {
+	    hp = &wh->wh_slot[WHL_SIZE + (((now >> WHL_BITS) + i) & WHL_MASK)];
+	    if (hp->gt_next != hp) {
+		for (gp = hp->gt_next; gp != hp; gp = gp->gt_next) {
+		    d = gp->gt_mark - now;
+		    if (dmin == 0 || d < dmin) {
+			dmin = d;		/* level 1 slot is not sorted */
+		    }
+		}
+		break;
+	    }
+	}
+    }
+    wh->wh_next = now + dmin;
+    wh->wh_on = dmin != 0;
+} /* wheelNext */
+
+/********************************************************************
+ *
+ *	Link timed action gp with delay tc (1 - 0xffff) to timer gs
+ *
+ *******************************************************************/
+
+void
+iC_wheelLink(Gate * gp, Gate * gs, unsigned short tc)
+{
+    Wheel *	wh = gs->gt_wheel;
+
+    gp->gt_mark = wh->wh_now + tc;		/* tick when due */
+    wheelIns(gp, wheelSlot(wh, gp->gt_mark), 0);	/* after entries due earlier or at same tick */
+    if (wh->wh_on == 0 || tc < (unsigned short)(wh->wh_next - wh->wh_now)) {
+	wh->wh_next = gp->gt_mark;		/* gp is the new head entry */
+	wh->wh_on = 1;
+#if defined(TCP) || defined(LOAD)
+	iC_liveData(gs, tc);			/* timer starting count to VCD and/or iClive (clears iC_linked) */
+	iC_linked++;				/* iC_liveData() for timed Master Gate linked to timer */
+#endif /* defined(TCP) || defined(LOAD) */
+    }
+} /* iC_wheelLink */
+
+/********************************************************************
+ *
+ *	Unlink timed action gp of timer gs after a glitch
+ *
+ *	gp is either still in the wheel or it is already due and on
+ *	iC_cList, which is the alternate list of every timer. gt_mark
+ *	of gp is left with the time remaining (0 if it was due).
+ *
+ *******************************************************************/
+
+void
+iC_wheelUnlink(Gate * gp, Gate * gs)
+{
+    Wheel *		wh = gs->gt_wheel;
+    Gate *		tp;
+    Gate *		np;
+    unsigned short	rest;
+#ifndef DEQ
+    Gate *		hp;
+#endif	/* DEQ */
+
+    rest = gp->gt_mark - wh->wh_now;		/* time remaining */
+#ifndef DEQ
+#ifdef BLX
+    if (gp->gt_idx) {
+	tp = Blx(gp);				/* glitch - previous */
+    } else
+#endif	/* BLX */
+    {
+	/********************************************************************
+	 * find previous entry in the level 0 slot, the level 1 slot and
+	 * finally in iC_cList - each is short compared to all timed actions
+	 *******************************************************************/
+	hp = rest != 0 && rest < WHL_SIZE ? &wh->wh_slot[gp->gt_mark & WHL_MASK]
+		: &wh->wh_slot[WHL_SIZE + ((gp->gt_mark >> WHL_BITS) & WHL_MASK)];
+	for (tp = hp; tp->gt_next != gp; ) {
+#if YYDEBUG && (!defined(_WINDOWS) || defined(LOAD))
+	    iC_glit_nxt++;			/* count glitch scan */
+#endif	/* YYDEBUG && (!defined(_WINDOWS) || defined(LOAD)) */
+	    if ((tp = tp->gt_next) == hp) {	/* end of one list */
+		if (hp == iC_cList) {
+#if !defined(_WINDOWS) || defined(LOAD)
+		    fprintf(iC_errFP,
+    "\n%s: line %d: cannot find '%s' entry in timer '%s' or '%s' after glitch\n",
+    __FILE__, __LINE__, gp->gt_ids, gs->gt_ids, iC_cList->gt_ids);
+#endif	/* !defined(_WINDOWS) || defined(LOAD) */
+		    iC_quit(SIGUSR1);
+		}
+		tp = hp = hp < &wh->wh_slot[WHL_SIZE]
+		    ? &wh->wh_slot[WHL_SIZE + ((gp->gt_mark >> WHL_BITS) & WHL_MASK)]
+		    : iC_cList;			/* alternate */
+	    }
+	}
+    }
+    tp->gt_next = np = gp->gt_next;		/* previous ==> next */
+    gp->gt_next = 0;				/* unlink Gate */
+#ifdef BLX
+    Blx(np) = tp;				/* previous <== next */
+#endif	/* BLX */
+    if (np == iC_cList ||
+	(np >= wh->wh_slot && np < &wh->wh_slot[2 * WHL_SIZE])) {
+	np->gt_ptr = tp;			/* last entry - adjust pointer */
+    }
+#else	/* DEQ */
+    tp = gp->gt_prev;				/* glitch - previous */
+    tp->gt_next = np = gp->gt_next;		/* previous ==> next */
+    np->gt_prev = tp;				/* previous <== next */
+    gp->gt_next = gp->gt_prev = 0;		/* unlink Gate */
+#endif	/* DEQ */
+    if (wh->wh_on && gp->gt_mark == wh->wh_next) {
+	wheelNext(wh);				/* head entry was unlinked */
+    }
+    gp->gt_mark = rest;				/* time remaining */
+} /* iC_wheelUnlink */
+
 /********************************************************************
  *
  *	Timer driver function.
@@ -1463,6 +1684,10 @@ iC_Functp	iC_clock_i[] = {iC_pass1, iC_null1, i_ff3, iC_null1};	/* no output lis
  *		tim1 = TIMER(IX0.6);		// iClock is default clock
  *		tim2 = TIMER(IX0.7, tim1,3);	// timer tim1
  *
+ *	Every tick advances the timing wheel of the timer. The actions
+ *	due in this tick are linked to the end of iC_cList in the order
+ *	in which they were timed.
+ *
  *******************************************************************/
 
 void
@@ -1471,9 +1696,13 @@ iC_timerSfn(					/* Timer function */
     Gate *		out_list)		/* not used */
 {
     Gate *		gs;
-    Gate *		tp;			/* functions which are timed */
+    Gate *		gp;
+    Gate *		hp;
+    Gate *		tp;
     Gate *		np;
-    unsigned short	tc;			/* first entry timer count */
+    Wheel *		wh;
+    unsigned short	now;
+    unsigned short	tc;			/* head entry timer count */
     /********************************************************************
      * the timer list is controlled by a control block which is the slave
      * Gate structure which goes with this function
@@ -1486,51 +1715,67 @@ iC_timerSfn(					/* Timer function */
     }
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
     gs->gt_val = -1;				/* set for visualization only */
-    if ((np = gs->gt_next) != gs) {		/* skip if this clock list empty */
-	tc = --(np->gt_mark);			/* count down first entry */
+    wh = gs->gt_wheel;
+    if (wh->wh_on) {				/* skip if no actions are timed */
+	now = ++wh->wh_now;			/* count tick */
+	if ((now & WHL_MASK) == 0) {
+	    /********************************************************************
+	     * cascade level 1 slot of the new block into level 0. Reverse the
+	     * chain first, so that linking each entry at the front of its
+	     * level 0 slot keeps the order in which they were timed - ahead
+	     * of entries timed later, which went straight into level 0.
+	     *******************************************************************/
+	    hp = &wh->wh_slot[WHL_SIZE + ((now >> WHL_BITS) & WHL_MASK)];
+	    if ((np = hp->gt_next) != hp) {
+		tp = hp;
+		do {
+		    gp = np;
+		    np = gp->gt_next;
+		    gp->gt_next = tp;		/* reverse */
+		    tp = gp;
+		} while (np != hp);
+		Out_init(hp);			/* level 1 slot is empty */
+		while (tp != hp) {
+		    np = tp->gt_next;
+		    wheelIns(tp, wheelSlot(wh, tp->gt_mark), 1);
+		    tp = np;
+		}
+	    }
+	}
+	hp = &wh->wh_slot[now & WHL_MASK];
+	tc = (np = hp->gt_next) != hp ? 0 : wh->wh_next - now;
 #if YYDEBUG && !defined(_WINDOWS)
 	if (iC_debug & 0100) {
 	    iC_dc = 1;				/* allow for (time) */
-	    fprintf(iC_outFP, "!(%hu)\t%s", tc, np->gt_ids);
+	    fprintf(iC_outFP, "!(%hu)", tc);
+	    for (tp = np; tp != hp; tp = tp->gt_next) {
+		if (iC_dc++ >= 8) {
+		    iC_dc = 1;
+		    fprintf(iC_outFP, "\n\t");
+		}
+		fprintf(iC_outFP, "\t%s", tp->gt_ids);
+	    }
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-	if (tc == 0) {
-#ifdef DEQ
-	    /* DEQ link head of timer chain gs to end of iC_cList */
+	if (np != hp) {				/* actions due in this tick */
+#ifndef DEQ
+#ifdef BLX
+	    Blx(np) = iC_cList->gt_ptr;		/* iC_cList.last <== new */
+#endif	/* BLX */
+	    iC_cList->gt_ptr->gt_next = np;	/* link slot hp */
+	    iC_cList->gt_ptr = hp->gt_ptr;
+	    iC_cList->gt_ptr->gt_next = iC_cList;	/* to iC_cList */
+#else	/* DEQ */
+	    /* link chain of Gates in slot hp to end of iC_cList */
 	    tp = iC_cList->gt_prev;		/* save iC_cList.previous */
 	    tp->gt_next = np;			/* iC_cList.last ==> new */
 	    np->gt_prev = tp;			/* iC_cList.last <== new */
-#endif
-	    do {
-		tp = np;
-		if ((np = tp->gt_next) == gs) {
-		    break;			/* end of list found */
-#if YYDEBUG && !defined(_WINDOWS)
-		} else if (iC_debug & 0100) {
-		    if (iC_dc++ >= 8) {
-			iC_dc = 1;
-			fprintf(iC_outFP, "\n\t");
-		    }
-		    fprintf(iC_outFP, "\t!(%hu)\t%s", np->gt_mark, np->gt_ids);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
-		}
-	    } while (np->gt_mark == 0);		/* unlink sequence of 0 time entries */
-#ifndef DEQ
-	    iC_cList->gt_ptr->gt_next = gs->gt_next;/* => new */
-	    gs->gt_next = np;			/* timer => rest */
-	    iC_cList->gt_ptr = tp;		/* clock last => new last */
-	    tp->gt_next = iC_cList;    	/* new last => iC_cList */
-	    if (np == gs) {			/* last entry ? */
-		gs->gt_ptr = np;		/* yes - fix timer last */
-	    }
-#else	/* DEQ */
-	    /* DEQ link tail of timer chain which is due to iC_cList */
-	    tp->gt_next = iC_cList;		/* gs.last ==> iC_cList */
-	    iC_cList->gt_prev = tp;		/* gs.last <== iC_cList */
-	    /* the re-linking of gs works correctly also if np == gs */
-	    gs->gt_next = np;			/* gs ==> new new */
-	    np->gt_prev = gs;			/* gs <== new new */
+	    tp = hp->gt_prev;			/* save hp.previous */
+	    tp->gt_next = iC_cList;		/* hp.last ==> iC_cList */
+	    iC_cList->gt_prev = tp;		/* hp.last <== iC_cList */
 #endif	/* DEQ */
+	    Out_init(hp);			/* relink empty slot */
+	    wheelNext(wh);			/* find new head entry */
 	}
 #if defined(TCP) || defined(LOAD)
 	iC_linked++;
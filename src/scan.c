@@ -54,6 +54,21 @@ unsigned int	iC_bit2[] = {			/* used in i_ff2() and i_ff3() */
 		};
 
 Gate *		iC_gx;	/* used to point to action Gate in chMbit riMbit */
+Gate **		iC_arDirty;	/* -A ARN targets to execute once per pass (alloc in load) */
+#ifdef LOAD
+int		iC_bsWords;	/* -X words of AND OR evaluated in bit scan (alloc in load) */
+int		iC_bsBits;	/* member lanes, ONE and other nodes feeding members */
+Gate **		iC_bsGate;	/* node of each bit in iC_bsVal */
+int *		iC_bsSlotIx;	/* first input slot of each member word */
+unsigned long *	iC_bsInv;	/* inverted lanes of each input slot */
+int *		iC_bsTermIx;	/* first BitTerm of each input slot in iC_bsTerm */
+BitTerm *	iC_bsTerm;	/* rotated input words of all input slots */
+unsigned long *	iC_bsOr;	/* OR lanes of each member word */
+int *		iC_bsFanIx;	/* first fan out of each bit in iC_bsFan */
+int *		iC_bsFan;	/* member word fed by each fan out */
+unsigned long *	iC_bsVal;	/* value of every bit */
+unsigned long *	iC_bsDirty;	/* member words with a changed input */
+#endif	/* LOAD */
 #if YYDEBUG && !defined(_WINDOWS)
 short		iC_dc;	/* debug display counter in scan and rsff */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
@@ -74,142 +89,216 @@ short		iC_dc;	/* debug display counter in scan and rsff */
  *	The remaining actions are first converted from int to bit
  *	and require logical processing only.
  *
+ *	With -A targets with a cexe function are not executed for every
+ *	changed input. They are only marked in gt_dirty and collected in
+ *	iC_arDirty. When out_list is empty, each dirty target is executed
+ *	once, which may link further nodes to out_list for the next pass.
+ *	The master actions only see the final value of a pass, so CH_AR,
+ *	D_SH and F_SW still act on every change of that final value.
+ *
  *******************************************************************/
 
+static void	scan_ar_target(Gate * gp, Gate * op);
+
 void
 iC_scan_ar(Gate *	out_list)
 {
-#if INT_MAX == 32767 && defined (LONG16)
-    long		val;
-#else	/* INT_MAX == 32767 && defined (LONG16) */
-    int			val;
-#endif	/* INT_MAX == 32767 && defined (LONG16) */
     Gate *		gp;
     Gate **		lp;
     Gate *		op;
+    Gate **		dp;
 
 #if YYDEBUG && !defined(_WINDOWS)
     if (iC_debug & 0100) {
 	fprintf(iC_outFP, "\n== arith scan ==========");
     }
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-    while ((op = out_list->gt_next) != out_list) {	/* scan outputs */
+    dp = iC_arDirty;
+    for (;;) {
+	while ((op = out_list->gt_next) != out_list) {	/* scan outputs */
 #ifndef DEQ
-	out_list->gt_next = op->gt_next;		/* unlink from */
-	op->gt_next = 0;				/* output list */
-	if (op == out_list->gt_ptr) {			/* last entry ? */
-	    out_list->gt_ptr = out_list;		/* yes - fix pointer */
-	}
+	    out_list->gt_next = op->gt_next;		/* unlink from */
+#ifdef BLX
+	    Blx(op->gt_next) = out_list;		/* list <== next */
+#endif	/* BLX */
+	    op->gt_next = 0;				/* output list */
+	    if (op == out_list->gt_ptr) {		/* last entry ? */
+		out_list->gt_ptr = out_list;		/* yes - fix pointer */
+	    }
 #else	/* DEQ */
-	out_list->gt_next = gp = op->gt_next;		/* list ==> next */
-	gp->gt_prev = out_list;				/* list <== next */
-	op->gt_next = op->gt_prev = 0;			/* unlink Gate */
+	    out_list->gt_next = gp = op->gt_next;	/* list ==> next */
+	    gp->gt_prev = out_list;			/* list <== next */
+	    op->gt_next = op->gt_prev = 0;		/* unlink Gate */
 #endif	/* DEQ */
-	/********************************************************************
-	 * up to this point changes in gt_new back to gt_old could have
-	 * caused this Gate to be unlinked (glitch), resulting in the
-	 * following update executions of arithmetic functions not
-	 * being done. They are then no longer necessary, since no
-	 * change in the function results would occur.
-	 *******************************************************************/
-	op->gt_old = op->gt_new;			/* now new value is fixed */
+	    if (out_list->gt_lev && Lev_tail(out_list, op->gt_lev) == op) {
+		Lev_tail(out_list, op->gt_lev) = 0;	/* levelized - level now empty */
+	    }
+	    /********************************************************************
+	     * up to this point changes in gt_new back to gt_old could have
+	     * caused this Gate to be unlinked (glitch), resulting in the
+	     * following update executions of arithmetic functions not
+	     * being done. They are then no longer necessary, since no
+	     * change in the function results would occur.
+	     *******************************************************************/
+	    op->gt_old = op->gt_new;			/* now new value is fixed */
 #if YYDEBUG && !defined(_WINDOWS)
-	if (iC_debug & 0100) {
+	    if (iC_debug & 0100) {
 #if INT_MAX == 32767 && defined (LONG16)
-	    fprintf(iC_outFP, "\n%s:	%ld", op->gt_ids, op->gt_new);
+		fprintf(iC_outFP, "\n%s:	%ld", op->gt_ids, op->gt_new);
 #else	/* INT_MAX == 32767 && defined (LONG16) */
-	    fprintf(iC_outFP, "\n%s:	%d", op->gt_ids, op->gt_new);
+		fprintf(iC_outFP, "\n%s:	%d", op->gt_ids, op->gt_new);
 #endif	/* INT_MAX == 32767 && defined (LONG16) */
+		iC_dc = 0;
+	    }
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+	    lp = op->gt_list;
+	    while ((gp = *lp++) != 0) {
+		if (dp && gp->gt_fni != OUTW &&
+#ifdef LOAD
+		    *(gp->gt_rlist) != 0
+#else	/* LOAD */
+		    gp->gt_rlist
+#endif	/* LOAD */
+		) {
+		    if (gp->gt_dirty == 0) {
+			gp->gt_dirty = 1;		/* -A execute once later */
+			*dp++ = gp;
+		    }
+#if YYDEBUG && !defined(_WINDOWS)
+		    if (iC_debug & 0100) {
+			if (iC_dc++ >= 4) {
+			    iC_dc = 1;
+			    fprintf(iC_outFP, "\n\t");
+			}
+			fprintf(iC_outFP, "\t%s ~", gp->gt_ids);
+		    }
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+		} else {
+		    scan_ar_target(gp, op);
+		}
+	    }
+	}
+	if (dp == iC_arDirty) {
+	    break;					/* out_list and dirty list empty */
+	}
+	/********************************************************************
+	 * -A execute each dirty target once in the order it was marked
+	 *******************************************************************/
+#if YYDEBUG && !defined(_WINDOWS)
+	if (iC_debug & 0100) {
+	    fprintf(iC_outFP, "\n== arith dirty =========\n");
 	    iC_dc = 0;
 	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-	lp = op->gt_list;
-	while ((gp = *lp++) != 0) {
+	for (lp = iC_arDirty; lp < dp; lp++) {
+	    gp = *lp;
+	    gp->gt_dirty = 0;
+	    scan_ar_target(gp, 0);
+	}
+	dp = iC_arDirty;
+    }
+} /* iC_scan_ar */
+
+/********************************************************************
+ *
+ *	Execute the cexe function of target gp of arithmetic node op or
+ *	pass the value of op if gp has none (op is 0 for -A dirty targets)
+ *	and do the master action of gp if its value has changed.
+ *
+ *******************************************************************/
+
+static void
+scan_ar_target(Gate * gp, Gate * op)
+{
+#if INT_MAX == 32767 && defined (LONG16)
+    long		val;
+#else	/* INT_MAX == 32767 && defined (LONG16) */
+    int			val;
+#endif	/* INT_MAX == 32767 && defined (LONG16) */
 #ifdef LOAD
-	    iC_CFunctp exec;
+    iC_CFunctp		exec;
 #endif	/* LOAD */
-	    iC_scan_cnt++;				/* count scan operations */
-	    iC_gx = gp;					/* save old gp in iC_gx */
+
+    iC_scan_cnt++;				/* count scan operations */
+    iC_gx = gp;					/* save old gp in iC_gx */
 #if YYDEBUG && !defined(_WINDOWS)
-	    if (iC_debug & 0100) {
-		if (iC_dc++ >= 4) {
-		    iC_dc = 1;
-		    fprintf(iC_outFP, "\n\t");
-		}
-		if (gp->gt_fni == ARITH  ||
-		    gp->gt_fni == D_SH   ||
-		    gp->gt_fni == F_SW   ||
-		    gp->gt_fni == CH_AR ||
-		    gp->gt_fni == OUTW) {
+    if (iC_debug & 0100) {
+	if (iC_dc++ >= 4) {
+	    iC_dc = 1;
+	    fprintf(iC_outFP, "\n\t");
+	}
+	if (gp->gt_fni == ARITH  ||
+	    gp->gt_fni == D_SH   ||
+	    gp->gt_fni == F_SW   ||
+	    gp->gt_fni == CH_AR ||
+	    gp->gt_fni == OUTW) {
 #if INT_MAX == 32767 && defined (LONG16)
-		    fprintf(iC_outFP, "\t%s %ld ==>", gp->gt_ids, gp->gt_new);
+	    fprintf(iC_outFP, "\t%s %ld ==>", gp->gt_ids, gp->gt_new);
 #else	/* INT_MAX == 32767 && defined (LONG16) */
-		    fprintf(iC_outFP, "\t%s %d ==>", gp->gt_ids, gp->gt_new);
+	    fprintf(iC_outFP, "\t%s %d ==>", gp->gt_ids, gp->gt_new);
 #endif	/* INT_MAX == 32767 && defined (LONG16) */
-		} else {
-		    fprintf(iC_outFP, "\t%s %+d ==>", gp->gt_ids, gp->gt_val);
-		}
-	    }
+	} else {
+	    fprintf(iC_outFP, "\t%s %+d ==>", gp->gt_ids, gp->gt_val);
+	}
+    }
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 #ifdef LOAD
-	    if (gp->gt_fni != OUTW && (exec = (iC_CFunctp)*(gp->gt_rlist)) != 0) {
-		val = exec(gp);				/* compute arith expression */
-	    }
+    if (gp->gt_fni != OUTW && (exec = (iC_CFunctp)*(gp->gt_rlist)) != 0) {
+	val = exec(gp);				/* compute arith expression */
+    }
 #else	/* LOAD */
-	    if (gp->gt_fni != OUTW && gp->gt_rlist) {
-		val = iC_exec(gp->gt_rfunctn, gp);	/* must pass both -/+ */
-	    }
+    if (gp->gt_fni != OUTW && gp->gt_rlist) {
+	val = iC_exec(gp->gt_rfunctn, gp);	/* must pass both -/+ */
+    }
 #endif	/* LOAD */
-	    else {
-		val = op->gt_new;			/* pass value to master output */
-	    }
-	    /************************************************************
-	     *
-	     *	For any C_expressions, the computed value is returned.
-	     *
-	     ***********************************************************/
+    else {
+	val = op->gt_new;			/* pass value to master output */
+    }
+    /************************************************************
+     *
+     *	For any C_expressions, the computed value is returned.
+     *
+     ***********************************************************/
 
-	    if (gp->gt_fni == ARITH || gp->gt_fni == D_SH || gp->gt_fni == CH_AR ||
-		gp->gt_fni == F_SW || gp->gt_fni == OUTW) {
-		if (val != gp->gt_new) {
-		    gp->gt_new = val;
-		    (*masterAct[gp->gt_fni])(gp, iC_aList); /* arithmetic master action */
-		}
-	    } else if ((val = val ? -1 : 1) != gp->gt_val) {
-		gp->gt_val = val;			/* convert val to logic value */
-		(*masterAct[gp->gt_fni])(gp, iC_oList);/* logic master action */
-	    }
-	    /* global iC_gx is modified in arithmetic chMbit() master action */
-	    if (iC_gx->gt_fni == ARITH  ||
-		iC_gx->gt_fni == D_SH   ||
-		iC_gx->gt_fni == CH_AR ||
-		iC_gx->gt_fni == F_SW   ||
-		iC_gx->gt_fni == OUTW) {
+    if (gp->gt_fni == ARITH || gp->gt_fni == D_SH || gp->gt_fni == CH_AR ||
+	gp->gt_fni == F_SW || gp->gt_fni == OUTW) {
+	if (val != gp->gt_new) {
+	    gp->gt_new = val;
+	    (*masterAct[gp->gt_fni])(gp, iC_aList); /* arithmetic master action */
+	}
+    } else if ((val = val ? -1 : 1) != gp->gt_val) {
+	gp->gt_val = val;			/* convert val to logic value */
+	(*masterAct[gp->gt_fni])(gp, iC_oList);/* logic master action */
+    }
+    /* global iC_gx is modified in arithmetic chMbit() master action */
+    if (iC_gx->gt_fni == ARITH  ||
+	iC_gx->gt_fni == D_SH   ||
+	iC_gx->gt_fni == CH_AR ||
+	iC_gx->gt_fni == F_SW   ||
+	iC_gx->gt_fni == OUTW) {
 #if YYDEBUG && !defined(_WINDOWS)
-		if (iC_debug & 0100) {
+	if (iC_debug & 0100) {
 #if INT_MAX == 32767 && defined (LONG16)
-		    fprintf(iC_outFP, " %ld", iC_gx->gt_new);
+	    fprintf(iC_outFP, " %ld", iC_gx->gt_new);
 #else	/* INT_MAX == 32767 && defined (LONG16) */
-		    fprintf(iC_outFP, " %d", iC_gx->gt_new);
+	    fprintf(iC_outFP, " %d", iC_gx->gt_new);
 #endif	/* INT_MAX == 32767 && defined (LONG16) */
-		}
+	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 #if defined(TCP) || defined(LOAD)
-		iC_liveData(iC_gx, iC_gx->gt_new);	/* VCD and/or iClive */
+	iC_liveData(iC_gx, iC_gx->gt_new);	/* VCD and/or iClive */
 #endif
-	    } else {
+    } else {
 #if YYDEBUG && !defined(_WINDOWS)
-		if (iC_debug & 0100) {
-		    fprintf(iC_outFP, " %+d", iC_gx->gt_val);
-		}
+	if (iC_debug & 0100) {
+	    fprintf(iC_outFP, " %+d", iC_gx->gt_val);
+	}
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 #if defined(TCP) || defined(LOAD)
-		iC_liveData(iC_gx, iC_gx->gt_val < 0 ? 1 : 0); /* VCD and/or iClive */
+	iC_liveData(iC_gx, iC_gx->gt_val < 0 ? 1 : 0); /* VCD and/or iClive */
 #endif
-	    }
-	}
     }
-} /* iC_scan_ar */
+} /* scan_ar_target */
 
 /********************************************************************
  *
@@ -243,6 +332,9 @@ iC_scan(Gate *	out_list)
     while ((op = out_list->gt_next) != out_list) {	/* scan outputs */
 #ifndef DEQ
 	out_list->gt_next = op->gt_next;		/* unlink from */
+#ifdef BLX
+	Blx(op->gt_next) = out_list;			/* list <== next */
+#endif	/* BLX */
 	op->gt_next = 0;				/* output list */
 	if (op == out_list->gt_ptr) {			/* last entry ? */
 	    out_list->gt_ptr = out_list;		/* yes - fix pointer */
@@ -252,6 +344,9 @@ iC_scan(Gate *	out_list)
 	gp->gt_prev = out_list;				/* list <== next */
 	op->gt_next = op->gt_prev = 0;			/* unlink Gate */
 #endif	/* DEQ */
+	if (out_list->gt_lev && Lev_tail(out_list, op->gt_lev) == op) {
+	    Lev_tail(out_list, op->gt_lev) = 0;	/* levelized - level now empty */
+	}
 	/************************************************************
 	 * In the following code all proccessing for normal and
 	 * inverted targets are coded twice (identically) to speed up
@@ -439,6 +534,179 @@ iC_scan(Gate *	out_list)
 #endif	/* LOAD */
     }
 } /* iC_scan */
+#ifdef LOAD
+
+/********************************************************************
+ *
+ *	Start of the bit parallel scan -X
+ *
+ *	Called once after the 4 initialisation Passes. Set the value bit
+ *	of every member from its current value and normalise its gt_val
+ *	to -1 or +1. Set unused lanes and the ONE word. Set the value bit
+ *	of every other node from the value last passed on to its targets,
+ *	which differs from gt_val while it is linked. The first bit scan
+ *	evaluates every member word.
+ *
+ *	Remove the members from all forward lists, because iC_scan_bs()
+ *	rather than iC_scan() evaluates them from now on. A member changed
+ *	by iC_scan_bs() is only linked to iC_oList if some targets remain.
+ *
+ *******************************************************************/
+
+#define IsBs(gp) ((gp)->gt_fni == GATE && (gp)->gt_new > 0 &&\
+	(gp)->gt_new <= iC_bsWords * BS_BITS && iC_bsGate[(gp)->gt_new - 1] == (gp))
+
+void
+iC_bsInit(void)
+{
+    int		i;
+    int		cnt;
+    int		val;
+    Gate *	gp;
+    Gate *	tp;
+    Gate **	lp;
+    Gate **	fp;
+
+    for (i = 0; i < iC_bsBits; i++) {
+	if ((gp = iC_bsGate[i]) == 0) {
+	    val = 1;					/* unused lane or ONE word */
+	} else if (i < iC_bsWords * BS_BITS) {
+	    val = gp->gt_val < 0;			/* current value of member */
+	    gp->gt_val = val ? -1 : 1;			/* normalise count */
+	} else {
+	    val = (gp->gt_val < 0) ^ (gp->gt_next != 0);/* value seen by targets */
+	}
+	if (val) {
+	    iC_bsVal[i / BS_BITS] |= 1UL << (i % BS_BITS);
+	}
+	if (gp) {
+	    lp = fp = gp->gt_list;
+	    cnt = 2;					/* normal and inverted lists */
+	    do {
+		while ((tp = *lp++) != 0) {
+		    if (!IsBs(tp)) {
+			*fp++ = tp;			/* keep other targets */
+		    }
+		}
+		*fp++ = 0;
+	    } while (--cnt);
+	}
+    }
+    for (i = 0; i < iC_bsWords; i++) {
+	iC_bsDirty[i / BS_BITS] |= 1UL << (i % BS_BITS);
+    }
+    for (i = 0; i < iC_bsWords * BS_BITS; i++) {
+	if ((gp = iC_bsGate[i]) != 0) {
+	    gp->gt_new = 0;				/* member bit no longer needed */
+	}
+    }
+} /* iC_bsInit */
+
+/********************************************************************
+ *
+ *	Bit parallel scan of AND and OR members -X
+ *
+ *	Called whenever iC_oList is empty. The value of every input node
+ *	is final then. Inputs which changed since the last bit scan mark
+ *	the member words they feed as dirty. Dirty words are evaluated
+ *	lowest first, which is in order of level. All BS_BITS lanes of a
+ *	word are evaluated together, by gathering each input slot from
+ *	its rotated BitTerms and forming the AND of all slots. A member
+ *	which changes marks the words it feeds, which are all higher.
+ *
+ *	A changed member is handled by its master action like any other
+ *	logic node, so iC_scan() passes it on to its remaining targets.
+ *	Returns 1 if anything was linked to iC_oList.
+ *
+ *******************************************************************/
+
+int
+iC_scan_bs(void)
+{
+    int			i;
+    int			w;
+    int			b;
+    int			m;
+    int			val;
+    int *		fp;
+    int *		fe;
+    unsigned long	d;
+    unsigned long	x;
+    unsigned long	v;
+    unsigned long	bit;
+    BitTerm *		tp;
+    BitTerm *		te;
+    Gate *		gp;
+#if YYDEBUG && !defined(_WINDOWS)
+    int			dbg = iC_debug & 0100;
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+
+    for (i = (iC_bsWords + 1) * BS_BITS; i < iC_bsBits; i++) {	/* refresh input bits */
+	gp = iC_bsGate[i];
+	val = (gp->gt_val < 0) ^ (gp->gt_next != 0);
+	bit = 1UL << (i % BS_BITS);
+	if (((iC_bsVal[i / BS_BITS] & bit) != 0) != val) {
+	    iC_bsVal[i / BS_BITS] ^= bit;
+	    for (fp = &iC_bsFan[iC_bsFanIx[i]], fe = &iC_bsFan[iC_bsFanIx[i + 1]]; fp < fe; fp++) {
+		iC_bsDirty[*fp / BS_BITS] |= 1UL << (*fp % BS_BITS);
+	    }
+	}
+    }
+    for (i = 0; i < (iC_bsWords + BS_BITS - 1) / BS_BITS; i++) {
+	while ((d = iC_bsDirty[i]) != 0) {
+	    for (b = 0; (d & 0xff) == 0; b += 8) {
+		d >>= 8;
+	    }
+	    b += iC_bitIndex[d & 0xff];			/* lowest dirty word */
+	    iC_bsDirty[i] &= ~(1UL << b);
+	    w = i * BS_BITS + b;
+	    iC_scan_cnt++;				/* count scan operations */
+	    v = ~0UL;
+	    for (m = iC_bsSlotIx[w]; m < iC_bsSlotIx[w + 1]; m++) {
+		x = 0;
+		for (tp = &iC_bsTerm[iC_bsTermIx[m]], te = &iC_bsTerm[iC_bsTermIx[m + 1]]; tp < te; tp++) {
+		    x |= BsRotl(iC_bsVal[tp->bt_word], tp->bt_rot) & tp->bt_mask;
+		}
+		v &= x ^ iC_bsInv[m];			/* AND of input slots */
+	    }
+	    v ^= iC_bsOr[w];				/* OR is inverted AND of inverted inputs */
+	    d = v ^ iC_bsVal[w];			/* changed lanes */
+	    iC_bsVal[w] = v;
+	    while (d) {
+		x = d;
+		for (b = 0; (x & 0xff) == 0; b += 8) {
+		    x >>= 8;
+		}
+		b += iC_bitIndex[x & 0xff];		/* lowest changed lane */
+		d &= ~(1UL << b);
+		m = w * BS_BITS + b;
+		for (fp = &iC_bsFan[iC_bsFanIx[m]], fe = &iC_bsFan[iC_bsFanIx[m + 1]]; fp < fe; fp++) {
+		    iC_bsDirty[*fp / BS_BITS] |= 1UL << (*fp % BS_BITS);
+		}
+		val = (v >> b) & 1;
+		gp = iC_bsGate[m];
+		gp->gt_val = val ? -1 : 1;
+#if YYDEBUG && !defined(_WINDOWS)
+		if (dbg) {
+		    if (dbg == 0100) {
+			fprintf(iC_outFP, "\n== bit scan   ==========");
+			dbg = 1;			/* header only once */
+		    }
+		    fprintf(iC_outFP, "\n%s:	%+d", gp->gt_ids, gp->gt_val);
+		}
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+		if (gp->gt_list[0] || gp->gt_list[1]) {
+		    iC_gateMa(gp, iC_oList);		/* master action - link to iC_oList */
+		} else {
+		    iC_linked++;			/* show change even when no action */
+		}
+		iC_liveData(gp, val);			/* VCD and/or iClive */
+	    }
+	}
+    }
+    return iC_oList != iC_oList->gt_next;
+} /* iC_scan_bs */
+#endif	/* LOAD */
 
 /********************************************************************
  *
@@ -489,6 +757,9 @@ iC_scan_clk(Gate *	out_list)			/* scan a clock list */
     while ((op = out_list->gt_next) != out_list) {	/* scan outputs */
 #ifndef DEQ
 	out_list->gt_next = op->gt_next;		/* unlink from */
+#ifdef BLX
+	Blx(op->gt_next) = out_list;			/* list <== next */
+#endif	/* BLX */
 	op->gt_next = 0;				/* output list */
 	if (op == out_list->gt_ptr) {			/* last entry ? */
 	    out_list->gt_ptr = out_list;		/* yes - fix pointer */
@@ -529,6 +800,9 @@ iC_scan_snd(Gate *	out_list)
     while ((op = out_list->gt_next) != out_list) {
 #ifndef DEQ
 	out_list->gt_next = op->gt_next;		/* unlink from */
+#ifdef BLX
+	Blx(op->gt_next) = out_list;			/* list <== next */
+#endif	/* BLX */
 	op->gt_next = 0;				/* output list */
 	if (op == out_list->gt_ptr) {			/* last entry ? */
 	    out_list->gt_ptr = out_list;		/* yes - fix pointer */
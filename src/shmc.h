@@ -0,0 +1,167 @@
+/********************************************************************
+ *
+ *	Copyright (C) 2021  John E. Wulff
+ *
+ *  You may distribute under the terms of either the GNU General Public
+ *  License or the Artistic License, as specified in the README file.
+ *
+ *  For more information about this program, or for information on how
+ *  to contact the author, see the README file
+ *
+ *	shmc.h
+ *
+ *	Shared memory communication between iC clients and cserver
+ *	running on the same host
+ *
+ *	A client which connects to a local iCserver creates the file
+ *	SHM_DIR<name> holding one ShmArea and two named pipes (FIFO's)
+ *	SHM_DIR<name>.up and SHM_DIR<name>.dn, which are used as doorbells.
+ *	It requests the transport with the registration item M<name>
+ *	directly before 'Z'. An iCserver which supports it appends ",M"
+ *	to the last acknowledge string. All following messages in both
+ *	directions are written to the rings instead of the TCP/IP socket.
+ *	The messages keep their 4 byte length header - the rings carry
+ *	exactly the same byte stream as the socket would.
+ *
+ *	Each ring has a single producer and a single consumer and needs no
+ *	lock. The consumer sets 'waiting' before it sleeps on its doorbell;
+ *	the producer writes 1 byte to the doorbell only if 'waiting' is set.
+ *	A closed doorbell (end of file) means the other process has gone.
+ *
+ *******************************************************************/
+
+#ifndef SHMC_H
+#define SHMC_H
+static const char shmc_h[] =
+"@(#)$Id: shmc.h 1.1 $";
+
+#include	<errno.h>
+#include	<string.h>
+#include	<unistd.h>
+
+#define SHM_DIR		"/dev/shm/"	/* tmpfs - file names are passed without it */
+#define SHM_NSIZ	64		/* max size of a full file name */
+#define SHM_RING	65536		/* size of each ring - must be a power of 2 */
+
+typedef struct ShmRing {
+    unsigned int	head;		/* written by producer only */
+    char		pad1[60];	/* head and tail in different cache lines */
+    unsigned int	tail;		/* written by consumer only */
+    unsigned int	waiting;	/* consumer sleeps on doorbell */
+    char		pad2[56];
+    char		data[SHM_RING];
+} ShmRing;
+
+typedef struct ShmArea {
+    ShmRing		up;		/* client to server */
+    ShmRing		dn;		/* server to client */
+} ShmArea;
+
+/********************************************************************
+ *
+ *	Number of bytes ready to be read by the consumer
+ *
+ *******************************************************************/
+
+static inline int
+shmAvail(ShmRing * rp)
+{
+    return __atomic_load_n(&rp->head, __ATOMIC_ACQUIRE) - rp->tail;
+} /* shmAvail */
+
+/********************************************************************
+ *
+ *	Read up to len bytes from a ring - returns bytes read
+ *
+ *******************************************************************/
+
+static inline int
+shmRead(ShmRing * rp, char * buf, int len)
+{
+    unsigned int	tail = rp->tail;
+    unsigned int	i = tail & (SHM_RING - 1);
+    int			n = shmAvail(rp);
+    int			n1;
+
+    if (n > len) n = len;
+    if ((n1 = SHM_RING - i) > n) n1 = n;
+    memcpy(buf, rp->data + i, n1);
+    memcpy(buf + n1, rp->data, n - n1);	/* wrapped part */
+    __atomic_store_n(&rp->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+} /* shmRead */
+
+/********************************************************************
+ *
+ *	Write up to len bytes to a ring - returns bytes written
+ *
+ *******************************************************************/
+
+static inline int
+shmWrite(ShmRing * rp, const char * buf, int len)
+{
+    unsigned int	head = rp->head;
+    unsigned int	i = head & (SHM_RING - 1);
+    int			n = SHM_RING - (head - __atomic_load_n(&rp->tail, __ATOMIC_ACQUIRE));
+    int			n1;
+
+    if (n > len) n = len;
+    if ((n1 = SHM_RING - i) > n) n1 = n;
+    memcpy(rp->data + i, buf, n1);
+    memcpy(rp->data, buf + n1, n - n1);	/* wrapped part */
+    __atomic_store_n(&rp->head, head + n, __ATOMIC_RELEASE);
+    return n;
+} /* shmWrite */
+
+/********************************************************************
+ *
+ *	Consumer: announce sleeping on the doorbell
+ *	Returns bytes which arrived in the meantime - then do not sleep
+ *
+ *******************************************************************/
+
+static inline int
+shmArm(ShmRing * rp)
+{
+    int		n;
+
+    __atomic_store_n(&rp->waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);	/* pairs with fence in shmWake() */
+    if ((n = shmAvail(rp)) != 0) {
+	__atomic_store_n(&rp->waiting, 0, __ATOMIC_RELAXED);
+    }
+    return n;
+} /* shmArm */
+
+/********************************************************************
+ *
+ *	Producer: ring the doorbell after writing if the consumer sleeps
+ *
+ *******************************************************************/
+
+static inline void
+shmWake(ShmRing * rp, int bell)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);	/* pairs with fence in shmArm() */
+    if (__atomic_load_n(&rp->waiting, __ATOMIC_RELAXED)) {
+	__atomic_store_n(&rp->waiting, 0, __ATOMIC_RELAXED);
+	while (write(bell, "", 1) < 0 && errno == EINTR);	/* EAGAIN: bell is ringing already */
+    }
+} /* shmWake */
+
+/********************************************************************
+ *
+ *	Consumer: empty the doorbell - returns 0 if the producer has gone
+ *
+ *******************************************************************/
+
+static inline int
+shmDrain(int bell)
+{
+    char	buf[64];
+    int		r;
+
+    while ((r = read(bell, buf, sizeof(buf))) > 0 || (r < 0 && errno == EINTR));
+    return r;
+} /* shmDrain */
+#endif	/* SHMC_H */
@@ -80,26 +80,223 @@ hash(char *	string)				/* hash a string to table index */
     return (hsh >> 2);				/* divide by 4, range 54 * 64 / 4 */
 } /* hash */
 
-static Symbol **	spl;
+/********************************************************************
+ *
+ *	Symbols are found with a full string hash in an open addressing
+ *	table, which is doubled when it gets half full. This keeps lookup()
+ *	constant time for very large programs.
+ *
+ *	symlist[] is kept for the listings, which depend on its order:
+ *	symlists hashed on the first 2 characters, each sorted by strcmp().
+ *	Until sort_symlist() is called by the listing code, link_sym()
+ *	simply puts a new Symbol at the front of its symlist and marks
+ *	that list for sorting. Symbols linked later are inserted in order.
+ *
+ *******************************************************************/
 
-Symbol *
-lookup(char *	string)				/* find string in symbol table */
+#define	SYMTAB0	1024				/* initial size - must be a power of 2 */
+
+static Symbol **	symTab;			/* open addressing hash table */
+static unsigned		symSize;		/* size of symTab */
+static unsigned		symCount;		/* Symbols in symTab */
+static char		sorted[HASHSIZ];	/* symlist[] is sorted */
+static int		sortOn;			/* sort_symlist() has been called */
+
+static unsigned
+fnv(const char *	string)			/* FNV-1a hash of the full string */
 {
+    unsigned	h = 2166136261U;
+
+    while (*string) {
+	h ^= (unsigned char)*string++;
+	h *= 16777619U;
+    }
+    return h;
+} /* fnv */
+
+static unsigned
+probe(const char *	string)			/* slot holding string or empty slot */
+{
+    unsigned	i;
     Symbol *	sp;
-    int		i = 1;				/* must be != 0 in case empty */
 
-    spl = &symlist[hash(string)];
-    for (sp = *spl; sp != 0; spl = &sp->next, sp = *spl) {
-	if ((i = strcmp(string, sp->name)) <= 0) {
-	    break;				/* position where a new Symbol should go */
+    for (i = fnv(string) & (symSize - 1); (sp = symTab[i]) != 0; i = (i + 1) & (symSize - 1)) {
+	if (strcmp(string, sp->name) == 0) {
+	    break;				/* found */
+	}
+    }
+    return i;
+} /* probe */
+
+static void
+grow(void)					/* double the size of symTab */
+{
+    Symbol **	old = symTab;
+    unsigned	oldSize = symSize;
+    unsigned	i;
+
+    symSize = symSize ? symSize << 1 : SYMTAB0;
+    symTab = (Symbol **) iC_emalloc(symSize * sizeof(Symbol *));
+    for (i = 0; i < oldSize; i++) {
+	if (old[i]) {
+	    symTab[probe(old[i]->name)] = old[i];
+	}
+    }
+    if (old) {
+	free(old);
+    }
+} /* grow */
+
+static Symbol *
+merge(Symbol * a, Symbol * b)			/* merge 2 sorted lists - stable */
+{
+    Symbol *	head;
+    Symbol **	tpp = &head;
+
+    while (a && b) {
+	if (strcmp(b->name, a->name) < 0) {
+	    *tpp = b;
+	    b = b->next;
+	} else {
+	    *tpp = a;
+	    a = a->next;
 	}
+	tpp = &(*tpp)->next;
+    }
+    *tpp = a ? a : b;
+    return head;
+} /* merge */
+
+static Symbol *
+msort(Symbol * sp)				/* merge sort a symlist */
+{
+    Symbol *	slow;
+    Symbol *	fast;
+    Symbol *	b;
+
+    if (sp == 0 || sp->next == 0) {
+	return sp;
+    }
+    for (slow = sp, fast = sp->next; fast && fast->next; fast = fast->next->next) {
+	slow = slow->next;
     }
-    if (i == 0) {
-	return (sp);				/* found */
+    b = slow->next;
+    slow->next = 0;
+    return merge(msort(sp), msort(b));
+} /* msort */
+
+void
+sort_symlist(void)				/* sort symlist[] for listing */
+{
+    int		i;
+
+    for (i = 0; i < HASHSIZ; i++) {
+	if (! sorted[i]) {
+	    symlist[i] = msort(symlist[i]);
+	    sorted[i] = 1;
+	}
+    }
+    sortOn = 1;					/* keep symlist[] sorted from now on */
+} /* sort_symlist */
+
+Symbol *
+lookup(char *	string)				/* find string in symbol table */
+{
+    if (symCount == 0) {
+	return (0);				/* also symTab not allocated yet */
     }
-    return (0);					/* 0 ==> not found */
+    return (symTab[probe(string)]);		/* 0 ==> not found */
 } /* lookup */
 
+/********************************************************************
+ *
+ *	Symbols and List_e elements are allocated from large blocks and
+ *	recycled on free lists. Names are allocated from separate blocks
+ *	and are never freed. This avoids a malloc() and free() for every
+ *	node and name.
+ *
+ *******************************************************************/
+
+#define	ARENA	65536				/* size of each block */
+
+typedef union Align { long l; double d; void * p; } Align;
+
+static char *	nodeNext;			/* next free byte in node block */
+static char *	nodeEnd;
+static char *	nameNext;			/* next free byte in name block */
+static char *	nameEnd;
+static Symbol *	symFree;			/* free list on next */
+static List_e *	leFree;				/* free list on le_next */
+
+static void *
+arena(char ** nextp, char ** endp, unsigned n)	/* allocate n bytes from a block */
+{
+    char *	cp;
+
+    if (*nextp == 0 || *endp - *nextp < (long)n) {
+	unsigned	size = n > ARENA ? n : ARENA;
+	*nextp = iC_emalloc(size);		/* zeroed - rest of old block is abandoned */
+	*endp = *nextp + size;
+    }
+    cp = *nextp;
+    *nextp += n;
+    return cp;
+} /* arena */
+
+Symbol *
+new_sym(void)					/* zeroed Symbol */
+{
+    Symbol *	sp;
+
+    if ((sp = symFree) != 0) {
+	symFree = sp->next;
+	memset(sp, 0, sizeof(Symbol));
+	return sp;
+    }
+    return (Symbol *) arena(&nodeNext, &nodeEnd,
+	(sizeof(Symbol) + sizeof(Align) - 1) / sizeof(Align) * sizeof(Align));
+} /* new_sym */
+
+void
+free_sym(Symbol *	sp)			/* recycle Symbol - name is kept */
+{
+    if (sp) {
+	sp->next = symFree;
+	symFree = sp;
+    }
+} /* free_sym */
+
+List_e *
+new_le(void)					/* zeroed List_e */
+{
+    List_e *	lp;
+
+    if ((lp = leFree) != 0) {
+	leFree = lp->le_next;
+	memset(lp, 0, sizeof(List_e));
+	return lp;
+    }
+    return (List_e *) arena(&nodeNext, &nodeEnd,
+	(sizeof(List_e) + sizeof(Align) - 1) / sizeof(Align) * sizeof(Align));
+} /* new_le */
+
+void
+free_le(List_e *	lp)			/* recycle List_e */
+{
+    if (lp) {
+	lp->le_next = leFree;
+	leFree = lp;
+    }
+} /* free_le */
+
+char *
+new_name(const char *	string)		/* copy of string which is never freed */
+{
+    unsigned	n = strlen(string) + 1;		/* +1 for '\0' */
+
+    return memcpy(arena(&nameNext, &nameEnd, n), string, n);
+} /* new_name */
+
 Symbol *
 install(					/* install string in symbol table */
     char *		string,
@@ -108,9 +305,8 @@ install(					/* install string in symbol table */
 {
     Symbol *		sp;
 
-    sp = (Symbol *) iC_emalloc(sizeof(Symbol));
-    sp->name = iC_emalloc(strlen(string)+1);	/* +1 for '\0' */
-    strcpy(sp->name, string);
+    sp = new_sym();
+    sp->name = new_name(string);
     sp->type = typ;
     sp->ftype = ftyp;
     return (link_sym(sp));
@@ -119,29 +315,61 @@ install(					/* install string in symbol table */
 Symbol *
 link_sym(Symbol *	sp)			/* link Symbol into symbol table */
 {
-    Symbol *	tsp;
+    Symbol **	tpp;
+    unsigned	i;
+    int		h;
 
-    if (spl == 0 || ((tsp = *spl) != 0 && strcmp(tsp->name, sp->name) != 0)) {
-	if (lookup(sp->name) != 0) {		/* locate sorted position */
-	    ierror("trying to place existing symbol:", sp->name);
+    if (symCount >= symSize >> 1) {
+	grow();					/* keep symTab at most half full */
+    }
+    i = probe(sp->name);
+    if (symTab[i]) {
+	ierror("trying to place existing symbol:", sp->name);
+    } else {
+	symCount++;
+    }
+    symTab[i] = sp;				/* latest Symbol with this name is found */
+    tpp = &symlist[h = hash(sp->name)];
+    if (sortOn) {
+	while (*tpp && strcmp(sp->name, (*tpp)->name) > 0) {
+	    tpp = &(*tpp)->next;		/* locate sorted position */
 	}
+    } else {
+	sorted[h] = 0;				/* sort before listing */
     }
-    sp->next = *spl;				/* point from this to next Symbol */
-    *spl = sp;					/* point from previous to this Symbol */
-    spl = 0;					/* force execution of lookup() for next call */
+    sp->next = *tpp;				/* point from this to next Symbol */
+    *tpp = sp;					/* point from previous to this Symbol */
     return (sp);
 } /* link_sym */
 
 Symbol *
 unlink_sym(Symbol *	sp)			/* unlink Symbol from symbol table - keep name and attributes */
 {
-    Symbol *	tsp;
+    Symbol **	tpp;
+    unsigned	i;
+    unsigned	j;
+    unsigned	k;
 
     if (sp) {
-	if ((tsp = lookup(sp->name)) != 0) {	/* locate sorted position */
-	    assert(tsp == sp);
-	    *spl = sp->next;			/* skip this Symbol, point previous to next */
-	    spl = 0;				/* force execution of lookup() for next call */
+	for (tpp = &symlist[hash(sp->name)]; *tpp && *tpp != sp; tpp = &(*tpp)->next);
+	if (*tpp) {
+	    *tpp = sp->next;			/* skip this Symbol, point previous to next */
+	    if (symTab[i = probe(sp->name)] == sp) {
+		/********************************************************************
+		 * backward shift deletion - move following Symbols of the same
+		 * cluster into the freed slot unless they are already in place
+		 *******************************************************************/
+		symTab[i] = 0;
+		symCount--;
+		for (j = (i + 1) & (symSize - 1); symTab[j]; j = (j + 1) & (symSize - 1)) {
+		    k = fnv(symTab[j]->name) & (symSize - 1);	/* home slot */
+		    if (((j - k) & (symSize - 1)) >= ((j - i) & (symSize - 1))) {
+			symTab[i] = symTab[j];
+			symTab[j] = 0;
+			i = j;
+		    }
+		}
+	    }
 	} else {
 	    ierror("trying to delete a Symbol not yet installed:", sp->name);
 	}
@@ -154,8 +382,5 @@ void
 uninstall(Symbol *	sp)			/* completely remove the Symbol */
 {
     unlink_sym(sp);				/* unlink Symbol from symbol table */
-    if (sp->name) {
-	free(sp->name);				/* free name space */
-    }
-    free(sp);					/* delete Symbol and free Symbol space */
+    free_sym(sp);				/* recycle Symbol - name is not freed */
 } /* uninstall */
@@ -70,6 +70,12 @@ static const char RCS_Id[] =
 #else	/* ! _WIN32 Linux */
 #include	<netdb.h>
 #include	<sys/time.h>
+#include	<sys/mman.h>
+#include	<sys/stat.h>
+#include	<fcntl.h>
+#include	<poll.h>
+#include	<sys/un.h>
+#include	<pthread.h>
 #endif	/* _WIN32 */
 #include	<ctype.h>
 #include	<errno.h>
@@ -78,6 +84,9 @@ static const char RCS_Id[] =
 #include	<time.h>
 #include	"tcpc.h"
 #include	"icc.h"
+#ifndef	_WIN32
+#include	"shmc.h"
+#endif	/* _WIN32 */
 
 const char *	iC_hostNM = LOCALHOST1;		/* localhost or 127.0.0.1 */
 const char *	iC_portNM = iC_PORT;		/* 8778 iC well known port */
@@ -94,29 +103,150 @@ fd_set		iC_exfds;
  *
  *	private structures and variables
  *
- *	NetBuffer matches buffer used in Perl module msg.pm
+ *	Each message (frame) is a 4 byte big endian length header followed
+ *	by the data, which matches the frames used in Perl module iCmsg.pm
+ *
+ *	Received data is collected in rcvBuf by one recv() for as much as
+ *	is available, which may hold several complete frames and the start
+ *	of another. Frames of any size are reassembled - rcvBuf and sndBuf
+ *	grow as required.
  *
  *******************************************************************/
 
-typedef struct NetBuffer {
-#if INT_MAX == 32767 && defined (LONG16)
-    long	length;
-#else
-    int		length;
-#endif
-    char	buffer[REPLY+4];
-} NetBuffer;
+#define HSIZ	4			/* size of length header */
+#define FSIZ	(REPLY+HSIZ)		/* initial size of frame buffers */
+
+typedef struct FrameBuffer {
+    SOCKET	sock;			/* socket data in buf was received from */
+    char *	buf;			/* received frames - initially NULL */
+    int		size;			/* allocated size of buf */
+    int		head;			/* start of next frame not yet delivered */
+    int		tail;			/* end of data received so far */
+} FrameBuffer;
+
+static FrameBuffer	rcvBuf = { -1, NULL, 0, 0, 0 };
+static char *		sndBuf = NULL;	/* header and frame to send - initially NULL */
+static int		sndSize = 0;
+static int		frameReady(SOCKET sock);
+static int		rcvSome(SOCKET sock);
+#ifndef	_WIN32
+static char *		rcvFrame(int * lenp);
+#endif	/* _WIN32 */
+
+#ifndef	_WIN32
+/********************************************************************
+ *
+ *	Shared memory transport with a local iCserver (see shmc.h)
+ *
+ *	Requested with the last registration if iCserver is on 127.0.0.1.
+ *	Used for all messages after iCserver acknowledged it with ",M".
+ *	iCservers which do not acknowledge it keep using TCP/IP.
+ *
+ *	With -s unix:<path> the client connects to a Unix domain socket
+ *	instead of TCP/IP. The frames are the same. Shared memory is
+ *	requested as well, since the iCserver is always local.
+ *
+ *******************************************************************/
+
+#define SHM_NONE	0		/* TCP/IP only */
+#define SHM_LOCAL	1		/* iCserver is local - request with last registration */
+#define SHM_ASKED	2		/* requested - wait for acknowledgment */
+#define SHM_ON		3		/* all messages use shared memory */
+
+static int		shmState = SHM_NONE;
+static ShmArea *	shm = NULL;	/* mapped rings */
+static int		shmUp = -1;	/* doorbell to iCserver */
+static int		shmDn = -1;	/* doorbell from iCserver */
+static char		shmName[SHM_NSIZ];	/* file name in SHM_DIR */
+static char		shmPath[SHM_NSIZ + sizeof(SHM_DIR)];
+
+/********************************************************************
+ *
+ *	Asynchronous sender thread (option -j)
+ *
+ *	Frames with their length headers are queued in sndQ by the scan
+ *	thread and sent to iCserver by the sender thread, so a slow
+ *	iCserver does not hold up the scan. sndQ is a single producer
+ *	single consumer ring like the shared memory rings, with a pipe
+ *	as doorbell. The scan thread only waits if sndQ is full.
+ *
+ *	Output data which does not fit into sndQ is collected per channel
+ *	in coal[] instead - a later value replaces an earlier value for
+ *	the same channel. The sender thread sends the collected values as
+ *	soon as sndQ is empty. Any other message from the scan thread is
+ *	queued after the collected values, which keeps the order of
+ *	messages. coal[] is shared by both threads and locked by coalLock.
+ *
+ *******************************************************************/
+
+typedef struct Coal {
+    unsigned short	channel;
+    long		val;
+} Coal;
+
+static ShmRing *	sndQ = NULL;	/* frames queued for the sender thread */
+static int		sndBell[2] = { -1, -1 };	/* doorbell pipe to the sender thread */
+static int		sndStop = 0;	/* set by scan thread after the last frame */
+static SOCKET		sndSock;	/* socket used by the sender thread */
+static pthread_t	sndThread;
+static Coal *		coal = NULL;	/* values collected per channel - initially NULL */
+static int		coalSize = 0;	/* allocated size of coal[] */
+static int		coalN = 0;	/* channels collected in coal[] */
+static int *		coalIdx = NULL;	/* index + 1 into coal[] per channel - initially NULL */
+static int		coalTop = 0;	/* allocated size of coalIdx[] */
+static int		coalBin = 0;	/* collected values were received in binary frames */
+static char *		coalBuf = NULL;	/* frames built from coal[] - initially NULL */
+static int		coalBufSize = 0;
+static pthread_mutex_t	coalLock = PTHREAD_MUTEX_INITIALIZER;
+static struct timespec	ms1 = { 0, 1000000, };
+
+static struct {				/* backpressure accounting */
+    unsigned long	frames;		/* frames queued */
+    unsigned long	waits;		/* scan thread waited for room in sndQ */
+    unsigned long	values;		/* values collected in coal[] */
+    unsigned long	merged;		/* values replaced by a later value */
+    unsigned int	maxDepth;	/* most bytes waiting in sndQ */
+} sndStat;
+
+/********************************************************************
+ *
+ *	Receive thread (option -r)
+ *
+ *	After registration the receive thread reads all frames from
+ *	iCserver and queues them in rcvQ for the scan thread. Frames
+ *	which contain only channel:value items - ASCII or binary - are
+ *	parsed and queued as an array of ChannelValue. Any other frame
+ *	and frames for rawChannel (Debug messages) are queued unchanged.
+ *	Each entry in rcvQ starts with its type RCV_VALUES or RCV_FRAME
+ *	followed by a length header. The scan thread waits on the doorbell
+ *	rcvBell instead of iC_sockFN and takes all values queued one after
+ *	the other in one go. iC_rcvd_frame_from_server() gets the next
+ *	entry from rcvQ - values are converted back to an ASCII frame.
+ *
+ *******************************************************************/
+
+#define RCV_FRAME	'F'		/* rcvQ entry is a frame as received */
+#define RCV_VALUES	'V'		/* rcvQ entry is an array of ChannelValue */
+
+static ShmRing *	rcvQ = NULL;	/* entries queued by the receive thread */
+static int		rcvBell[2] = { -1, -1 };	/* doorbell pipe to the scan thread */
+static SOCKET		rcvSock;	/* socket read by the receive thread */
+static unsigned short	rcvRaw;		/* frames for this channel are not parsed */
+static pthread_t	rcvThread;
+static char *		rcvEntry = NULL;	/* entry taken by the scan thread - initially NULL */
+static int		rcvEntrySize = 0;
+#endif	/* _WIN32 */
 
 #ifdef	_WIN32
 static int	freqFlag;
 static double	frequency;
 static LARGE_INTEGER freq, start, end;
 #else	/* not  _WIN32 */
-static struct timeval	mt0;
-static struct timeval	mt1;
 static struct timespec	ms200 = { 0, 200000000, };
 #endif	/* _WIN32 */
 #if YYDEBUG && !defined(_WINDOWS)
+static struct timeval	mt0;
+static struct timeval	mt1;
 
 /********************************************************************
  *
@@ -154,16 +284,86 @@ iC_microPrint(const char * str, int mask)
 } /* iC_microPrint */
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
 
+#define TLEN	100
+
+#ifndef	_WIN32
+/********************************************************************
+ *
+ *	Connect to a server listening on a Unix domain socket 'path'
+ *	given as -s unix:<path> - 'port' is not used.
+ *	The byte stream and its frames are the same as for TCP/IP.
+ *	Return:	socket file number
+ *
+ *******************************************************************/
+
+static SOCKET
+connectUnix(const char * path)
+{
+    SOCKET		sock;
+    struct sockaddr_un	server;
+    int			r;
+    int			len;
+    char 		cp[TLEN];
+
+    if (strlen(path) >= sizeof(server.sun_path)) {
+	fprintf(iC_errFP, "ERROR in %s: Unix domain socket path '%s' is too long\n",
+	    iC_iccNM, path);
+	iC_quit(SIGUSR1);
+    }
+    if ((sock = socket(PF_UNIX, SOCK_STREAM, 0)) < 0) {
+	perror("socket failed");
+	iC_quit(SIGUSR1);
+    }
+    fcntl(sock, F_SETFD, FD_CLOEXEC);		/* not inherited by iCserver forked below */
+
+    memset(&server, 0, sizeof(server));
+    server.sun_family = AF_UNIX;
+    strcpy(server.sun_path, path);
+
+    for (r = 0; connect(sock, (SA)&server, sizeof(server)) < 0; ) {
+	/********************************************************************
+	 *  a Unix domain socket is always local - iCserver is forked on
+	 *  the first iteration like for 127.0.0.1. iC_fork_and_exec()
+	 *  passes -s unix:<path> on, so iCserver listens on the same path.
+	 *******************************************************************/
+	if (r < 50 && (errno == ENOENT || errno == ECONNREFUSED)) {	/* wait 10 seconds max */
+	    if (r == 0) {
+		len = snprintf(cp, TLEN, "iCserver -kz%s%s",
+		    (isatty(fileno(stdin))) ? "a" : "",	/* [autovivify] if stdin is a terminal (not pipe) */
+		    (iC_debug & DQ)         ? "q" : "");	/* [quiet] */
+		assert(len < sizeof cp);			/* unlikely since message is fixed size */
+		iC_fork_and_exec(iC_string2argv(cp, 2));	/* fork iCserver -kz[a][q] block STDIN */
+		iC_Xflag = 1;		/* this process started iCserver */
+	    }
+	    r++;
+	} else {
+	    fprintf(iC_errFP, "ERROR in %s: client could not be connected to server '%s%s'\n",
+		iC_iccNM, UNIX_PREFIX, path);
+	    perror("connect failed");
+	    iC_quit(SIGUSR1);
+	}
+	nanosleep(&ms200, NULL);
+    }
+
+    if (iC_osc_lim != 0 && (iC_debug & DQ) == 0) { /* suppress connection info for unlimited oscillations */
+	fprintf(iC_errFP, "'%s' connected to iCserver at '%s%s'\n",
+	    iC_iccNM, UNIX_PREFIX, path);
+    }
+    snprintf(shmName, SHM_NSIZ, "iC.%d", (int)getpid());
+    shmState = SHM_LOCAL;			/* offer shared memory with last registration */
+    return sock;
+} /* connectUnix */
+#endif	/* _WIN32 */
+
 /********************************************************************
  *
  *	Connect to server 'host' and 'port' as a client
  *	Use 'iccNM' for messages (do not register with server)
+ *	'host' may be unix:<path> for a Unix domain socket (not _WIN32)
  *	Return:	socket file number
  *
  *******************************************************************/
 
-#define TLEN	100
-
 SOCKET
 iC_connect_to_server(const char *	host,
 		     const char *	port)
@@ -214,6 +414,10 @@ iC_connect_to_server(const char *	host,
     }
 
     /* The WinSock DLL is acceptable. Proceed. */
+#else	/* ! _WIN32 Linux */
+    if (IS_UNIX(host)) {
+	return connectUnix(host + sizeof(UNIX_PREFIX) - 1);
+    }
 #endif	/* _WIN32 */
 
     if (isdigit(*host)) {
@@ -320,10 +524,179 @@ iC_connect_to_server(const char *	host,
 	fprintf(iC_errFP, "'%s' connected to iCserver at '%s:%d'\n",
 	    iC_iccNM, inet_ntoa(server.sin_addr), ntohs(server.sin_port));
     }
+#ifndef	_WIN32
+    if (strcmp(inet_ntoa(server.sin_addr), "127.0.0.1") == 0) {
+	snprintf(shmName, SHM_NSIZ, "iC.%d", (int)getpid());
+	shmState = SHM_LOCAL;			/* offer shared memory with last registration */
+    }
+#endif	/* _WIN32 */
 
     return sock;
 } /* iC_connect_to_server */
 
+#ifndef	_WIN32
+/********************************************************************
+ *
+ *	Remove the names of the shared memory files. With all != 0 also
+ *	unmap the rings and close the doorbells - use TCP/IP only.
+ *
+ *******************************************************************/
+
+static void
+shmRemove(int all)
+{
+    int		n = strlen(shmPath);
+
+    unlink(shmPath);
+    strcpy(shmPath + n, ".up");
+    unlink(shmPath);
+    strcpy(shmPath + n, ".dn");
+    unlink(shmPath);
+    shmPath[n] = '\0';
+    if (all) {
+	if (shm) munmap(shm, sizeof(ShmArea));
+	if (shmUp >= 0) close(shmUp);
+	if (shmDn >= 0) close(shmDn);
+	shm = NULL;
+	shmUp = shmDn = -1;
+	shmState = SHM_NONE;
+    }
+} /* shmRemove */
+
+/********************************************************************
+ *
+ *	Create the rings and doorbells offered to a local iCserver
+ *	Return:	1 if successful
+ *
+ *******************************************************************/
+
+static int
+shmCreate(void)
+{
+    int		fd;
+    int		n;
+
+    n = snprintf(shmPath, sizeof shmPath - 3, SHM_DIR "%s", shmName);	/* leave room for ".up" */
+    unlink(shmPath);				/* left over from a crashed process with same pid */
+    if ((fd = open(shmPath, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600)) < 0) {
+	goto failed;
+    }
+    if (ftruncate(fd, sizeof(ShmArea)) < 0 ||
+	(shm = mmap(NULL, sizeof(ShmArea), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+	shm = NULL;
+	close(fd);
+	goto failed;
+    }
+    close(fd);					/* mapping stays valid */
+    shm->up.waiting = shm->dn.waiting = 1;	/* first message rings the doorbell */
+    strcpy(shmPath + n, ".up");
+    unlink(shmPath);
+    if (mkfifo(shmPath, 0600) < 0) goto failed;
+    strcpy(shmPath + n, ".dn");
+    unlink(shmPath);
+    if (mkfifo(shmPath, 0600) < 0 ||
+	(shmDn = open(shmPath, O_RDONLY | O_NONBLOCK | O_CLOEXEC)) < 0) {
+	goto failed;				/* read end must be open for iCserver to open write end */
+    }
+    shmPath[n] = '\0';
+    return 1;
+
+  failed:
+    shmPath[n] = '\0';
+#if YYDEBUG && !defined(_WINDOWS)
+    if (iC_debug & 04) fprintf(iC_outFP, "%s: no shared memory %s: %s\n", iC_iccNM, shmPath, strerror(errno));
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+    shmRemove(1);
+    return 0;
+} /* shmCreate */
+
+/********************************************************************
+ *
+ *	Check the acknowledgment of the last registration for ",M"
+ *	Remove ",M" from the acknowledgment and switch to shared memory,
+ *	or fall back to TCP/IP only.
+ *
+ *******************************************************************/
+
+static void
+shmAck(const char * fp, int * lenp)
+{
+    int		n = strlen(shmPath);
+
+    if (*lenp >= 2 && fp[*lenp - 2] == ',' && fp[*lenp - 1] == 'M') {
+	*lenp -= 2;				/* client does not see ",M" */
+	strcpy(shmPath + n, ".up");
+	shmUp = open(shmPath, O_WRONLY | O_NONBLOCK | O_CLOEXEC);	/* iCserver has read end open */
+	shmPath[n] = '\0';
+	if (shmUp >= 0) {
+	    shmRemove(0);			/* names are no longer needed */
+	    shmState = SHM_ON;
+#if YYDEBUG && !defined(_WINDOWS)
+	    if (iC_debug & 04) fprintf(iC_outFP, "%s: shared memory %s\n", iC_iccNM, shmName);
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+	    return;
+	}
+	fprintf(iC_errFP, "ERROR in %s: cannot open doorbell %s.up: %s\n", iC_iccNM, shmPath, strerror(errno));
+	iC_quit(SIGUSR1);			/* iCserver already uses shared memory */
+    }
+    shmRemove(1);				/* not supported by iCserver */
+} /* shmAck */
+
+/********************************************************************
+ *
+ *	Write a header and frame to iCserver via shared memory
+ *	Wait if the ring is full until iCserver has read some of it
+ *
+ *******************************************************************/
+
+static void
+shmSend(const char * buf, int len)
+{
+    struct pollfd	pfd;
+    int			n;
+
+    for (;;) {
+	n = shmWrite(&shm->up, buf, len);
+	shmWake(&shm->up, shmUp);
+	if ((len -= n) == 0) break;
+	buf += n;
+	pfd.fd = shmDn;				/* only POLLHUP if iCserver has gone */
+	pfd.events = 0;
+	if (poll(&pfd, 1, 1) > 0) {
+	    fprintf(iC_errFP, "ERROR in %s: iCserver has gone\n", iC_iccNM);
+	    iC_quit(SIGUSR1);
+	}
+    }
+} /* shmSend */
+
+/********************************************************************
+ *
+ *	Receive up to len bytes from iCserver via shared memory
+ *	Wait on the doorbell if nothing is available
+ *	Return 0 if iCserver has gone
+ *
+ *******************************************************************/
+
+static int
+shmRecv(char * buf, int len)
+{
+    struct pollfd	pfd;
+    int			n;
+
+    while ((n = shmRead(&shm->dn, buf, len)) == 0) {
+	if (shmArm(&shm->dn) == 0) {
+	    pfd.fd = shmDn;
+	    pfd.events = POLLIN;
+	    while (poll(&pfd, 1, -1) < 0 && errno == EINTR);
+	    if (shmDrain(shmDn) == 0 && shmAvail(&shm->dn) == 0) {
+		return 0;			/* doorbell closed by iCserver */
+	    }
+	}
+    }
+    return n;
+} /* shmRecv */
+#endif	/* _WIN32 */
+
 /********************************************************************
  *
  *	Wait for next selected input, optional extra input or timer event
@@ -335,16 +708,61 @@ iC_wait_for_next_event(fd_set * infdsp, fd_set * ixfdsp, struct timeval * ptv)
 {
     fd_set *	exfdsp;
     int		retval;
+    int		ready;
+    int		maxFN = iC_maxFN;
+    int		bell = -1;
+    struct timeval	tv0;
+#ifndef	_WIN32
+    ShmRing *	ring = NULL;			/* ring with data from iCserver */
+#endif	/* _WIN32 */
 
+    /********************************************************************
+     *  A complete frame may already have been received with an earlier
+     *  frame - then only poll other inputs and report iC_sockFN ready
+     *******************************************************************/
+    if ((ready = iC_sockFN > 0 && FD_ISSET(iC_sockFN, infdsp) && frameReady(iC_sockFN)) != 0) {
+	tv0.tv_sec = tv0.tv_usec = 0;
+	ptv = &tv0;
+    }
+#ifndef	_WIN32
+    /********************************************************************
+     *  With the receive thread or shared memory wait for the doorbell
+     *  instead of iC_sockFN
+     *******************************************************************/
+    if (iC_sockFN > 0 && FD_ISSET(iC_sockFN, infdsp)) {
+	if (rcvQ) {
+	    ring = rcvQ;
+	    bell = rcvBell[0];
+	} else if (shmState == SHM_ON) {
+	    ring = &shm->dn;
+	    bell = shmDn;
+	}
+	if (bell > maxFN) {
+	    maxFN = bell;
+	}
+    }
+#endif	/* _WIN32 */
+  again:
+#ifndef	_WIN32
+    if (bell >= 0 && ! ready && shmArm(ring) != 0) {
+	ready = 1;				/* arrived without doorbell */
+	tv0.tv_sec = tv0.tv_usec = 0;
+	ptv = &tv0;
+    }
+#endif	/* _WIN32 */
     do {				/* repeat for caught signal */
 	iC_rdfds = *infdsp;
+	if (bell >= 0) {
+	    FD_CLR(iC_sockFN, &iC_rdfds);
+	    FD_SET(bell, &iC_rdfds);
+	}
 	if (ixfdsp) {
 	    exfdsp = &iC_exfds;
 	    iC_exfds = *ixfdsp;
 	} else {
 	    exfdsp = 0;
 	}
-    } while ((retval = select(iC_maxFN + 1, &iC_rdfds, 0, exfdsp, ptv)) == -1 && errno == EINTR);
+    } while ((retval = select(maxFN + 1, &iC_rdfds, 0, exfdsp, ptv)) == -1 && errno == EINTR);
 
     if (retval == -1) {
 #ifdef	_WIN32
@@ -354,100 +772,978 @@ iC_wait_for_next_event(fd_set * infdsp, fd_set * ixfdsp, struct timeval * ptv)
 #endif	/* _WIN32 */
 	iC_quit(SIGUSR1);
     }
+#ifndef	_WIN32
+    if (bell >= 0 && FD_ISSET(bell, &iC_rdfds)) {
+	FD_CLR(bell, &iC_rdfds);
+	if (shmDrain(bell) == 0 || shmAvail(ring) != 0) {
+	    FD_SET(iC_sockFN, &iC_rdfds);	/* data or iCserver has gone */
+	} else if (--retval == 0 && ! ready) {
+	    goto again;				/* late doorbell for data already read */
+	}
+    }
+#endif	/* _WIN32 */
+    /********************************************************************
+     *  Read what has arrived on iC_sockFN now. If it does not complete a
+     *  frame, wait again rather than block in recv() for the rest of it
+     *  while other inputs and timers are ready. A closed connection or
+     *  an error is left for the next nextFrame() to report.
+     *******************************************************************/
+    if (bell < 0 && ! ready && iC_sockFN > 0 && FD_ISSET(iC_sockFN, &iC_rdfds)) {
+	int	len;
+
+	if ((len = rcvSome(iC_sockFN)) > 0) {
+	    rcvBuf.tail += len;			/* as much as was available */
+	}
+	if ((len > 0 || (len < 0 && errno == EINTR)) && ! frameReady(iC_sockFN)) {
+	    FD_CLR(iC_sockFN, &iC_rdfds);	/* partial frame - not ready yet */
+	    if (--retval == 0) {
+		goto again;
+	    }
+	}
+    }
+    if (ready && ! FD_ISSET(iC_sockFN, &iC_rdfds)) {
+	FD_SET(iC_sockFN, &iC_rdfds);		/* received frame waiting */
+	retval++;
+    }
 
     return retval;
 } /* iC_wait_for_next_event */
 
 /********************************************************************
  *
- *	Receive known length buffer from server
+ *	Grow a frame buffer to hold at least need bytes
+ *
+ *******************************************************************/
+
+static void
+growBuffer(char ** bufp, int * sizep, int need)
+{
+    int		size = *sizep ? *sizep : FSIZ;
+
+    assert(need >= 0);
+    while (size < need) {
+	size = size <= INT_MAX / 2 ? size + size : need;	/* double size until big enough */
+    }
+    if (size != *sizep) {
+	*bufp = (char*)realloc(*bufp, size);	/* initially NULL */
+	assert(*bufp);
+	*sizep = size;
+    }
+} /* growBuffer */
+
+/********************************************************************
+ *
+ *	Length in the header of a frame
+ *	Returns -1 for a length which does not fit in a frame buffer
  *
  *******************************************************************/
 
 static int
-rcvd_buffer_from_server(SOCKET sock, char * buf, int length)
+frameLength(const char * hp)
 {
+    unsigned int	len;
+
+    len = (unsigned int)(unsigned char)hp[0] << 24 | (unsigned char)hp[1] << 16 |
+	  (unsigned char)hp[2] << 8  | (unsigned char)hp[3];
+    return len <= (unsigned int)(INT_MAX - HSIZ) ? (int)len : -1;
+} /* frameLength */
+
+/********************************************************************
+ *
+ *	Return 1 if a complete frame from sock has already been received
+ *	or if the header of the next frame has an illegal length, which
+ *	is reported by nextFrame()
+ *
+ *******************************************************************/
+
+static int
+frameReady(SOCKET sock)
+{
+    int		avail = rcvBuf.tail - rcvBuf.head;
     int		len;
 
-    if ((len = recv(sock, buf, length, 0)) > 0) {
-	if (len != length) {
-	    int i;
-	    fprintf(iC_errFP, "recv: length %d != expected length %d\n", len, length);
-	    for (i = 0; i < len; i++) {
-		fprintf(iC_errFP, " %02x", ((unsigned char*)&buf)[i]);
+#ifndef	_WIN32
+    if (rcvQ) return 0;				/* rcvBuf belongs to the receive thread */
+#endif	/* _WIN32 */
+    if (rcvBuf.sock != sock || avail < HSIZ) return 0;
+    len = frameLength(rcvBuf.buf + rcvBuf.head);
+    return len < 0 || avail - HSIZ >= len;
+} /* frameReady */
+
+/********************************************************************
+ *
+ *	Receive as much as is available from sock into rcvBuf
+ *
+ *	A partial frame is moved to the front of rcvBuf first, which
+ *	grows to hold all of it once the length in its header is known.
+ *	Returns the result of one recv() or shmRecv() call.
+ *
+ *******************************************************************/
+
+static int
+rcvSome(SOCKET sock)
+{
+    FrameBuffer *	rb = &rcvBuf;
+    int			avail;
+    int			need = FSIZ;
+
+    if (rb->sock != sock) {
+	rb->sock = sock;			/* new connection */
+	rb->head = rb->tail = 0;
+    }
+    if ((avail = rb->tail - rb->head) >= HSIZ) {
+	need = HSIZ + frameLength(rb->buf + rb->head);	/* partial frame of known length */
+    }
+    if (rb->head > 0) {
+	memmove(rb->buf, rb->buf + rb->head, avail);	/* partial frame to front */
+	rb->head = 0;
+	rb->tail = avail;
+    }
+    growBuffer(&rb->buf, &rb->size, need);
+#ifndef	_WIN32
+    if (shmState == SHM_ON) {
+	return shmRecv(rb->buf + rb->tail, rb->size - rb->tail);
+    }
+#endif	/* _WIN32 */
+    return recv(sock, rb->buf + rb->tail, rb->size - rb->tail, 0);
+} /* rcvSome */
+
+/********************************************************************
+ *
+ *	Get next complete frame from server
+ *
+ *	recv() is only called if no complete frame has been received.
+ *	Returns a pointer to the data of the frame in rcvBuf and its
+ *	length in *lenp. The data is valid until the next call.
+ *	Returns NULL if the server has closed the connection.
+ *
+ *	A frame of illegal length is fatal, like a failed recv().
+ *
+ *******************************************************************/
+
+static char *
+nextFrame(SOCKET sock, int * lenp)
+{
+    FrameBuffer *	rb = &rcvBuf;
+    int			avail;
+    int			len;
+    char *		fp;
+
+#ifndef	_WIN32
+    if (rcvQ && ! pthread_equal(pthread_self(), rcvThread)) {
+	return rcvFrame(lenp);			/* scan thread gets frames from rcvQ */
+    }
+#endif	/* _WIN32 */
+    if (rb->sock != sock) {
+	rb->sock = sock;			/* new connection */
+	rb->head = rb->tail = 0;
+    }
+    for (;;) {
+	if ((avail = rb->tail - rb->head) >= HSIZ) {
+	    if ((len = frameLength(rb->buf + rb->head)) < 0) {
+		fprintf(iC_errFP, "ERROR in %s: illegal message length from server\n", iC_iccNM);
+#ifndef	_WIN32
+		if (rcvQ) return NULL;		/* receive thread - scan thread quits */
+#endif	/* _WIN32 */
+		iC_quit(SIGUSR1);
+	    }
+	    if (avail - HSIZ >= len) {
+		fp = rb->buf + rb->head + HSIZ;	/* complete frame */
+		rb->head += HSIZ + len;
+		*lenp = len;
+#ifndef	_WIN32
+		if (shmState == SHM_ASKED) {
+		    shmAck(fp, lenp);		/* acknowledgment of last registration */
+		}
+#endif	/* _WIN32 */
+		return fp;
 	    }
 	}
-    } else if (len < 0) {
-	perror("recv failed");
-	iC_quit(SIGUSR1);
+	while ((len = rcvSome(sock)) < 0) {
+	    if (errno != EINTR) {
+		perror("recv failed");
+#ifndef	_WIN32
+		if (rcvQ) return NULL;		/* receive thread - scan thread quits */
+#endif	/* _WIN32 */
+		iC_quit(SIGUSR1);
+	    }
+	}
+	if (len == 0) {
+	    return NULL;			/* connection closed by server */
+	}
+	rb->tail += len;			/* as much as was available */
     }
-    return len;
-} /* rcvd_buffer_from_server */
+} /* nextFrame */
 
+#if YYDEBUG && !defined(_WINDOWS)
 /********************************************************************
  *
- *	Receive message from server
+ *	Trace received frame
+ *
+ *******************************************************************/
+
+static void
+traceFrame(const char * buf, int len)
+{
+    if (len == 0) {
+	fprintf(iC_outFP, "%s < received zero length message\n", iC_iccNM);
+    } else if (*buf == BIN_FRAME) {
+	fprintf(iC_outFP, "%s < [%d byte binary frame]\n", iC_iccNM, len);	/* trace recv frame */
+    } else {
+	fprintf(iC_outFP, "%s < '%s'\n", iC_iccNM, buf);	/* trace recv buffer */
+    }
+    fflush(iC_outFP);
+} /* traceFrame */
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+
+/********************************************************************
+ *
+ *	Receive message from server into buf of size maxLen
+ *	(longer messages are truncated)
  *
  *******************************************************************/
 
 int
 iC_rcvd_msg_from_server(SOCKET sock, char * buf, int maxLen)
 {
-    NetBuffer	netBuf;
-    int		len;
+    const char *	fp;
+    int			len = 0;
 
-    if ((len = rcvd_buffer_from_server(sock, (char*)&netBuf.length, sizeof netBuf.length))
-	    == sizeof netBuf.length) {		/* get 4 bytes of length to start with */
-	len = ntohl(netBuf.length);		/* length in host byte order */
-	if (len >= maxLen) {
-	    fprintf(iC_errFP, "ERROR in %s: received message is too long: %d >= %d\n", iC_iccNM, len, maxLen);
-	    len = maxLen - 1;
-	}
-	maxLen = len;
-	if ((len = rcvd_buffer_from_server(sock, netBuf.buffer, maxLen)) == maxLen) {
-	    memcpy(buf, netBuf.buffer, len);
-	    buf[len] = '\0';
+    if ((fp = nextFrame(sock, &len)) == NULL) {
+	fp = "";				/* closed - same as zero length message */
+	len = 0;
+    } else if (len >= maxLen) {
+	fprintf(iC_errFP, "ERROR in %s: received message is too long: %d >= %d\n", iC_iccNM, len, maxLen);
+	len = maxLen - 1;
+    }
+    memcpy(buf, fp, len);
+    buf[len] = '\0';
 #if YYDEBUG && !defined(_WINDOWS)
-	    if (iC_debug & 02) {
-		fprintf(iC_outFP, "%s < '%s'\n", iC_iccNM, buf);	/* trace recv buffer */
-		fflush(iC_outFP);
-	    }
+    if (iC_debug & 02) traceFrame(buf, len);
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
+    return len;
+} /* iC_rcvd_msg_from_server */
+
+/********************************************************************
+ *
+ *	Receive message of any size from server
+ *	*bufp of size *sizep (initially NULL and 0) grows as required
+ *
+ *******************************************************************/
+
+int
+iC_rcvd_frame_from_server(SOCKET sock, char ** bufp, int * sizep)
+{
+    const char *	fp;
+    int			len = 0;
+
+    if ((fp = nextFrame(sock, &len)) == NULL) {
+	fp = "";				/* closed - same as zero length message */
+	len = 0;
+    }
+    growBuffer(bufp, sizep, len + 1);
+    memcpy(*bufp, fp, len);
+    (*bufp)[len] = '\0';
+#if YYDEBUG && !defined(_WINDOWS)
+    if (iC_debug & 02) traceFrame(*bufp, len);
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+    return len;
+} /* iC_rcvd_frame_from_server */
+
+/********************************************************************
+ *
+ *	Write the big endian length header of a frame of len bytes
+ *
+ *******************************************************************/
+
+static void
+putHeader(char * bp, int len)
+{
+    bp[0] = len >> 24;
+    bp[1] = len >> 16;
+    bp[2] = len >> 8;
+    bp[3] = len;
+} /* putHeader */
+
+/********************************************************************
+ *
+ *	Send headers and frames to iCserver in one write
+ *
+ *******************************************************************/
+
+static void
+sendBytes(SOCKET sock, const char * buf, int len)
+{
+#ifndef	_WIN32
+    if (shmState == SHM_ON) {
+	shmSend(buf, len);			/* via shared memory */
+    } else
+#endif	/* _WIN32 */
+    if (send(sock, buf, len, 0) != len) {	/* header and frame in one write */
+	perror("send failed");
+	iC_quit(SIGUSR1);
+    }
+} /* sendBytes */
+#ifndef	_WIN32
+
+/********************************************************************
+ *
+ *	Queue headers and frames for the sender thread
+ *	Wait if sndQ is full until the sender thread has made room
+ *
+ *******************************************************************/
+
+static void
+sndQueue(const char * buf, int len)
+{
+    unsigned int	depth;
+    int			n;
+
+    sndStat.frames++;
+    for (;;) {
+	n = shmWrite(sndQ, buf, len);
+	shmWake(sndQ, sndBell[1]);
+	if ((depth = sndQ->head - __atomic_load_n(&sndQ->tail, __ATOMIC_ACQUIRE)) > sndStat.maxDepth) {
+	    sndStat.maxDepth = depth;
+	}
+	if ((len -= n) == 0) break;
+	buf += n;
+	sndStat.waits++;
+	nanosleep(&ms1, NULL);			/* backpressure - iCserver is slow */
+    }
+} /* sndQueue */
+
+/********************************************************************
+ *
+ *	Bytes which can be queued in sndQ without waiting
+ *
+ *******************************************************************/
+
+static int
+sndRoom(void)
+{
+    return SHM_RING - (sndQ->head - __atomic_load_n(&sndQ->tail, __ATOMIC_ACQUIRE));
+} /* sndRoom */
+
+/********************************************************************
+ *
+ *	Collect one channel value in coal[]
+ *
+ *******************************************************************/
+
+static void
+coalPut(unsigned short channel, long val)
+{
+    int		i;
+
+    if (channel >= coalTop) {
+	i = coalTop;
+	coalTop = channel + 64;
+	coalIdx = (int*)realloc(coalIdx, coalTop * sizeof(int));	/* initially NULL */
+	assert(coalIdx);
+	memset(coalIdx + i, 0, (coalTop - i) * sizeof(int));
+    }
+    if ((i = coalIdx[channel]) != 0) {
+	coal[i - 1].val = val;			/* replace earlier value */
+	sndStat.merged++;
+    } else {
+	if (coalN >= coalSize) {
+	    coalSize += 64;
+	    coal = (Coal*)realloc(coal, coalSize * sizeof(Coal));	/* initially NULL */
+	    assert(coal);
+	}
+	coal[coalN].channel = channel;
+	coal[coalN].val = val;
+	coalIdx[channel] = ++coalN;
+    }
+    sndStat.values++;
+} /* coalPut */
+
+/********************************************************************
+ *
+ *	Collect the values of an ASCII or binary output data frame
+ *	ASCII frames consist of channel:value items separated by ','
+ *
+ *******************************************************************/
+
+static void
+coalFrame(const char * buf, int len)
+{
+    const char *	ep = buf + len;
+    unsigned short	channel;
+    long		val;
+    int			neg;
+
+    if (*buf == BIN_FRAME) {
+	coalBin = 1;
+	for (buf++; buf < ep; ) {
+	    buf = iC_get_record(buf, ep, &channel, &val);
+	    assert(buf);			/* sendOutput() only sends complete records */
+	    coalPut(channel, val);
+	}
+    } else {
+	while (buf < ep) {
+	    for (channel = 0; buf < ep && isdigit(*buf); buf++) {
+		channel = channel * 10 + *buf - '0';
+	    }
+	    assert(buf < ep && *buf == ':');	/* channel:value */
+	    if ((neg = *++buf == '-') != 0) buf++;
+	    for (val = 0; buf < ep && isdigit(*buf); buf++) {
+		val = val * 10 + *buf - '0';
+	    }
+	    coalPut(channel, neg ? -val : val);
+	    if (buf < ep && *buf == ',') buf++;
 	}
+    }
+} /* coalFrame */
+
+/********************************************************************
+ *
+ *	Build frames with headers from the values collected in coal[]
+ *	in *bufp of size *sizep (initially NULL and 0) and empty coal[]
+ *	Called with coalLock held - returns the bytes in *bufp
+ *
+ *******************************************************************/
+
+static int
+coalBuild(char ** bufp, int * sizep)
+{
+    int		lim = (coalBin ? FRAME : REQUEST) - BSIZ - 12;	/* room for 1 more item */
+    int		len = 0;			/* bytes in *bufp */
+    int		h = -1;				/* header of the frame being built */
+    int		i;
+
+    for (i = 0; i < coalN; i++) {
+	growBuffer(bufp, sizep, len + HSIZ + BSIZ + 12);
+	if (h < 0 || len - h - HSIZ > lim) {
+	    if (h >= 0) putHeader(*bufp + h, len - h - HSIZ);
+	    h = len;				/* start a new frame */
+	    len += HSIZ;
+	    if (coalBin) (*bufp)[len++] = BIN_FRAME;
+	} else if (! coalBin) {
+	    (*bufp)[len++] = ',';
+	}
+	if (coalBin) {
+	    len = iC_put_record(*bufp + len, coal[i].channel, coal[i].val) - *bufp;
+	} else {
+	    len += sprintf(*bufp + len, "%hu:%ld", coal[i].channel, coal[i].val);
+	}
+	coalIdx[coal[i].channel] = 0;
+    }
+    if (h >= 0) putHeader(*bufp + h, len - h - HSIZ);
 #if YYDEBUG && !defined(_WINDOWS)
-    } else if (iC_debug & 02) {
-	fprintf(iC_outFP, "%s < received zero length message\n", iC_iccNM);
+    if (iC_debug & 01) {
+	fprintf(iC_outFP, "%s > [%d collected values]\n", iC_iccNM, coalN);
 	fflush(iC_outFP);
-#endif	/* YYDEBUG && !defined(_WINDOWS) */
     }
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+    coalN = 0;
     return len;
-} /* iC_rcvd_msg_from_server */
+} /* coalBuild */
+
+/********************************************************************
+ *
+ *	Sender thread - send whatever is queued in sndQ to iCserver,
+ *	then the values collected in coal[]
+ *	Stop when both are empty after the scan thread has set sndStop
+ *
+ *******************************************************************/
+
+static void *
+sendThread(void * arg)
+{
+    static char		buf[SHM_RING];
+    static char *	cbuf = NULL;	/* collected values - initially NULL */
+    static int		csize = 0;
+    struct pollfd	pfd;
+    int			stop;
+    int			n;
+
+    (void)arg;				/* unused */
+    pfd.fd = sndBell[0];
+    pfd.events = POLLIN;
+    for (;;) {
+	stop = __atomic_load_n(&sndStop, __ATOMIC_ACQUIRE);	/* before last frames are read */
+	if ((n = shmRead(sndQ, buf, SHM_RING)) > 0) {
+	    sendBytes(sndSock, buf, n);		/* as many frames as are queued */
+	    continue;
+	}
+	pthread_mutex_lock(&coalLock);
+	n = coalN ? coalBuild(&cbuf, &csize) : 0;	/* values collected while sndQ was full */
+	pthread_mutex_unlock(&coalLock);
+	if (n > 0) {
+	    sendBytes(sndSock, cbuf, n);
+	} else if (stop) {
+	    break;
+	} else if (shmArm(sndQ) == 0) {
+	    while (poll(&pfd, 1, -1) < 0 && errno == EINTR);
+	    shmDrain(sndBell[0]);
+	}
+    }
+    return NULL;
+} /* sendThread */
+
+/********************************************************************
+ *
+ *	Start the sender thread after registration is complete
+ *	All following messages to iCserver are queued for it
+ *
+ *******************************************************************/
+
+void
+iC_start_sender(SOCKET sock)
+{
+    sigset_t	all;
+    sigset_t	old;
+    int		i;
+
+    if (sndQ) return;				/* already running */
+    sndQ = (ShmRing*)calloc(1, sizeof(ShmRing));
+    assert(sndQ);
+    if (pipe(sndBell) < 0) {
+	perror("sender doorbell");
+	iC_quit(SIGUSR1);
+    }
+    for (i = 0; i < 2; i++) {
+	fcntl(sndBell[i], F_SETFL, O_NONBLOCK);	/* shmDrain() and shmWake() do not block */
+	fcntl(sndBell[i], F_SETFD, FD_CLOEXEC);
+    }
+    sndSock = sock;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);	/* signals are handled by the scan thread */
+    errno = pthread_create(&sndThread, NULL, sendThread, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (errno) {
+	perror("sender thread");
+	iC_quit(SIGUSR1);
+    }
+#if YYDEBUG && !defined(_WINDOWS)
+    if (iC_debug & 04) fprintf(iC_outFP, "%s: sender thread started\n", iC_iccNM);
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+} /* iC_start_sender */
+
+/********************************************************************
+ *
+ *	Stop the sender thread when it has sent everything queued and
+ *	collected. Following messages are sent directly.
+ *	Report backpressure if the scan thread had to wait or values
+ *	were collected.
+ *
+ *******************************************************************/
+
+void
+iC_stop_sender(void)
+{
+    if (sndQ == NULL || pthread_equal(pthread_self(), sndThread)) {
+	return;					/* iC_quit() after send failed in sender thread */
+    }
+    __atomic_store_n(&sndStop, 1, __ATOMIC_RELEASE);
+    while (write(sndBell[1], "", 1) < 0 && errno == EINTR);
+    pthread_join(sndThread, NULL);
+    close(sndBell[0]);
+    close(sndBell[1]);
+    free(sndQ);
+    sndQ = NULL;
+    if ((iC_debug & 04) || ((sndStat.waits || sndStat.values) && (iC_debug & DQ) == 0)) {
+	fprintf(iC_errFP, "%s: sender thread: %lu frames, max %u bytes queued, %lu waits,"
+	    " %lu values collected, %lu replaced\n", iC_iccNM, sndStat.frames,
+	    sndStat.maxDepth, sndStat.waits, sndStat.values, sndStat.merged);
+    }
+} /* iC_stop_sender */
+
+/********************************************************************
+ *
+ *	Receive thread: queue an entry or part of it in rcvQ
+ *	Wait if rcvQ is full until the scan thread has taken some of it
+ *
+ *******************************************************************/
+
+static void
+rcvQueue(const char * buf, int len)
+{
+    int		n;
+
+    for (;;) {
+	n = shmWrite(rcvQ, buf, len);
+	shmWake(rcvQ, rcvBell[1]);
+	if ((len -= n) == 0) break;
+	buf += n;
+	nanosleep(&ms1, NULL);			/* scan thread is busy */
+    }
+} /* rcvQueue */
+
+/********************************************************************
+ *
+ *	Receive thread: parse a frame which contains only channel:value
+ *	items into *valp of size *sizep (initially NULL and 0)
+ *	Return the number of values or 0 if the frame must be queued
+ *	unchanged for the scan thread.
+ *
+ *******************************************************************/
+
+static int
+rcvParse(const char * bp, int len, ChannelValue ** valp, int * sizep)
+{
+    const char *	ep = bp + len;
+    unsigned short	channel;
+    long		val;
+    int			bin = len && *bp == BIN_FRAME;
+    int			n = 0;
+    int			d;
+    int			neg;
+
+    if (bin) bp++;
+    while (bp < ep) {
+	if (n >= *sizep) {
+	    *sizep += 64;
+	    *valp = (ChannelValue*)realloc(*valp, *sizep * sizeof(ChannelValue));	/* initially NULL */
+	    assert(*valp);
+	}
+	if (bin) {
+	    if ((bp = iC_get_record(bp, ep, &channel, &val)) == NULL) {
+		return 0;			/* truncated binary frame */
+	    }
+	} else {
+	    if (n && *bp++ != ',') return 0;	/* separator before all but the first item */
+	    for (channel = 0, d = 0; bp < ep && isdigit(*bp) && d < 5; bp++, d++) {
+		channel = channel * 10 + *bp - '0';
+	    }
+	    if (d == 0 || bp >= ep || *bp++ != ':') return 0;
+	    if ((neg = bp < ep && *bp == '-') != 0) bp++;
+	    for (val = 0, d = 0; bp < ep && isdigit(*bp) && d < 10; bp++, d++) {
+		val = val * 10 + *bp - '0';
+	    }
+	    if (d == 0 || (bp < ep && *bp != ',')) return 0;
+	    if (neg) val = -val;
+	}
+	if (channel == rcvRaw) return 0;	/* Debug messages are handled as text */
+	(*valp)[n].channel = channel;
+	(*valp)[n].val = val;
+	n++;
+    }
+    return n;
+} /* rcvParse */
+
+/********************************************************************
+ *
+ *	Receive thread - read frames from iCserver and queue them in rcvQ
+ *	Stops after queueing a zero length frame when iCserver has closed
+ *	the connection. Otherwise it ends with the process.
+ *
+ *******************************************************************/
+
+static void *
+recvThread(void * arg)
+{
+    static ChannelValue *	val = NULL;	/* initially NULL */
+    static int		size = 0;
+    char		hdr[1 + HSIZ];
+    char *		fp;
+    int			len = 0;
+    int			n;
+
+    (void)arg;				/* unused */
+    do {
+	if ((fp = nextFrame(rcvSock, &len)) == NULL) {
+	    len = 0;				/* closed - same as zero length message */
+	}
+	if (len && (n = rcvParse(fp, len, &val, &size)) > 0) {
+	    hdr[0] = RCV_VALUES;
+	    putHeader(hdr + 1, n * sizeof(ChannelValue));
+	    rcvQueue(hdr, sizeof hdr);
+	    rcvQueue((char*)val, n * sizeof(ChannelValue));
+	} else {
+	    hdr[0] = RCV_FRAME;
+	    putHeader(hdr + 1, len);
+	    rcvQueue(hdr, sizeof hdr);
+	    if (len) rcvQueue(fp, len);
+	}
+    } while (len);
+    return NULL;
+} /* recvThread */
+
+/********************************************************************
+ *
+ *	Scan thread: take len bytes of an entry from rcvQ
+ *	Wait on the doorbell if the receive thread has not queued them yet
+ *
+ *******************************************************************/
+
+static void
+rcvTake(char * buf, int len)
+{
+    struct pollfd	pfd;
+    int			n;
+
+    pfd.fd = rcvBell[0];
+    pfd.events = POLLIN;
+    while (len > 0) {
+	if ((n = shmRead(rcvQ, buf, len)) > 0) {
+	    buf += n;
+	    len -= n;
+	} else if (shmArm(rcvQ) == 0) {
+	    while (poll(&pfd, 1, -1) < 0 && errno == EINTR);
+	    shmDrain(rcvBell[0]);
+	}
+    }
+} /* rcvTake */
+
+/********************************************************************
+ *
+ *	Scan thread: get the next entry from rcvQ as a frame
+ *	Values are converted to an ASCII frame
+ *
+ *******************************************************************/
+
+static char *
+rcvFrame(int * lenp)
+{
+    char		hdr[1 + HSIZ];
+    ChannelValue	cv;
+    int			len;
+    int			n;
+
+    rcvTake(hdr, sizeof hdr);
+    len = frameLength(hdr + 1);
+    if (hdr[0] == RCV_FRAME) {
+	growBuffer(&rcvEntry, &rcvEntrySize, len);
+	rcvTake(rcvEntry, len);
+	*lenp = len;
+    } else {
+	assert(hdr[0] == RCV_VALUES);
+	for (*lenp = 0; len > 0; len -= sizeof cv) {
+	    rcvTake((char*)&cv, sizeof cv);
+	    growBuffer(&rcvEntry, &rcvEntrySize, *lenp + 32);	/* ",65535:" and a 64 bit value */
+	    n = snprintf(rcvEntry + *lenp, 32, "%s%hu:%ld", *lenp ? "," : "", cv.channel, cv.val);
+	    *lenp += n;
+	}
+    }
+    return rcvEntry;
+} /* rcvFrame */
+
+/********************************************************************
+ *
+ *	Start the receive thread after registration is complete
+ *	Frames for rawChannel are not parsed
+ *
+ *******************************************************************/
+
+void
+iC_start_receiver(SOCKET sock, unsigned short rawChannel)
+{
+    sigset_t	all;
+    sigset_t	old;
+    int		i;
+
+    if (rcvQ) return;				/* already running */
+    rcvQ = (ShmRing*)calloc(1, sizeof(ShmRing));
+    assert(rcvQ);
+    if (pipe(rcvBell) < 0) {
+	perror("receiver doorbell");
+	iC_quit(SIGUSR1);
+    }
+    for (i = 0; i < 2; i++) {
+	fcntl(rcvBell[i], F_SETFL, O_NONBLOCK);	/* shmDrain() and shmWake() do not block */
+	fcntl(rcvBell[i], F_SETFD, FD_CLOEXEC);
+    }
+    rcvSock = sock;
+    rcvRaw = rawChannel;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);	/* signals are handled by the scan thread */
+    errno = pthread_create(&rcvThread, NULL, recvThread, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (errno) {
+	perror("receive thread");
+	iC_quit(SIGUSR1);
+    }
+#if YYDEBUG && !defined(_WINDOWS)
+    if (iC_debug & 04) fprintf(iC_outFP, "%s: receive thread started\n", iC_iccNM);
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+} /* iC_start_receiver */
+
+/********************************************************************
+ *
+ *	Scan thread: take all values which the receive thread has queued
+ *	one after the other in *valp of size *sizep (initially NULL and 0)
+ *	Return the number of values - 0 if the next entry is a frame, which
+ *	is then got with iC_rcvd_frame_from_server(), or without -r.
+ *
+ *******************************************************************/
+
+int
+iC_rcvd_values_from_server(ChannelValue ** valp, int * sizep)
+{
+    char	hdr[1 + HSIZ];
+    int		n = 0;
+    int		len;
+
+    while (rcvQ && shmAvail(rcvQ) > 0 && rcvQ->data[rcvQ->tail & (SHM_RING - 1)] == RCV_VALUES) {
+	rcvTake(hdr, sizeof hdr);
+	len = frameLength(hdr + 1) / sizeof(ChannelValue);
+	if (n + len > *sizep) {
+	    *sizep = n + len + 64;
+	    *valp = (ChannelValue*)realloc(*valp, *sizep * sizeof(ChannelValue));	/* initially NULL */
+	    assert(*valp);
+	}
+	rcvTake((char*)(*valp + n), len * sizeof(ChannelValue));
+	n += len;
+    }
+#if YYDEBUG && !defined(_WINDOWS)
+    if (n && (iC_debug & 02)) {
+	fprintf(iC_outFP, "%s < [%d channel values]\n", iC_iccNM, n);
+	fflush(iC_outFP);
+    }
+#endif	/* YYDEBUG && !defined(_WINDOWS) */
+    return n;
+} /* iC_rcvd_values_from_server */
+#endif	/* _WIN32 */
 
 /********************************************************************
  *
  *	Send message to server
- *	(handles short messages only)
  *
  *******************************************************************/
 
 void
 iC_send_msg_to_server(SOCKET sock, const char * msg)
 {
-    NetBuffer	netBuf;
-    size_t	len = strlen(msg);
+    iC_send_buf_to_server(sock, msg, strlen(msg));
+} /* iC_send_msg_to_server */
+
+/********************************************************************
+ *
+ *	Send buffer of known length and any size to server
+ *	(a binary frame may contain '\0' characters)
+ *
+ *******************************************************************/
+
+void
+iC_send_buf_to_server(SOCKET sock, const char * buf, int len)
+{
+#ifndef	_WIN32
+    int		n;
 
-    assert(len < sizeof netBuf.buffer);		/* check when sending - should not trunctate message */
+#endif	/* _WIN32 */
 #if YYDEBUG && !defined(_WINDOWS)
     if (iC_debug & 01) {
-	fprintf(iC_outFP, "%s > '%s'\n", iC_iccNM, msg);	/* trace send buffer */
+	if (*buf == BIN_FRAME) {
+	    fprintf(iC_outFP, "%s > [%d byte binary frame]\n", iC_iccNM, len);	/* trace send frame */
+	} else {
+	    fprintf(iC_outFP, "%s > '%.*s'\n", iC_iccNM, len, buf);	/* trace send buffer */
+	}
 	fflush(iC_outFP);
     }
 #endif	/* YYDEBUG && !defined(_WINDOWS) */
-    netBuf.length = htonl(len);
-    memcpy(netBuf.buffer, msg, len + 1);
-    len += sizeof netBuf.length;
-    if (send(sock, (char*)&netBuf, len, 0) != len) {
-	perror("send failed");
-	iC_quit(SIGUSR1);
+    growBuffer(&sndBuf, &sndSize, HSIZ + len);	/* at least FSIZ */
+    memcpy(sndBuf + HSIZ, buf, len);
+#ifndef	_WIN32
+    if (shmState == SHM_LOCAL && len >= 2 && buf[len - 2] == ',' && buf[len - 1] == 'Z' &&
+	len + 2 + (int)strlen(shmName) <= REQUEST && shmCreate()) {
+	len += sprintf(sndBuf + HSIZ + len - 2, ",M%s,Z", shmName) - 2;	/* offer shared memory - fits in FSIZ */
+	shmState = SHM_ASKED;
     }
-} /* iC_send_msg_to_server */
+#endif	/* _WIN32 */
+    putHeader(sndBuf, len);			/* big endian length header */
+    len += HSIZ;
+#ifndef	_WIN32
+    if (sndQ && ! pthread_equal(pthread_self(), sndThread)) {
+	pthread_mutex_lock(&coalLock);
+	n = coalN ? coalBuild(&coalBuf, &coalBufSize) : 0;
+	pthread_mutex_unlock(&coalLock);
+	if (n > 0) {
+	    sndQueue(coalBuf, n);		/* collected values first */
+	}
+	sndQueue(sndBuf, len);			/* sent by sender thread */
+	return;
+    }
+#endif	/* _WIN32 */
+    sendBytes(sock, sndBuf, len);
+} /* iC_send_buf_to_server */
+
+/********************************************************************
+ *
+ *	Send output data of channels to server. With the sender thread
+ *	the values are collected per channel while sndQ has no room.
+ *
+ *******************************************************************/
+
+void
+iC_send_data_to_server(SOCKET sock, const char * buf, int len)
+{
+#ifndef	_WIN32
+    int		full;
+
+    if (sndQ) {
+	pthread_mutex_lock(&coalLock);
+	if ((full = coalN || sndRoom() < HSIZ + len) != 0) {
+	    coalFrame(buf, len);		/* iCserver is slow */
+	}
+	pthread_mutex_unlock(&coalLock);
+	if (full) return;
+    }
+#endif	/* _WIN32 */
+    iC_send_buf_to_server(sock, buf, len);
+} /* iC_send_data_to_server */
+
+/********************************************************************
+ *
+ *	Binary channel data records
+ *
+ *	A binary frame starts with BIN_FRAME (SOH), which never starts an
+ *	ASCII message. It is followed by records without separators, each
+ *	a 2 byte big endian channel followed by the zig-zag encoded value
+ *	as a BER compressed integer - base 128, most significant 7 bits
+ *	first, bit 7 set in all but the last byte (Perl pack "nw").
+ *	Values in the range -64 to 63 need 1 byte, 32 bit values 5 bytes.
+ *
+ *	iC_put_record() places one record at bp and returns the next
+ *	free position. At most BSIZ bytes are used.
+ *
+ *	iC_get_record() decodes one record at bp and returns the start
+ *	of the next record, or NULL if the record is truncated at ep.
+ *
+ *******************************************************************/
+
+char *
+iC_put_record(char * bp, unsigned short channel, long val)
+{
+    unsigned long	u;
+    unsigned char	b[BSIZ];
+    int			n = 0;
+
+    u = (unsigned long)val << 1;
+    if (val < 0) u = ~u;			/* zig-zag: small negative values are short */
+    *bp++ = channel >> 8;
+    *bp++ = channel;
+    do {
+	b[n++] = u & 0x7f;
+	u >>= 7;
+    } while (u);
+    while (--n > 0) {
+	*bp++ = b[n] | 0x80;			/* more bytes follow */
+    }
+    *bp++ = b[0];				/* last byte */
+    return bp;
+} /* iC_put_record */
+
+const char *
+iC_get_record(const char * bp, const char * ep, unsigned short * channelp, long * valp)
+{
+    unsigned long	u = 0;
+    unsigned char	c;
+
+    if (ep - bp < 3) {
+	return NULL;				/* shortest record is 3 bytes */
+    }
+    *channelp = (unsigned char)bp[0] << 8 | (unsigned char)bp[1];
+    bp += 2;
+    do {
+	if (bp >= ep) {
+	    return NULL;			/* truncated value */
+	}
+	c = *bp++;
+	u = u << 7 | (c & 0x7f);
+    } while (c & 0x80);
+    *valp = (u & 1) ? ~(long)(u >> 1) : (long)(u >> 1);
+    return bp;
+} /* iC_get_record */
@@ -53,10 +53,21 @@ static const char tcpc_h[] =
 
 #define REQUEST	1400-4			/* max size of request, in bytes - leave room for 4 byte length header */
 #define REPLY	1400-4			/* max size of reply, in bytes - leave room for 4 byte length header */
+#define FRAME	16384-4			/* max size of request after iCserver acknowledged B (any size received) */
+
+#define BIN_FRAME	'\001'		/* SOH starts a binary frame of channel:value records */
+#define BSIZ		12		/* max size of 1 binary record: 2 byte channel + 10 byte value */
 
 #define LOCALHOST	"localhost"
 #define LOCALHOST1	"127.0.0.1"
 #define iC_PORT		"8778"
+#define UNIX_PREFIX	"unix:"		/* -s unix:<path> selects a Unix domain socket */
+#define IS_UNIX(h)	(strncmp((h), UNIX_PREFIX, sizeof(UNIX_PREFIX) - 1) == 0)
+
+typedef struct ChannelValue {		/* input parsed by the receive thread (-r) */
+    unsigned short	channel;
+    long		val;
+} ChannelValue;
 
     /* Following shortens all the type casts of pointer arguments */
 #define SA		struct sockaddr *
@@ -74,7 +85,18 @@ extern SOCKET		iC_sockFN;	/* TCP/IP socket file number */
 extern SOCKET		iC_connect_to_server(const char* host, const char* port);
 extern int		iC_wait_for_next_event(fd_set * infdsp, fd_set * ixfdsp, struct timeval * ptv);
 extern int		iC_rcvd_msg_from_server(SOCKET sock, char* buf, int maxLen);
+extern int		iC_rcvd_frame_from_server(SOCKET sock, char** bufp, int* sizep);
 extern void		iC_send_msg_to_server(SOCKET sock, const char* msg);
+extern void		iC_send_buf_to_server(SOCKET sock, const char* buf, int len);
+extern void		iC_send_data_to_server(SOCKET sock, const char* buf, int len);
+#ifndef	_WIN32
+extern void		iC_start_sender(SOCKET sock);
+extern void		iC_stop_sender(void);
+extern void		iC_start_receiver(SOCKET sock, unsigned short rawChannel);
+extern int		iC_rcvd_values_from_server(ChannelValue** valp, int* sizep);
+#endif	/* _WIN32 */
+extern char *		iC_put_record(char* bp, unsigned short channel, long val);
+extern const char *	iC_get_record(const char* bp, const char* ep, unsigned short* channelp, long* valp);
 
 extern int		iC_Xflag;	/* 1 if this process started iCserver */
 extern char *		iC_vcd;
@@ -66,11 +66,26 @@ func (m *lengthError) Error() string {
 }
 
 func Write(conn net.Conn, wbufP *[]byte) (error) {
+    if err := Frame(wbufP); err != nil {
+	return err
+    }
+    _, err := conn.Write(*wbufP)
+    return err
+}
+
+/********************************************************************
+ *
+ *  Fill in the 4 byte length of a message in Write buffer pointed to
+ *  by wbufP without writing it. Used to queue several messages for
+ *  one conn.Write()
+ *
+ *******************************************************************/
+
+func Frame(wbufP *[]byte) (error) {
     length := len(*wbufP)
     if length > REPLY+4 {
 	return &lengthError{};
     }
     binary.BigEndian.PutUint32((*wbufP)[:4], uint32(length-4))
-    _, err := conn.Write(*wbufP)
-    return err
+    return nil
 }